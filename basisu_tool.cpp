@@ -51,7 +51,6 @@ enum tool_mode
 	cUnpack,
 	cCompare,
 	cVersion,
-	cBench,
 	cCompSize
 };
 
@@ -80,6 +79,9 @@ static void print_usage()
 		" -ktx2_animdata_duration X: Set KTX2animData duration field to integer value X (only valid/useful for -tex_type video, default is 1)\n"
 		" -ktx2_animdata_timescale X: Set KTX2animData timescale field to integer value X (only valid/useful for -tex_type video, default is 15)\n"
 		" -ktx2_animdata_loopcount X: Set KTX2animData loopcount field to integer value X (only valid/useful for -tex_type video, default is 0)\n"
+		" -uastc_stream: Encode a single large UASTC .KTX2 image in strips, writing each strip to the output file as it's finished to bound memory use. Requires -uastc and -ktx2,\n"
+		"  doesn't support mipmaps, -stats, -debug_images or UASTC RDO rate control. RDO (if enabled) is applied to each strip independently.\n"
+		" -uastc_stream_strip X: Set the height of each -uastc_stream strip to X texels (default is 256)\n"
 		" -file filename.png/bmp/tga/jpg: Input image filename, multiple images are OK, use -file X for each input filename (prefixing input filenames with -file is optional)\n"
 		" -alpha_file filename.png/bmp/tga/jpg: Input alpha image filename, multiple images are OK, use -file X for each input filename (must be paired with -file), images converted to REC709 grayscale and used as input alpha\n"
 		" -multifile_printf: printf() format strint to use to compose multiple filenames\n"
@@ -92,10 +94,14 @@ static void print_usage()
 		" -debug: Enable codec debug print to stdout (slightly slower).\n"
 		" -debug_images: Enable codec debug images (much slower).\n"
 		" -stats: Compute and display image quality metrics (slightly slower).\n"
+		" -trace X: Write a Chrome trace event JSON file X (view with chrome://tracing or Perfetto). Requires a build with BASISU_ENABLE_TRACING=1 (cmake -DTRACE=TRUE)\n"
+		" -perf_json X: Write per-phase timings (wall/CPU/job time), thread utilization, peak memory and cluster counts for each compressed file to JSON file X\n"
 		" -tex_type <2d, 2darray, 3d, video, cubemap>: Set Basis file header's texture type field. Cubemap arrays require multiples of 6 images, in X+, X-, Y+, Y-, Z+, Z- order, each image must be the same resolutions.\n"
 		"  2d=arbitrary 2D images, 2darray=2D array, 3D=volume texture slices, video=video frames, cubemap=array of faces. For 2darray/3d/cubemaps/video, each source image's dimensions and # of mipmap levels must be the same.\n"
 		" For video, the .basis file will be written with the first frame being an I-Frame, and subsequent frames being P-Frames (using conditional replenishment). Playback must always occur in order from first to last image.\n"
 		" -framerate X: Set framerate in .basis header to X/frames sec.\n"
+		" -video_iframe_interval X: For -tex_type video, code every Xth frame as an I-Frame (which doesn't reference the previous frame), so transcoders can seek to the closest prior I-Frame instead of decoding from the first frame. Default is 0 (only the first frame).\n"
+		" -video_gop X: Split a -tex_type video sequence into groups of X frames, each written to its own independently decodable file (with \"_gopXXXX\" appended to the output filename) and compressed in parallel. Each group starts with an I-Frame, so playback can start at any group. Can't be used with -csv_file.\n"
 		" -individual: Process input images individually and output multiple .basis files (not as a texture array)\n"
 		" -comp_level X: Set ETC1S encoding speed vs. quality tradeoff. Range is 0-6, default is 1. Higher values=MUCH slower, but slightly higher quality. Higher levels intended for videos. Use -q first!\n"
 		" -fuzz_testing: Use with -validate: Disables CRC16 validation of file contents before transcoding\n"
@@ -110,6 +116,9 @@ static void print_usage()
 		" -uastc_rdo_s X: Set UASTC RDO max smooth block standard deviation. Range is [.01,65536]. Default is 18.0. Larger values expand the range of blocks considered smooth.\n"
 		" -uastc_rdo_f: Don't favor simpler UASTC modes in RDO mode.\n"
 		" -uastc_rdo_m: Disable RDO multithreading (slightly higher compression, deterministic).\n"
+		" -uastc_rdo_bitrate X: Enable UASTC RDO and search for the lambda which gets the LZ compressed output to X bits per texel (Zstd if writing Zstd supercompressed .KTX2, otherwise Deflate).\n"
+		" -uastc_rdo_size X: Same as -uastc_rdo_bitrate, but targets an LZ compressed size of X bytes for all the UASTC data.\n"
+		" -uastc_rdo_zstd: Estimate UASTC RDO match costs for Zstd (favoring matches at recently used offsets) instead of Deflate. Useful with Zstd supercompressed .KTX2 files.\n"
 		"\n"
 		"More options:\n"
 		" -max_endpoints X: Manually set the max number of color endpoint clusters from 1-16128, use instead of -q\n"
@@ -121,12 +130,17 @@ static void print_usage()
 		" -separate_rg_to_color_alpha: Separate input R and G channels to RGB and A (for tangent space XY normal maps)\n"
 		" -swizzle rgba: Specify swizzle for the 4 input color channels using r, g, b and a (the -separate_rg_to_color_alpha flag is equivalent to rrrg)\n"
 		" -renorm: Renormalize each input image before any further processing/compression\n"
+		" -high_precision: Read 16-bit PNG's at full precision and do all preprocessing (renormalization, resampling, mipmap generation) in float,\n"
+		"  quantizing each mipmap level to 8-bits only once, just before compression\n"
 		" -no_multithreading: Disable multithreading\n"
+		" -output_validation X: How the output is verified after compression: none, sampled (checksums and a sample of each UASTC slice's blocks, ETC1S slices\n"
+		"  are transcoded to ETC1 only) or full (default, every slice is transcoded to ASTC/ETC1 and BC7). -stats and -debug_images always use full.\n"
+		" -cache_dir X: Use directory X as a persistent encode cache. Encodes whose source files and output-affecting options match a previous encode reuse its output. Bypassed by -stats and -debug_images.\n"
+		" -cache_max_size X: Set the encode cache's size limit to X megabytes, least recently used entries are evicted first (default is 1024, 0=unlimited)\n"
 		" -no_ktx: Disable KTX writing when unpacking (faster)\n"
 		" -etc1_only: Only unpack to ETC1, skipping the other texture formats during -unpack\n"
 		" -disable_hierarchical_endpoint_codebooks: Disable hierarchical endpoint codebook usage, slower but higher quality on some compression levels\n"
 		" -compare_ssim: Compute and display SSIM of image comparison (slow)\n"
-		" -bench: UASTC benchmark mode, for development only\n"
 		" -resample X Y: Resample all input images to XxY pixels\n"
 		" -resample_factor X: Resample all input images by scale factor X\n"
 		" -resample_filter X: Set resample filter kernel, default is box, filters: box, tent, bell, blackman, catmullrom, mitchell, etc.\n"
@@ -273,11 +287,11 @@ public:
 		m_multifile_first(0),
 		m_multifile_num(0),
 		m_individual(false),
+		m_video_gop_size(0),
 		m_no_ktx(false),
 		m_etc1_only(false),
 		m_fuzz_testing(false),
-		m_compare_ssim(false),
-		m_bench(false)
+		m_compare_ssim(false)
 	{
 		m_comp_params.m_compression_level = basisu::maximum<int>(0, BASISU_DEFAULT_COMPRESSION_LEVEL - 1);
 	}
@@ -339,8 +353,6 @@ public:
 				m_mode = cVersion;
 			else if (strcasecmp(pArg, "-compare_ssim") == 0)
 				m_compare_ssim = true;
-			else if (strcasecmp(pArg, "-bench") == 0)
-				m_mode = cBench;
 			else if (strcasecmp(pArg, "-comp_size") == 0)
 				m_mode = cCompSize;
 			else if (strcasecmp(pArg, "-no_sse") == 0)
@@ -438,6 +450,20 @@ public:
 				m_comp_params.m_rdo_uastc = true;
 				arg_count++;
 			}
+			else if (strcasecmp(pArg, "-uastc_rdo_bitrate") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_rdo_uastc_target_bitrate = (float)atof(arg_v[arg_index + 1]);
+				m_comp_params.m_rdo_uastc = true;
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-uastc_rdo_size") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_rdo_uastc_target_size = atoi(arg_v[arg_index + 1]);
+				m_comp_params.m_rdo_uastc = true;
+				arg_count++;
+			}
 			else if (strcasecmp(pArg, "-uastc_rdo_d") == 0)
 			{
 				REMAINING_ARGS_CHECK(1);
@@ -460,6 +486,8 @@ public:
 				m_comp_params.m_rdo_uastc_favor_simpler_modes_in_rdo_mode = false;
 			else if (strcasecmp(pArg, "-uastc_rdo_m") == 0)
 				m_comp_params.m_rdo_uastc_multithreading = false;
+			else if (strcasecmp(pArg, "-uastc_rdo_zstd") == 0)
+				m_comp_params.m_rdo_uastc_zstd_cost_model = true;
 			else if (strcasecmp(pArg, "-linear") == 0)
 				m_comp_params.m_perceptual = false;
 			else if (strcasecmp(pArg, "-srgb") == 0)
@@ -578,10 +606,49 @@ public:
 			}
 			else if (strcasecmp(pArg, "-renorm") == 0)
 				m_comp_params.m_renormalize = true;
+			else if (strcasecmp(pArg, "-high_precision") == 0)
+				m_comp_params.m_high_precision_source = true;
 			else if (strcasecmp(pArg, "-no_multithreading") == 0)
 			{
 				m_comp_params.m_multithreading = false;
 			}
+			else if (strcasecmp(pArg, "-output_validation") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				const char *pMode = arg_v[arg_index + 1];
+				if (strcasecmp(pMode, "none") == 0)
+					m_comp_params.m_validation_mode = cValidationNone;
+				else if (strcasecmp(pMode, "sampled") == 0)
+					m_comp_params.m_validation_mode = cValidationSampled;
+				else if (strcasecmp(pMode, "full") == 0)
+					m_comp_params.m_validation_mode = cValidationFull;
+				else
+				{
+					error_printf("Invalid output validation mode: %s\n", pMode);
+					return false;
+				}
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-uastc_stream") == 0)
+				m_comp_params.m_uastc_streaming = true;
+			else if (strcasecmp(pArg, "-uastc_stream_strip") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_uastc_streaming_strip_height = atoi(arg_v[arg_index + 1]);
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-cache_dir") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_cache_dir = arg_v[arg_index + 1];
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-cache_max_size") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_cache_max_size = (uint64_t)(atof(arg_v[arg_index + 1]) * 1024.0f * 1024.0f);
+				arg_count++;
+			}
 			else if (strcasecmp(pArg, "-mipmap") == 0)
 				m_comp_params.m_mip_gen = true;
 			else if (strcasecmp(pArg, "-no_ktx") == 0)
@@ -709,6 +776,24 @@ public:
 			}
 			else if (strcasecmp(pArg, "-individual") == 0)
 				m_individual = true;
+			else if (strcasecmp(pArg, "-video_iframe_interval") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_comp_params.m_video_iframe_interval = atoi(arg_v[arg_index + 1]);
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-video_gop") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				const int gop_size = atoi(arg_v[arg_index + 1]);
+				if (gop_size < 1)
+				{
+					error_printf("Invalid video GOP size: %s\n", arg_v[arg_index + 1]);
+					return false;
+				}
+				m_video_gop_size = gop_size;
+				arg_count++;
+			}
 			else if (strcasecmp(pArg, "-fuzz_testing") == 0)
 				m_fuzz_testing = true;
 			else if (strcasecmp(pArg, "-csv_file") == 0)
@@ -719,6 +804,18 @@ public:
 
 				arg_count++;
 			}
+			else if (strcasecmp(pArg, "-trace") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_trace_file = arg_v[arg_index + 1];
+				arg_count++;
+			}
+			else if (strcasecmp(pArg, "-perf_json") == 0)
+			{
+				REMAINING_ARGS_CHECK(1);
+				m_perf_json_file = arg_v[arg_index + 1];
+				arg_count++;
+			}
 			else if (pArg[0] == '-')
 			{
 				error_printf("Unrecognized command line option: %s\n", pArg);
@@ -812,14 +909,16 @@ public:
 	uint32_t m_multifile_num;
 
 	std::string m_csv_file;
+	std::string m_perf_json_file;
+	std::string m_trace_file;
 
 	std::string m_etc1s_use_global_codebooks_file;
 	bool m_individual;
+	uint32_t m_video_gop_size;
 	bool m_no_ktx;
 	bool m_etc1_only;
 	bool m_fuzz_testing;
 	bool m_compare_ssim;
-	bool m_bench;
 };
 
 static bool expand_multifile(command_line_params &opts)
@@ -912,6 +1011,172 @@ static basis_data *load_basis_file(const char *pInput_filename, basist::etc1_glo
 	return p;
 }
 
+static std::string get_json_string(const std::string& str)
+{
+	std::string res("\"");
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		const char c = str[i];
+		if ((c == '\"') || (c == '\\'))
+		{
+			res += '\\';
+			res += c;
+		}
+		else if ((uint8_t)c < 32)
+			res += string_format("\\u%04X", (uint8_t)c);
+		else
+			res += c;
+	}
+	res += "\"";
+	return res;
+}
+
+static void append_phase_timing_json(std::string& json, const char* pName, const phase_timing& t, uint32_t total_threads, bool last = false)
+{
+	json += string_format("        \"%s\": { \"wall_secs\": %f, \"cpu_secs\": %f, \"job_secs\": %f, \"thread_utilization\": %f, \"runs\": %u }%s\n",
+		pName, t.m_wall_time, t.m_cpu_time, t.m_job_time, t.get_thread_utilization(total_threads), t.m_num_runs, last ? "" : ",");
+}
+
+// Appends one file's entry to the perf JSON "files" array (json holds the entries appended so far).
+static void append_perf_stats_json(std::string& json, const std::string& filename, bool success, const basis_compressor_perf_stats& s)
+{
+	if (json.size())
+		json += ",\n";
+
+	json += "    {\n";
+	json += string_format("      \"filename\": %s,\n", get_json_string(filename).c_str());
+	json += string_format("      \"success\": %s,\n", success ? "true" : "false");
+	json += string_format("      \"cache_hit\": %s,\n", s.m_cache_hit ? "true" : "false");
+	json += string_format("      \"output_file_size\": %llu,\n", (unsigned long long)s.m_output_file_size);
+	json += string_format("      \"total_threads\": %u,\n", s.m_total_threads);
+	json += string_format("      \"thread_utilization\": %f,\n", s.m_total.get_thread_utilization(s.m_total_threads));
+	json += string_format("      \"peak_memory_bytes\": %llu,\n", (unsigned long long)s.m_peak_memory_usage);
+	json += string_format("      \"total_slices\": %u,\n", s.m_total_slices);
+	json += string_format("      \"total_blocks\": %u,\n", s.m_total_blocks);
+	json += string_format("      \"total_endpoint_clusters\": %u,\n", s.m_total_endpoint_clusters);
+	json += string_format("      \"total_selector_clusters\": %u,\n", s.m_total_selector_clusters);
+	
+	json += "      \"phases\": {\n";
+	append_phase_timing_json(json, "total", s.m_total, s.m_total_threads);
+	append_phase_timing_json(json, "cache_lookup", s.m_cache_lookup, s.m_total_threads);
+	append_phase_timing_json(json, "read_source_images", s.m_read_source_images, s.m_total_threads);
+	append_phase_timing_json(json, "mipgen", s.m_mipgen, s.m_total_threads);
+	append_phase_timing_json(json, "extract_source_blocks", s.m_extract_source_blocks, s.m_total_threads);
+	append_phase_timing_json(json, "frontend", s.m_frontend, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_init_endpoint_training_vectors", s.m_frontend_steps.m_init_endpoint_training_vectors, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_generate_endpoint_clusters", s.m_frontend_steps.m_generate_endpoint_clusters, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_generate_endpoint_codebook", s.m_frontend_steps.m_generate_endpoint_codebook, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_refine_endpoint_clusterization", s.m_frontend_steps.m_refine_endpoint_clusterization, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_generate_selector_clusters", s.m_frontend_steps.m_generate_selector_clusters, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_create_optimized_selector_codebook", s.m_frontend_steps.m_create_optimized_selector_codebook, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_find_optimal_selector_clusters_for_each_block", s.m_frontend_steps.m_find_optimal_selector_clusters_for_each_block, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_refine_block_endpoints_given_selectors", s.m_frontend_steps.m_refine_block_endpoints_given_selectors, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_optimize_selector_codebook", s.m_frontend_steps.m_optimize_selector_codebook, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_finalize", s.m_frontend_steps.m_finalize, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_validate", s.m_frontend_steps.m_validate, s.m_total_threads);
+	append_phase_timing_json(json, "frontend_extract", s.m_frontend_extract, s.m_total_threads);
+	append_phase_timing_json(json, "backend", s.m_backend, s.m_total_threads);
+	append_phase_timing_json(json, "uastc_encode", s.m_uastc_encode, s.m_total_threads);
+	append_phase_timing_json(json, "uastc_rdo", s.m_uastc_rdo, s.m_total_threads);
+	append_phase_timing_json(json, "create_basis_file", s.m_create_basis_file, s.m_total_threads);
+	append_phase_timing_json(json, "validation", s.m_validation, s.m_total_threads);
+	append_phase_timing_json(json, "create_ktx2_file", s.m_create_ktx2_file, s.m_total_threads);
+	append_phase_timing_json(json, "zstd", s.m_zstd, s.m_total_threads);
+	append_phase_timing_json(json, "write_output", s.m_write_output, s.m_total_threads, true);
+	json += "      }\n";
+
+	json += "    }";
+}
+
+// Writes the perf JSON file from the entries appended by append_perf_stats_json(). Called on failure too, so the failing file's stats aren't lost.
+static void write_perf_json_file(const std::string& filename, const std::string& files_json)
+{
+	std::string json("{\n");
+	json += string_format("  \"basisu_version\": \"%s\",\n", BASISU_TOOL_VERSION);
+	json += "  \"files\": [\n";
+	if (files_json.size())
+		json += files_json + "\n";
+	json += "  ]\n";
+	json += "}\n";
+
+	if (!write_data_to_file(filename.c_str(), json.data(), json.size()))
+		error_printf("Failed writing perf JSON file \"%s\"\n", filename.c_str());
+	else
+		printf("Wrote perf JSON file \"%s\"\n", filename.c_str());
+}
+
+static bool compress_video_gops(command_line_params &opts, uint32_t num_threads)
+{
+	basis_compressor_params &params = opts.m_comp_params;
+
+	params.m_source_filenames = opts.m_input_filenames;
+	params.m_source_alpha_filenames = opts.m_input_alpha_filenames;
+
+	if (opts.m_output_filename.size())
+		params.m_out_filename = opts.m_output_filename;
+	else
+	{
+		std::string filename;
+
+		string_get_filename(opts.m_input_filenames[0].c_str(), filename);
+		string_remove_extension(filename);
+
+		filename += opts.m_ktx2_mode ? ".ktx2" : ".basis";
+
+		if (opts.m_output_path.size())
+			string_combine_path(filename, opts.m_output_path.c_str(), filename.c_str());
+
+		params.m_out_filename = filename;
+	}
+
+	if (opts.m_csv_file.size())
+	{
+		error_printf("-csv_file isn't supported with -video_gop\n");
+		return false;
+	}
+
+	basisu::vector<basis_compressor_params> gop_params;
+	if (!basis_split_video_gops(params, opts.m_video_gop_size, gop_params))
+		return false;
+
+	printf("Compressing %u frames as %u GOP(s) of up to %u frames using %u thread(s)\n", (uint32_t)opts.m_input_filenames.size(), (uint32_t)gop_params.size(), opts.m_video_gop_size, num_threads);
+
+	interval_timer all_tm;
+	all_tm.start();
+
+	basisu::vector<parallel_results> results;
+	const bool status = basis_parallel_compress(num_threads, gop_params, results);
+
+	all_tm.stop();
+
+	std::string perf_json;
+
+	uint64_t total_size = 0;
+	for (uint32_t i = 0; i < gop_params.size(); i++)
+	{
+		if (opts.m_perf_json_file.size())
+			append_perf_stats_json(perf_json, gop_params[i].m_out_filename, results[i].m_error_code == basis_compressor::cECSuccess, results[i].m_perf_stats);
+
+		if (results[i].m_error_code != basis_compressor::cECSuccess)
+		{
+			error_printf("Compression of GOP %u to file \"%s\" failed with error code %u!\n", i, gop_params[i].m_out_filename.c_str(), (uint32_t)results[i].m_error_code);
+			continue;
+		}
+
+		const size_t size = opts.m_ktx2_mode ? results[i].m_ktx2_file.size() : results[i].m_basis_file.size();
+		total_size += size;
+
+		printf("Compression succeeded to file \"%s\" size %u bytes in %3.3f secs\n", gop_params[i].m_out_filename.c_str(), (uint32_t)size, results[i].m_total_time);
+	}
+
+	printf("Total compression time: %3.3f secs, total size: %llu bytes\n", all_tm.get_elapsed_secs(), (unsigned long long)total_size);
+
+	if (opts.m_perf_json_file.size())
+		write_perf_json_file(opts.m_perf_json_file, perf_json);
+
+	return status;
+}
+
 static bool compress_mode(command_line_params &opts)
 {
 	basist::etc1_global_selector_codebook sel_codebook(basist::g_global_selector_cb_size, basist::g_global_selector_cb);
@@ -1025,6 +1290,15 @@ static bool compress_mode(command_line_params &opts)
 	params.m_write_output_basis_files = true;
 	params.m_pSel_codebook = &sel_codebook;
 	params.m_pGlobal_codebooks = pGlobal_codebook_data ? &pGlobal_codebook_data->m_transcoder.get_lowlevel_etc1s_decoder() : nullptr; 
+
+	if ((opts.m_video_gop_size) && (!opts.m_individual) && (params.m_tex_type == basist::cBASISTexTypeVideoFrames))
+	{
+		const bool status = compress_video_gops(opts, num_threads);
+		delete pGlobal_codebook_data; 
+		pGlobal_codebook_data = nullptr;
+		return status;
+	}
+
 	FILE *pCSV_file = nullptr;
 	if (opts.m_csv_file.size())
 	{
@@ -1045,6 +1319,9 @@ static bool compress_mode(command_line_params &opts)
 	all_tm.start();
 
 	const size_t total_files = (opts.m_individual ? opts.m_input_filenames.size() : 1U);
+
+	std::string perf_json;
+
 	for (size_t file_index = 0; file_index < total_files; file_index++)
 	{
 		if (opts.m_individual)
@@ -1098,6 +1375,9 @@ static bool compress_mode(command_line_params &opts)
 		{
 			error_printf("basis_compressor::init() failed!\n");
 
+			if (opts.m_perf_json_file.size())
+				write_perf_json_file(opts.m_perf_json_file, perf_json);
+
 			if (pCSV_file)
 			{
 				fclose(pCSV_file);
@@ -1115,10 +1395,13 @@ static bool compress_mode(command_line_params &opts)
 
 		tm.stop();
 
+		if (opts.m_perf_json_file.size())
+			append_perf_stats_json(perf_json, params.m_out_filename, ec == basis_compressor::cECSuccess, c.get_perf_stats());
+
 		if (ec == basis_compressor::cECSuccess)
 		{
-			printf("Compression succeeded to file \"%s\" size %u bytes in %3.3f secs\n", params.m_out_filename.c_str(), 
-				opts.m_ktx2_mode ? c.get_output_ktx2_file().size() : c.get_output_basis_file().size(), 
+			printf("Compression succeeded to file \"%s\" size %llu bytes in %3.3f secs\n", params.m_out_filename.c_str(), 
+				(unsigned long long)c.get_perf_stats().m_output_file_size, 
 				tm.get_elapsed_secs());
 		}
 		else
@@ -1170,6 +1453,9 @@ static bool compress_mode(command_line_params &opts)
 		
 			if (exit_flag)
 			{
+				if (opts.m_perf_json_file.size())
+					write_perf_json_file(opts.m_perf_json_file, perf_json);
+
 				if (pCSV_file)
 				{
 					fclose(pCSV_file);
@@ -1250,6 +1536,9 @@ static bool compress_mode(command_line_params &opts)
 	if (total_files > 1)
 		printf("Total compression time: %3.3f secs\n", all_tm.get_elapsed_secs());
 
+	if (opts.m_perf_json_file.size())
+		write_perf_json_file(opts.m_perf_json_file, perf_json);
+
 	if (pCSV_file)
 	{
 		fclose(pCSV_file);
@@ -2475,34 +2764,45 @@ static bool compare_mode(command_line_params &opts)
 
 	printf("Comparison image res: %ux%u\n", a.get_width(), a.get_height());
 
+	uint32_t num_threads = 1;
+
+	if (opts.m_comp_params.m_multithreading)
+	{
+		num_threads = std::thread::hardware_concurrency();
+		if (num_threads < 1)
+			num_threads = 1;
+	}
+
+	job_pool jpool(num_threads);
+
 	image_metrics im;
-	im.calc(a, b, 0, 3);
+	im.calc(a, b, 0, 3, true, false, &jpool);
 	im.print("RGB    ");
 
-	im.calc(a, b, 0, 4);
+	im.calc(a, b, 0, 4, true, false, &jpool);
 	im.print("RGBA   ");
 
-	im.calc(a, b, 0, 1);
+	im.calc(a, b, 0, 1, true, false, &jpool);
 	im.print("R      ");
 
-	im.calc(a, b, 1, 1);
+	im.calc(a, b, 1, 1, true, false, &jpool);
 	im.print("G      ");
 
-	im.calc(a, b, 2, 1);
+	im.calc(a, b, 2, 1, true, false, &jpool);
 	im.print("B      ");
 
-	im.calc(a, b, 3, 1);
+	im.calc(a, b, 3, 1, true, false, &jpool);
 	im.print("A      ");
 
-	im.calc(a, b, 0, 0);
+	im.calc(a, b, 0, 0, true, false, &jpool);
 	im.print("Y 709  " );
 
-	im.calc(a, b, 0, 0, true, true);
+	im.calc(a, b, 0, 0, true, true, &jpool);
 	im.print("Y 601  " );
 	
 	if (opts.m_compare_ssim)
 	{
-		vec4F s_rgb(compute_ssim(a, b, false, false));
+		vec4F s_rgb(compute_ssim(a, b, false, false, &jpool));
 
 		printf("R SSIM: %f\n", s_rgb[0]);
 		printf("G SSIM: %f\n", s_rgb[1]);
@@ -2510,10 +2810,10 @@ static bool compare_mode(command_line_params &opts)
 		printf("RGB Avg SSIM: %f\n", (s_rgb[0] + s_rgb[1] + s_rgb[2]) / 3.0f);
 		printf("A SSIM: %f\n", s_rgb[3]);
 
-		vec4F s_y_709(compute_ssim(a, b, true, false));
+		vec4F s_y_709(compute_ssim(a, b, true, false, &jpool));
 		printf("Y 709 SSIM: %f\n", s_y_709[0]);
 
-		vec4F s_y_601(compute_ssim(a, b, true, true));
+		vec4F s_y_601(compute_ssim(a, b, true, true, &jpool));
 		printf("Y 601 SSIM: %f\n", s_y_601[0]);
 	}
 
@@ -2549,1151 +2849,6 @@ static bool compare_mode(command_line_params &opts)
 	return true;
 }
 
-#include "encoder/basisu_astc_decomp.h"
-#include "encoder/basisu_pvrtc1_4.h"
-
-static bool bench_mode(command_line_params& opts)
-{
-#if 0
-	ispc::bc7e_compress_block_init();
-
-	ispc::bc7e_compress_block_params pack_params;
-	memset(&pack_params, 0, sizeof(pack_params));
-	ispc::bc7e_compress_block_params_init_slow(&pack_params, false);
-#endif
-
-	const uint32_t JOB_POOL_SIZE = 7;
-	job_pool jpool(JOB_POOL_SIZE);
-
-	float total_uastc_psnr = 0, total_uastc_a_psnr = 0, total_uastc_rgba_psnr = 0;
-	float total_rdo_uastc_psnr = 0, total_rdo_uastc_a_psnr = 0, total_rdo_uastc_rgba_psnr = 0;
-	float total_uastc2_psnr = 0, total_uastc2_a_psnr = 0, total_uastc2_rgba_psnr = 0;
-	float total_bc7_psnr = 0, total_bc7_a_psnr = 0, total_bc7_rgba_psnr = 0;
-	float total_rdo_bc7_psnr = 0, total_rdo_bc7_a_psnr = 0, total_rdo_bc7_rgba_psnr = 0;
-	float total_obc1_psnr = 0;
-	float total_obc1_2_psnr = 0;
-	float total_obc1_psnr_sq = 0;
-	float total_obc1_2_psnr_sq = 0;
-	float total_bc1_psnr = 0;
-	float total_bc1_psnr_sq = 0;
-	//float total_obc7_psnr = 0, total_obc7_rgba_psnr = 0;
-	//float total_obc7_a_psnr = 0;
-	//float total_oastc_psnr = 0, total_oastc_rgba_psnr = 0;
-	float total_bc7enc_psnr = 0, total_bc7enc_rgba_psnr = 0, total_bc7enc_a_psnr = 0;
-	//float total_oastc_a_psnr = 0;
-	float total_etc1_psnr = 0;
-	float total_etc1_y_psnr = 0;
-	float total_etc1_g_psnr = 0;
-	float total_etc2_psnr = 0, total_etc2_rgba_psnr = 0;
-	float total_etc2_a_psnr = 0;
-	float total_bc3_psnr = 0, total_bc3_rgba_psnr = 0;
-	float total_bc3_a_psnr = 0;
-	float total_eac_r11_psnr = 0;
-	float total_eac_rg11_psnr = 0;
-	float total_pvrtc1_rgb_psnr = 0, total_pvrtc1_rgba_psnr = 0;
-	float total_pvrtc1_a_psnr = 0;
-	uint32_t total_images = 0;
-	uint32_t total_a_images = 0;
-	uint32_t total_pvrtc1_images = 0;
-
-	uint64_t overall_mode_hist[basist::TOTAL_UASTC_MODES];
-	memset(overall_mode_hist, 0, sizeof(overall_mode_hist));
-
-	std::mutex mode_hist_mutex;
-
-	uint32_t etc1_hint_hist[32];
-	memset(etc1_hint_hist, 0, sizeof(etc1_hint_hist));
-
-	srand(1023);
-	uint32_t first_image = 96;
-	uint32_t last_image = 96; //34
-
-	if (opts.m_input_filenames.size() >= 1)
-	{
-		first_image = 1;
-		last_image = 1;
-	}
-
-	const bool perceptual = false;
-	const bool force_la = false;
-
-	interval_timer otm;
-	otm.start();
-
-	//const uint32_t flags = cPackUASTCLevelFastest;// | cPackUASTCETC1DisableFlipAndIndividual;// Slower;
-	//const uint32_t flags = cPackUASTCLevelFaster;
-	//const uint32_t flags = cPackUASTCLevelVerySlow;
-	const uint32_t flags = cPackUASTCLevelDefault;
-
-	uint32_t etc1_inten_hist[8] = { 0,0,0,0,0,0,0,0 };
-	uint32_t etc1_flip_hist[2] = { 0, 0 };
-	uint32_t etc1_diff_hist[2] = { 0, 0 };
-
-	double overall_total_enc_time = 0;
-	double overall_total_bench_time = 0;
-	double overall_total_bench2_time = 0;
-	uint64_t overall_blocks = 0;
-
-	//bc7enc_compress_block_params bc7enc_p;
-	//bc7enc_compress_block_params_init(&bc7enc_p);
-	//bc7enc_compress_block_params_init_linear_weights(&bc7enc_p);
-	//bc7enc_p.m_uber_level = 3;
-
-	uint64_t total_comp_size = 0;
-	uint64_t total_raw_size = 0;
-	uint64_t total_rdo_comp_size = 0;
-	uint64_t total_rdo_raw_size = 0;
-	uint64_t total_comp_blocks = 0;
-
-	for (uint32_t image_index = first_image; image_index <= last_image; image_index++)
-	{
-		uint64_t mode_hist[basist::TOTAL_UASTC_MODES];
-		memset(mode_hist, 0, sizeof(mode_hist));
-
-		char buf[1024];
-		if (opts.m_input_filenames.size() >= 1)
-			strcpy(buf, opts.m_input_filenames[0].c_str());
-		else
-			sprintf(buf, "c:/dev/test_images/photo_png/kodim%02u.png", image_index);
-
-		printf("Image: %s\n", buf);
-
-		image img;
-		if (!load_image(buf, img))
-			return 0;
-
-		if (opts.m_input_filenames.size() == 2)
-		{
-			image alpha_img;
-			if (!load_image(opts.m_input_filenames[1].c_str(), alpha_img))
-				return 0;
-
-			printf("Alpha image: %s, %ux%u\n", opts.m_input_filenames[1].c_str(), alpha_img.get_width(), alpha_img.get_height());
-
-			for (uint32_t x = 0; x < alpha_img.get_width(); x++)
-				for (uint32_t y = 0; y < alpha_img.get_height(); y++)
-				{
-					if (x < img.get_width() && y < img.get_height())
-						img(x, y)[3] = (uint8_t)alpha_img(x, y).get_709_luma();
-				}
-		}
-
-		if (force_la)
-		{
-			for (uint32_t x = 0; x < img.get_width(); x++)
-			{
-				for (uint32_t y = 0; y < img.get_height(); y++)
-				{
-					const color_rgba& c = img(x, y);
-					img(x, y).set(c.r, c.r, c.r, c.g);
-				}
-			}
-		}
-
-		// HACK HACK
-		//if (!img.has_alpha())
-		//	continue;
-
-		// HACK HACK
-		//img.crop(1024, 1024);
-
-		const uint32_t num_blocks_x = img.get_block_width(4);
-		const uint32_t num_blocks_y = img.get_block_height(4);
-		const uint32_t total_blocks = num_blocks_x * num_blocks_y;
-		const bool img_has_alpha = img.has_alpha();
-
-		img.crop_dup_borders(num_blocks_x * 4, num_blocks_y * 4);
-
-		printf("%ux%u, has alpha: %u\n", img.get_width(), img.get_height(), img_has_alpha);
-
-		image uastc_img(num_blocks_x * 4, num_blocks_y * 4);
-		image rdo_uastc_img(num_blocks_x * 4, num_blocks_y * 4);
-		image uastc2_img(num_blocks_x * 4, num_blocks_y * 4);
-		image opt_bc1_img(num_blocks_x * 4, num_blocks_y * 4);
-		image opt_bc1_2_img(num_blocks_x * 4, num_blocks_y * 4);
-		image bc1_img(num_blocks_x * 4, num_blocks_y * 4);
-		image bc3_img(num_blocks_x * 4, num_blocks_y * 4);
-		image eac_r11_img(num_blocks_x * 4, num_blocks_y * 4);
-		image eac_rg11_img(num_blocks_x * 4, num_blocks_y * 4);
-		image bc7_img(num_blocks_x * 4, num_blocks_y * 4);
-		image rdo_bc7_img(num_blocks_x * 4, num_blocks_y * 4);
-		image opt_bc7_img(num_blocks_x * 4, num_blocks_y * 4);
-		image etc1_img(num_blocks_x * 4, num_blocks_y * 4);
-		image etc1_g_img(num_blocks_x * 4, num_blocks_y * 4);
-		image etc2_img(num_blocks_x * 4, num_blocks_y * 4);
-		image part_img(num_blocks_x * 4, num_blocks_y * 4);
-		image opt_astc_img(num_blocks_x * 4, num_blocks_y * 4);
-		image bc7enc_img(num_blocks_x * 4, num_blocks_y * 4);
-
-		uint32_t total_bc1_hint0s = 0;
-		uint32_t total_bc1_hint1s = 0;
-		uint32_t total_bc1_hint01s = 0;
-
-		double total_enc_time = 0;
-		double total_bench_time = 0;
-		double total_bench2_time = 0;
-
-		basisu::vector<basist::uastc_block> ublocks(total_blocks);
-
-#if 0
-		astc_enc_settings astc_settings;
-		//if (img_has_alpha)
-		GetProfile_astc_alpha_slow(&astc_settings, 4, 4);
-		//else
-		//	GetProfile_astc_fast(&astc_settings, 4, 4);
-#endif
-
-#if 0
-//#pragma omp parallel for
-		for (int by = 0; by < (int)num_blocks_y; by++)
-		{
-			// Process 64 blocks at a time, for efficient SIMD processing.
-			// Ideally, N >= 8 (or more) and (N % 8) == 0.
-			const int N = 64;
-
-			for (uint32_t bx = 0; bx < num_blocks_x; bx += N)
-			{
-				const uint32_t num_blocks_to_process = basisu::minimum<uint32_t>(num_blocks_x - bx, N);
-
-				color_rgba pixels[16 * N];
-
-#if 0
-				// BC7E
-				// Extract num_blocks_to_process 4x4 pixel blocks from the source image and put them into the pixels[] array.
-				for (uint32_t b = 0; b < num_blocks_to_process; b++)
-					img.extract_block_clamped(pixels + b * 16, (bx + b) * 4, by * 4, 4, 4);
-
-				// Compress the blocks to BC7.
-				// Note: If you've used Intel's ispc_texcomp, the input pixels are different. BC7E requires a pointer to an array of 16 pixels for each block.
-				basist::bc7_block packed_blocks[N];
-				ispc::bc7e_compress_blocks(num_blocks_to_process, (uint64_t*)packed_blocks, reinterpret_cast<const uint32_t*>(pixels), &pack_params);
-
-				for (uint32_t i = 0; i < num_blocks_to_process; i++)
-				{
-					color_rgba decoded_block[4][4];
-
-					//detexDecompressBlockBPTC((uint8_t *)&packed_blocks[i], 0xFF, 0, (uint8_t *)&decoded_block[0][0]);
-					unpack_block(texture_format::cBC7, &packed_blocks[i], &decoded_block[0][0]);
-
-					opt_bc7_img.set_block_clipped(&decoded_block[0][0], (bx + i) * 4, by * 4, 4, 4);
-				}
-#endif
-
-#if 0
-				// ispc_texcomp
-				color_rgba raster_pixels[(N * 4) * 4];
-
-				const uint32_t raster_width = num_blocks_to_process * 4;
-				const uint32_t raster_height = 4;
-
-				rgba_surface surf;
-				surf.ptr = &raster_pixels[0].r;
-				surf.width = raster_width;
-				surf.height = 4;
-				surf.stride = raster_width * 4;
-
-				for (uint32_t b = 0; b < num_blocks_to_process; b++)
-					for (uint32_t y = 0; y < 4; y++)
-						for (uint32_t x = 0; x < 4; x++)
-							raster_pixels[y * raster_width + b * 4 + x] = pixels[b * 16 + y * 4 + x];
-
-				uint8_t astc_blocks[16 * N];
-				CompressBlocksASTC(&surf, astc_blocks, &astc_settings);
-
-				for (uint32_t i = 0; i < num_blocks_to_process; i++)
-				{
-					color_rgba decoded_astc_block[4][4];
-					basisu_astc::astc::decompress((uint8_t*)decoded_astc_block, (uint8_t*)&astc_blocks[i * 16], false, 4, 4);
-
-					opt_astc_img.set_block_clipped(&decoded_astc_block[0][0], (bx + i) * 4, by * 4, 4, 4);
-				}
-#endif
-			}
-		}
-#endif
-
-		const uint32_t N = 128;
-		for (uint32_t block_index_iter = 0; block_index_iter < total_blocks; block_index_iter += N)
-		{
-			const uint32_t first_index = block_index_iter;
-			const uint32_t last_index = minimum<uint32_t>(total_blocks, block_index_iter + N);
-
-			jpool.add_job([first_index, last_index, &img, num_blocks_x, num_blocks_y,
-				&opt_bc1_img, &opt_bc1_2_img, &mode_hist, &overall_mode_hist, &uastc_img, &uastc2_img, &bc7_img, &part_img, &mode_hist_mutex, &bc1_img, &etc1_img, &etc1_g_img, &etc2_img, &etc1_hint_hist, &perceptual,
-				&total_bc1_hint0s, &total_bc1_hint1s, &total_bc1_hint01s, &bc3_img, &total_enc_time, &eac_r11_img, &eac_rg11_img, &ublocks, &flags, &etc1_inten_hist, &etc1_flip_hist, &etc1_diff_hist, &total_bench_time, &total_bench2_time,
-				//&bc7enc_p, &bc7enc_img] {
-				&bc7enc_img] {
-
-					BASISU_NOTE_UNUSED(num_blocks_y);
-					BASISU_NOTE_UNUSED(perceptual);
-					BASISU_NOTE_UNUSED(flags);
-
-					for (uint32_t block_index = first_index; block_index < last_index; block_index++)
-					{
-						const uint32_t block_x = block_index % num_blocks_x;
-						const uint32_t block_y = block_index / num_blocks_x;
-
-						//uint32_t block_x = 170;
-						//uint32_t block_y = 167;
-
-						// HACK HACK
-						//if ((block_x == 77) && (block_y == 54))
-						//	printf("!");
-
-						color_rgba block[4][4];
-						img.extract_block_clamped(&block[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						uint8_t bc7_block[16];
-						//bc7enc_compress_block(bc7_block, block, &bc7enc_p);
-						color_rgba decoded_bc7enc_blk[4][4];
-						unpack_block(texture_format::cBC7, &bc7_block, &decoded_bc7enc_blk[0][0]);
-						bc7enc_img.set_block_clipped(&decoded_bc7enc_blk[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// Pack near-optimal BC1
-						// stb_dxt BC1 encoder
-						uint8_t bc1_block[8];
-
-						interval_timer btm;
-						btm.start();
-
-						//stb_compress_dxt_block(bc1_block, (uint8_t*)&block[0][0], 0, STB_DXT_HIGHQUAL);
-						basist::encode_bc1(bc1_block, (uint8_t*)&block[0][0], 0);// basist::cEncodeBC1HighQuality);
-						double total_b_time = btm.get_elapsed_secs();
-						{
-							std::lock_guard<std::mutex> lck(mode_hist_mutex);
-							total_bench_time += total_b_time;
-						}
-
-						color_rgba block_bc1[4][4];
-						unpack_block(texture_format::cBC1, bc1_block, &block_bc1[0][0]);
-						opt_bc1_img.set_block_clipped(&block_bc1[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						//uint64_t e1 = 0;
-						//for (uint32_t i = 0; i < 16; i++)
-						//	e1 += color_distance(((color_rgba*)block_bc1)[i], ((color_rgba*)block)[i], false);
-
-						// My BC1 encoder
-						uint8_t bc1_block_2[8];
-						color_rgba block_bc1_2[4][4];
-
-						btm.start();
-						basist::encode_bc1_alt(bc1_block_2, (uint8_t*)&block[0][0], basist::cEncodeBC1HighQuality);
-						double total_b2_time = btm.get_elapsed_secs();
-						{
-							std::lock_guard<std::mutex> lck(mode_hist_mutex);
-							total_bench2_time += total_b2_time;
-						}
-
-						unpack_block(texture_format::cBC1, bc1_block_2, &block_bc1_2[0][0]);
-						//uint64_t e2 = 0;
-						//for (uint32_t i = 0; i < 16; i++)
-						//	e2 += color_distance(((color_rgba *)block_bc1_2)[i], ((color_rgba*)block)[i], false);
-
-						opt_bc1_2_img.set_block_clipped(&block_bc1_2[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// Encode to UASTC
-						basist::uastc_block encoded_uastc_blk;
-
-						interval_timer tm;
-						tm.start();
-						encode_uastc(&block[0][0].r, encoded_uastc_blk, flags);
-						double total_time = tm.get_elapsed_secs();
-						{
-							std::lock_guard<std::mutex> lck(mode_hist_mutex);
-							total_enc_time += total_time;
-						}
-
-						ublocks[block_x + block_y * num_blocks_x] = encoded_uastc_blk;
-
-#if 0
-						for (uint32_t i = 0; i < 16; i++)
-							printf("0x%X,", encoded_uastc_blk.m_bytes[i]);
-						printf("\n");
-#endif
-
-						// Unpack UASTC
-						basist::unpacked_uastc_block unpacked_uastc_blk;
-						unpack_uastc(encoded_uastc_blk, unpacked_uastc_blk, false);
-
-						color_rgba unpacked_uastc_block_pixels[4][4];
-						bool success = basist::unpack_uastc(unpacked_uastc_blk, (basist::color32*) & unpacked_uastc_block_pixels[0][0], false);
-						(void)success;
-						assert(success);
-
-						uastc_img.set_block_clipped(&unpacked_uastc_block_pixels[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						const uint32_t best_mode = unpacked_uastc_blk.m_mode;
-
-						{
-							std::lock_guard<std::mutex> lck(mode_hist_mutex);
-							assert(best_mode < basist::TOTAL_UASTC_MODES);
-							if (best_mode < basist::TOTAL_UASTC_MODES)
-							{
-								mode_hist[best_mode]++;
-								overall_mode_hist[best_mode]++;
-							}
-
-							if (basist::g_uastc_mode_has_etc1_bias[best_mode])
-								etc1_hint_hist[unpacked_uastc_blk.m_etc1_bias]++;
-
-							total_bc1_hint0s += unpacked_uastc_blk.m_bc1_hint0;
-							total_bc1_hint1s += unpacked_uastc_blk.m_bc1_hint1;
-							total_bc1_hint01s += (unpacked_uastc_blk.m_bc1_hint0 || unpacked_uastc_blk.m_bc1_hint1);
-
-							etc1_inten_hist[unpacked_uastc_blk.m_etc1_inten0]++;
-							etc1_inten_hist[unpacked_uastc_blk.m_etc1_inten1]++;
-
-							etc1_flip_hist[unpacked_uastc_blk.m_etc1_flip]++;
-							etc1_diff_hist[unpacked_uastc_blk.m_etc1_diff]++;
-						}
-
-						// Transcode to BC1
-						color_rgba tblock_bc1[4][4];
-
-						uint8_t tbc1_block[8];
-						transcode_uastc_to_bc1(encoded_uastc_blk, tbc1_block, false);
-						unpack_block(texture_format::cBC1, tbc1_block, &tblock_bc1[0][0]);
-						bc1_img.set_block_clipped(&tblock_bc1[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// Transcode to BC7
-						basist::bc7_optimization_results best_bc7_results;
-						transcode_uastc_to_bc7(unpacked_uastc_blk, best_bc7_results);
-
-						{
-							basist::bc7_block bc7_data;
-							encode_bc7_block(&bc7_data, &best_bc7_results);
-
-							color_rgba decoded_bc7_blk[4][4];
-							unpack_block(texture_format::cBC7, &bc7_data, &decoded_bc7_blk[0][0]);
-
-							bc7_img.set_block_clipped(&decoded_bc7_blk[0][0], block_x * 4, block_y * 4, 4, 4);
-
-							// Compute partition visualization image
-							for (uint32_t y = 0; y < 4; y++)
-							{
-								for (uint32_t x = 0; x < 4; x++)
-								{
-									uint32_t part = 0;
-									switch (best_bc7_results.m_mode)
-									{
-									case 1:
-									case 3:
-									case 7:
-										part = basist::g_bc7_partition2[best_bc7_results.m_partition * 16 + x + y * 4];
-										break;
-									case 0:
-									case 2:
-										part = basist::g_bc7_partition3[best_bc7_results.m_partition * 16 + x + y * 4];
-										break;
-									}
-
-									color_rgba c(0, 255, 0, 255);
-									if (part == 1)
-										c.set(255, 0, 0, 255);
-									else if (part == 2)
-										c.set(0, 0, 255, 255);
-
-									part_img.set_clipped(block_x * 4 + x, block_y * 4 + y, c);
-								}
-							}
-						}
-
-						bool high_quality = false;
-
-						// Transcode UASTC->BC3
-						uint8_t ublock_bc3[16];
-						transcode_uastc_to_bc3(encoded_uastc_blk, ublock_bc3, high_quality);
-						color_rgba ublock_bc3_unpacked[4][4];
-						unpack_block(texture_format::cBC3, &ublock_bc3, &ublock_bc3_unpacked[0][0]);
-						bc3_img.set_block_clipped(&ublock_bc3_unpacked[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// Transcode UASTC->R11
-						uint8_t ublock_eac_r11[8];
-						transcode_uastc_to_etc2_eac_r11(encoded_uastc_blk, ublock_eac_r11, high_quality, 0);
-						color_rgba ublock_eac_r11_unpacked[4][4];
-						for (uint32_t y = 0; y < 4; y++)
-							for (uint32_t x = 0; x < 4; x++)
-								ublock_eac_r11_unpacked[y][x].set(0, 0, 0, 255);
-						unpack_block(texture_format::cETC2_R11_EAC, &ublock_eac_r11, &ublock_eac_r11_unpacked[0][0]);
-						eac_r11_img.set_block_clipped(&ublock_eac_r11_unpacked[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// Transcode UASTC->RG11
-						uint8_t ublock_eac_rg11[16];
-						transcode_uastc_to_etc2_eac_rg11(encoded_uastc_blk, ublock_eac_rg11, high_quality, 0, 1);
-						color_rgba ublock_eac_rg11_unpacked[4][4];
-						for (uint32_t y = 0; y < 4; y++)
-							for (uint32_t x = 0; x < 4; x++)
-								ublock_eac_rg11_unpacked[y][x].set(0, 0, 0, 255);
-						unpack_block(texture_format::cETC2_RG11_EAC, &ublock_eac_rg11, &ublock_eac_rg11_unpacked[0][0]);
-						eac_rg11_img.set_block_clipped(&ublock_eac_rg11_unpacked[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						// ETC1
-						etc_block unpacked_etc1;
-						transcode_uastc_to_etc1(encoded_uastc_blk, &unpacked_etc1);
-						color_rgba unpacked_etc1_block[16];
-						unpack_etc1(unpacked_etc1, unpacked_etc1_block);
-						etc1_img.set_block_clipped(unpacked_etc1_block, block_x * 4, block_y * 4, 4, 4);
-
-						// ETC1 Y
-						etc_block unpacked_etc1_g;
-
-						transcode_uastc_to_etc1(encoded_uastc_blk, &unpacked_etc1_g, 1);
-
-						color_rgba unpacked_etc1_g_block[16];
-						unpack_etc1(unpacked_etc1_g, unpacked_etc1_g_block);
-						etc1_g_img.set_block_clipped(unpacked_etc1_g_block, block_x * 4, block_y * 4, 4, 4);
-
-						// ETC2
-						etc2_rgba_block unpacked_etc2;
-						transcode_uastc_to_etc2_rgba(encoded_uastc_blk, &unpacked_etc2);
-
-						color_rgba unpacked_etc2_block[16];
-						unpack_block(texture_format::cETC2_RGBA, &unpacked_etc2, unpacked_etc2_block);
-						etc2_img.set_block_clipped(unpacked_etc2_block, block_x * 4, block_y * 4, 4, 4);
-
-						// UASTC->ASTC
-						uint32_t tastc_data[4];
-
-						transcode_uastc_to_astc(encoded_uastc_blk, tastc_data);
-
-						color_rgba decoded_tastc_block[4][4];
-						basisu_astc::astc::decompress((uint8_t*)decoded_tastc_block, (uint8_t*)&tastc_data, false, 4, 4);
-
-						uastc2_img.set_block_clipped(&decoded_tastc_block[0][0], block_x * 4, block_y * 4, 4, 4);
-
-						for (uint32_t y = 0; y < 4; y++)
-						{
-							for (uint32_t x = 0; x < 4; x++)
-							{
-								if (decoded_tastc_block[y][x] != unpacked_uastc_block_pixels[y][x])
-								{
-									printf("UASTC!=ASTC!\n");
-								}
-							}
-						}
-
-					} // block_index
-
-				});
-
-		} // block_index_iter
-
-		jpool.wait_for_all();
-
-		{
-			size_t comp_size = 0;
-			void* pComp_data = tdefl_compress_mem_to_heap(&ublocks[0], ublocks.size() * 16, &comp_size, TDEFL_MAX_PROBES_MASK);// TDEFL_DEFAULT_MAX_PROBES);
-
-			size_t decomp_size;
-			void* pDecomp_data = tinfl_decompress_mem_to_heap(pComp_data, comp_size, &decomp_size, 0);
-
-			if ((decomp_size != ublocks.size() * 16) || (memcmp(pDecomp_data, &ublocks[0], decomp_size) != 0))
-			{
-				printf("Compression or decompression failed!\n");
-				exit(1);
-			}
-
-			mz_free(pComp_data);
-			mz_free(pDecomp_data);
-
-			printf("Pre-RDO UASTC size: %u, compressed size: %u, %3.2f bits/texel\n",
-				(uint32_t)ublocks.size() * 16,
-				(uint32_t)comp_size,
-				comp_size * 8.0f / img.get_total_pixels());
-
-			total_comp_size += comp_size;
-			total_raw_size += ublocks.size() * 16;
-		}
-
-		basisu::vector<color_rgba> orig_block_pixels(ublocks.size() * 16);
-		for (uint32_t block_y = 0; block_y < num_blocks_y; block_y++)
-			for (uint32_t block_x = 0; block_x < num_blocks_x; block_x++)
-				img.extract_block_clamped(&orig_block_pixels[(block_x + block_y * num_blocks_x) * 16], block_x * 4, block_y * 4, 4, 4);
-
-		// HACK HACK
-		const uint32_t max_rdo_jobs = 4;
-		
-		char rdo_fname[256];
-		FILE* pFile = nullptr;
-		for (uint32_t try_index = 0; try_index < 100; try_index++)
-		{
-			sprintf(rdo_fname, "rdo_%02u_%u.csv", image_index, try_index);
-			pFile = fopen(rdo_fname, "rb");
-			if (pFile)
-			{
-				fclose(pFile);
-				continue;
-			}
-			
-			pFile = fopen(rdo_fname, "w");
-			if (!pFile)
-				printf("Cannot open CSV file %s\n", rdo_fname);
-			else
-			{
-				printf("Opened CSV file %s\n", rdo_fname);
-				break;
-			}
-		}
-
-		for (float q = .2f; q <= 10.0f; q += (q >= 1.0f ? .5f : .1f))
-		{
-			printf("Q: %f\n", q);
-
-			uastc_rdo_params p;
-			p.m_lambda = q;
-			p.m_max_allowed_rms_increase_ratio = 10.0f;
-			p.m_skip_block_rms_thresh = 8.0f;
-			
-			bool rdo_status = uastc_rdo((uint32_t)ublocks.size(), &ublocks[0], &orig_block_pixels[0], p, flags, &jpool, max_rdo_jobs);
-			if (!rdo_status)
-			{
-				printf("uastc_rdo() failed!\n");
-				return false;
-			}
-			for (uint32_t block_y = 0; block_y < num_blocks_y; block_y++)
-			{
-				for (uint32_t block_x = 0; block_x < num_blocks_x; block_x++)
-				{
-					const basist::uastc_block& blk = ublocks[block_x + block_y * num_blocks_x];
-
-					color_rgba unpacked_block[4][4];
-					if (!basist::unpack_uastc(blk, (basist::color32*)unpacked_block, false))
-					{
-						printf("Block unpack failed!\n");
-						exit(1);
-					}
-
-					rdo_uastc_img.set_block_clipped(&unpacked_block[0][0], block_x * 4, block_y * 4, 4, 4);
-
-					basist::bc7_optimization_results best_bc7_results;
-					transcode_uastc_to_bc7(blk, best_bc7_results);
-
-					basist::bc7_block bc7_data;
-					encode_bc7_block(&bc7_data, &best_bc7_results);
-
-					color_rgba decoded_bc7_blk[4][4];
-					unpack_block(texture_format::cBC7, &bc7_data, &decoded_bc7_blk[0][0]);
-
-					rdo_bc7_img.set_block_clipped(&decoded_bc7_blk[0][0], block_x * 4, block_y * 4, 4, 4);
-				}
-			}
-
-			image_metrics em;
-			em.calc(img, rdo_uastc_img, 0, 3);
-			em.print("RDOUASTC RGB ");
-
-			size_t comp_size = 0;
-			void* pComp_data = tdefl_compress_mem_to_heap(&ublocks[0], ublocks.size() * 16, &comp_size, TDEFL_MAX_PROBES_MASK);// TDEFL_DEFAULT_MAX_PROBES);
-
-			size_t decomp_size;
-			void* pDecomp_data = tinfl_decompress_mem_to_heap(pComp_data, comp_size, &decomp_size, 0);
-
-			if ((decomp_size != ublocks.size() * 16) || (memcmp(pDecomp_data, &ublocks[0], decomp_size) != 0))
-			{
-				printf("Compression or decompression failed!\n");
-				exit(1);
-			}
-
-			mz_free(pComp_data);
-			mz_free(pDecomp_data);
-
-			printf("RDO UASTC size: %u, compressed size: %u, %3.2f bits/texel\n",
-				(uint32_t)ublocks.size() * 16,
-				(uint32_t)comp_size,
-				comp_size * 8.0f / img.get_total_pixels());
-
-			if (pFile)
-				fprintf(pFile, "%f, %f, %f\n", q, comp_size * 8.0f / img.get_total_pixels(), em.m_psnr);
-		}
-		if (pFile)
-			fclose(pFile);
-		
-		{
-			size_t comp_size = 0;
-			void* pComp_data = tdefl_compress_mem_to_heap(&ublocks[0], ublocks.size() * 16, &comp_size, TDEFL_MAX_PROBES_MASK);// TDEFL_DEFAULT_MAX_PROBES);
-
-			size_t decomp_size;
-			void* pDecomp_data = tinfl_decompress_mem_to_heap(pComp_data, comp_size, &decomp_size, 0);
-
-			if ((decomp_size != ublocks.size() * 16) || (memcmp(pDecomp_data, &ublocks[0], decomp_size) != 0))
-			{
-				printf("Compression or decompression failed!\n");
-				exit(1);
-			}
-
-			mz_free(pComp_data);
-			mz_free(pDecomp_data);
-
-			printf("RDO UASTC size: %u, compressed size: %u, %3.2f bits/texel\n",
-				(uint32_t)ublocks.size() * 16,
-				(uint32_t)comp_size,
-				comp_size * 8.0f / img.get_total_pixels());
-
-			total_rdo_comp_size += comp_size;
-			total_rdo_raw_size += ublocks.size() * 16;
-			total_comp_blocks += ublocks.size();
-		}
-										
-		printf("Total blocks: %u\n", total_blocks);
-		printf("Total BC1 hint 0's: %u %3.1f%%\n", total_bc1_hint0s, total_bc1_hint0s * 100.0f / total_blocks);
-		printf("Total BC1 hint 1's: %u %3.1f%%\n", total_bc1_hint1s, total_bc1_hint1s * 100.0f / total_blocks);
-		printf("Total BC1 hint 01's: %u %3.1f%%\n", total_bc1_hint01s, total_bc1_hint01s * 100.0f / total_blocks);
-		printf("Total enc time per block: %f us\n", total_enc_time / total_blocks * 1000000.0f);
-		printf("Total bench time per block: %f us\n", total_bench_time / total_blocks * 1000000.0f);
-		printf("Total bench2 time per block: %f us\n", total_bench2_time / total_blocks * 1000000.0f);
-
-		overall_total_enc_time += total_enc_time;
-		overall_total_bench_time += total_bench_time;
-		overall_total_bench2_time += total_bench2_time;
-		overall_blocks += total_blocks;
-
-		printf("ETC1 inten hist: %u %u %u %u %u %u %u %u\n", etc1_inten_hist[0], etc1_inten_hist[1], etc1_inten_hist[2], etc1_inten_hist[3],
-			etc1_inten_hist[4], etc1_inten_hist[5], etc1_inten_hist[6], etc1_inten_hist[7]);
-		printf("ETC1 flip hist: %u %u\n", etc1_flip_hist[0], etc1_flip_hist[1]);
-		printf("ETC1 diff hist: %u %u\n", etc1_diff_hist[0], etc1_diff_hist[1]);
-
-		printf("UASTC mode histogram:\n");
-		uint64_t total_hist = 0;
-		for (uint32_t i = 0; i < basist::TOTAL_UASTC_MODES; i++)
-			total_hist += mode_hist[i];
-		for (uint32_t i = 0; i < basist::TOTAL_UASTC_MODES; i++)
-			printf("%u: %u %3.2f%%\n", i, (uint32_t)mode_hist[i], mode_hist[i] * 100.0f / total_hist);
-
-		char fn[256];
-
-#if 0
-		for (uint32_t y = 0; y < img.get_height(); y++)
-			for (uint32_t x = 0; x < img.get_width(); x++)
-			{
-				//static inline uint8_t to_5(uint32_t v) { ; }
-				color_rgba &c = img(x, y);
-
-				for (uint32_t i = 0; i < 3; i++)
-				{
-					const uint32_t limit = (i == 1) ? 63 : 31;
-
-					uint32_t v = c[i];
-					v = v * limit + 128; v = (uint8_t)((v + (v >> 8)) >> 8);
-					v = (v * 255 + (limit / 2)) / limit;
-
-					c[i] = (uint8_t)v;
-				}
-			
-			}
-#endif
-
-		sprintf(fn, "orig_%02u.png", image_index);
-		save_png(fn, img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "orig_a_%02u.png", image_index);
-		save_png(fn, img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_uastc_%02u.png", image_index);
-		save_png(fn, uastc_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_uastc_a_%02u.png", image_index);
-		save_png(fn, uastc_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_rdo_uastc_%02u.png", image_index);
-		save_png(fn, rdo_uastc_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_rdo_uastc_a_%02u.png", image_index);
-		save_png(fn, rdo_uastc_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_uastc2_%02u.png", image_index);
-		save_png(fn, uastc2_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_bc7_%02u.png", image_index);
-		save_png(fn, bc7_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_bc7_a_%02u.png", image_index);
-		save_png(fn, bc7_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_rdo_bc7_%02u.png", image_index);
-		save_png(fn, rdo_bc7_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_rdo_bc7_a_%02u.png", image_index);
-		save_png(fn, rdo_bc7_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_opt_bc7_%02u.png", image_index);
-		save_png(fn, opt_bc7_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_opt_bc7_a_%02u.png", image_index);
-		save_png(fn, opt_bc7_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_opt_astc_%02u.png", image_index);
-		save_png(fn, opt_astc_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_opt_astc_a_%02u.png", image_index);
-		save_png(fn, opt_astc_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_bc7enc_%02u.png", image_index);
-		save_png(fn, bc7enc_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_bc7enc_a_%02u.png", image_index);
-		save_png(fn, bc7enc_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "unpacked_opt_bc1_%02u.png", image_index);
-		save_png(fn, opt_bc1_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_opt_bc1_2_%02u.png", image_index);
-		save_png(fn, opt_bc1_2_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_tbc1_%02u.png", image_index);
-		save_png(fn, bc1_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_bc3_%02u.png", image_index);
-		save_png(fn, bc3_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_eac_r11_%02u.png", image_index);
-		save_png(fn, eac_r11_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_eac_rg11_%02u.png", image_index);
-		save_png(fn, eac_rg11_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_bc3_a_%02u.png", image_index);
-		save_png(fn, bc3_img, cImageSaveGrayscale, 3);
-
-		sprintf(fn, "part_vis_%02u.png", image_index);
-		save_png(fn, part_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_etc1_%02u.png", image_index);
-		save_png(fn, etc1_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_etc1_g_%02u.png", image_index);
-		save_png(fn, etc1_g_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_etc2_%02u.png", image_index);
-		save_png(fn, etc2_img, cImageSaveIgnoreAlpha);
-
-		sprintf(fn, "unpacked_etc2_a_%02u.png", image_index);
-		save_png(fn, etc2_img, cImageSaveGrayscale, 3);
-
-		image_metrics em;
-
-		// UASTC
-		em.calc(img, uastc_img, 0, 3);
-		em.print("UASTC RGB  ");
-		total_uastc_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, uastc_img, 3, 1);
-		em.print("UASTC A    ");
-		if (img_has_alpha)
-			total_uastc_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, uastc_img, 0, 4);
-		em.print("UASTC RGBA ");
-		total_uastc_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// RDO UASTC
-		em.calc(img, rdo_uastc_img, 0, 3);
-		em.print("RDOUASTC RGB ");
-		total_rdo_uastc_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, rdo_uastc_img, 3, 1);
-		em.print("RDOUASTC A ");
-		if (img_has_alpha)
-			total_rdo_uastc_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, rdo_uastc_img, 0, 4);
-		em.print("RDOUASTC RGBA ");
-		total_rdo_uastc_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// UASTC2 
-		em.calc(img, uastc2_img, 0, 3);
-		em.print("UASTC2 RGB ");
-		total_uastc2_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, uastc2_img, 3, 1);
-		em.print("UASTC2 A   ");
-		if (img_has_alpha)
-			total_uastc2_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, uastc2_img, 0, 4);
-		em.print("UASTC2 RGBA ");
-		total_uastc2_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// BC7
-		em.calc(img, bc7_img, 0, 3);
-		em.print("BC7 RGB    ");
-		total_bc7_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc7_img, 3, 1);
-		em.print("BC7 A      ");
-		if (img_has_alpha)
-			total_bc7_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc7_img, 0, 4);
-		em.print("BC7 RGBA   ");
-		total_bc7_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// RDO BC7
-		em.calc(img, rdo_bc7_img, 0, 3);
-		em.print("RDOBC7 RGB ");
-		total_rdo_bc7_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, rdo_bc7_img, 3, 1);
-		em.print("RDOBC7 A   ");
-		if (img_has_alpha)
-			total_rdo_bc7_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, rdo_bc7_img, 0, 4);
-		em.print("RDOBC7 RGBA ");
-		total_rdo_bc7_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-#if 0
-		// OBC7
-		em.calc(img, opt_bc7_img, 0, 3);
-		em.print("OBC7 RGB   ");
-		total_obc7_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, opt_bc7_img, 3, 1);
-		em.print("OBC7 A     ");
-		if (img_has_alpha)
-			total_obc7_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, opt_bc7_img, 0, 4);
-		em.print("OBC7 RGBA  ");
-		total_obc7_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// OASTC
-		em.calc(img, opt_astc_img, 0, 3);
-		em.print("OASTC RGB   ");
-		total_oastc_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, opt_astc_img, 3, 1);
-		em.print("OASTC A     ");
-		if (img_has_alpha)
-			total_oastc_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, opt_astc_img, 0, 4);
-		em.print("OASTC RGBA  ");
-		total_oastc_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-#endif
-
-		// bc7enc
-		em.calc(img, bc7enc_img, 0, 3);
-		em.print("BC7ENC RGB  ");
-		total_bc7enc_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc7enc_img, 3, 1);
-		em.print("BC7ENC A    ");
-		if (img_has_alpha)
-			total_bc7enc_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc7enc_img, 0, 4);
-		em.print("BC7ENC RGBA ");
-		total_bc7enc_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-#if 1
-		// OBC1
-		em.calc(img, opt_bc1_img, 0, 3);
-		em.print("OBC1 RGB   ");
-		total_obc1_psnr += basisu::minimum(99.0f, em.m_psnr);
-		total_obc1_psnr_sq += basisu::minimum(99.0f, em.m_psnr) * basisu::minimum(99.0f, em.m_psnr);
-#endif
-				
-		em.calc(img, opt_bc1_2_img, 0, 3);
-		em.print("OBC1 2 RGB ");
-		total_obc1_2_psnr += basisu::minimum(99.0f, em.m_psnr);
-		total_obc1_2_psnr_sq += basisu::minimum(99.0f, em.m_psnr) * basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc1_img, 0, 3);
-		em.print("BC1 RGB    ");
-		total_bc1_psnr += basisu::minimum(99.0f, em.m_psnr);
-		total_bc1_psnr_sq += basisu::minimum(99.0f, em.m_psnr) * basisu::minimum(99.0f, em.m_psnr);
-
-		// ETC1
-		em.calc(img, etc1_img, 0, 3);
-		em.print("ETC1 RGB   ");
-		total_etc1_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, etc1_img, 0, 0);
-		em.print("ETC1 Y     ");
-		total_etc1_y_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// ETC1
-		em.calc(img, etc1_g_img, 1, 1);
-		em.print("ETC1 G     ");
-		total_etc1_g_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// ETC2
-		em.calc(img, etc2_img, 0, 3);
-		em.print("ETC2 RGB   ");
-		total_etc2_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, etc2_img, 3, 1);
-		em.print("ETC2 A     ");
-		if (img_has_alpha)
-			total_etc2_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, etc2_img, 0, 4);
-		em.print("ETC2 RGBA  ");
-		total_etc2_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// BC3
-		em.calc(img, bc3_img, 0, 3);
-		em.print("BC3 RGB    ");
-		total_bc3_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc3_img, 3, 1);
-		em.print("BC3 A      ");
-		if (img_has_alpha)
-			total_bc3_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		em.calc(img, bc3_img, 0, 4);
-		em.print("BC3 RGBA   ");
-		total_bc3_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// EAC R11
-		em.calc(img, eac_r11_img, 0, 1);
-		em.print("EAC R11    ");
-		total_eac_r11_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		// EAC RG11
-		em.calc(img, eac_rg11_img, 0, 2);
-		em.print("EAC RG11   ");
-		total_eac_rg11_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-		const uint32_t width = num_blocks_x * 4;
-		const uint32_t height = num_blocks_y * 4;
-		if (is_pow2(width) && is_pow2(height))
-		{
-			pvrtc4_image pi(width, height);
-
-			transcode_uastc_to_pvrtc1_4_rgba(&ublocks[0], pi.get_blocks().get_ptr(), num_blocks_x, num_blocks_y, false);
-
-			pi.deswizzle();
-
-			//pi.map_all_pixels(img, perceptual, false);
-
-			image pi_unpacked;
-			pi.unpack_all_pixels(pi_unpacked);
-
-#if 0
-			sprintf(fn, "unpacked_pvrtc1_rgb_before_%02u.png", image_index);
-			save_png(fn, pi_unpacked, cImageSaveIgnoreAlpha);
-
-			em.calc(img, pi_unpacked, 0, 3);
-			em.print("PVRTC1 RGB Before ");
-
-			for (uint32_t pass = 0; pass < 1; pass++)
-			{
-				for (uint32_t by = 0; by < num_blocks_y; by++)
-				{
-					for (uint32_t bx = 0; bx < num_blocks_x; bx++)
-					{
-						pi.local_endpoint_optimization_opaque(bx, by, img, perceptual, false);
-					}
-				}
-			}
-
-			//pi.map_all_pixels(img, perceptual, false);
-
-			pi.unpack_all_pixels(pi_unpacked);
-#endif
-
-			sprintf(fn, "unpacked_pvrtc1_%02u.png", image_index);
-			save_png(fn, pi_unpacked, cImageSaveIgnoreAlpha);
-
-			sprintf(fn, "unpacked_pvrtc1_a_%02u.png", image_index);
-			save_png(fn, pi_unpacked, cImageSaveGrayscale, 3);
-
-			em.calc(img, pi_unpacked, 0, 3);
-			em.print("PVRTC1 After RGB  ");
-			total_pvrtc1_rgb_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-			em.calc(img, pi_unpacked, 3, 1);
-			em.print("PVRTC1 After A    ");
-			total_pvrtc1_a_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-			em.calc(img, pi_unpacked, 0, 4);
-			em.print("PVRTC1 After RGBA ");
-			total_pvrtc1_rgba_psnr += basisu::minimum(99.0f, em.m_psnr);
-
-			total_pvrtc1_images++;
-		}
-
-		printf("ETC1 hint histogram:\n");
-		for (uint32_t i = 0; i < 32; i++)
-			printf("%u ", etc1_hint_hist[i]);
-		printf("\n");
-
-		total_images++;
-		if (img_has_alpha)
-			total_a_images++;
-
-	} // image_index
-
-	printf("Total time: %f secs\n", otm.get_elapsed_secs());
-	
-	printf("Total Non-RDO UASTC size: %llu, compressed size: %llu, %3.2f bits/texel\n",
-		(unsigned long long)total_raw_size,
-		(unsigned long long)total_comp_size,
-		total_comp_size * 8.0f / (total_comp_blocks * 16));
-
-	printf("Total RDO UASTC size: %llu, compressed size: %llu, %3.2f bits/texel\n",
-		(unsigned long long)total_rdo_raw_size,
-		(unsigned long long)total_rdo_comp_size,
-		total_rdo_comp_size * 8.0f / (total_comp_blocks * 16));
-
-	printf("Overall enc time per block: %f us\n", overall_total_enc_time / overall_blocks * 1000000.0f);
-	printf("Overall bench time per block: %f us\n", overall_total_bench_time / overall_blocks * 1000000.0f);
-	printf("Overall bench2 time per block: %f us\n", overall_total_bench2_time / overall_blocks * 1000000.0f);
-
-	printf("Overall ASTC mode histogram:\n");
-	uint64_t total_hist = 0;
-	for (uint32_t i = 0; i < basist::TOTAL_UASTC_MODES; i++)
-		total_hist += overall_mode_hist[i];
-
-	for (uint32_t i = 0; i < basist::TOTAL_UASTC_MODES; i++)
-		printf("%u: %u %3.2f%%\n", i, (uint32_t)overall_mode_hist[i], overall_mode_hist[i] * 100.0f / total_hist);
-
-	printf("Total images: %u, total images with alpha: %u, total PVRTC1 images: %u\n", total_images, total_a_images, total_pvrtc1_images);
-
-	if (!total_a_images)
-		total_a_images = 1;
-
-	printf("Avg UASTC RGB PSNR:    %f, A PSNR: %f, RGBA PSNR: %f\n", total_uastc_psnr / total_images, total_uastc_a_psnr / total_a_images, total_uastc_rgba_psnr / total_images);
-	printf("Avg UASTC2 RGB PSNR:   %f, A PSNR: %f, RGBA PSNR: %f\n", total_uastc2_psnr / total_images, total_uastc2_a_psnr / total_a_images, total_uastc2_rgba_psnr / total_images);
-	printf("Avg RDO UASTC RGB PSNR: %f, A PSNR: %f, RGBA PSNR: %f\n", total_rdo_uastc_psnr / total_images, total_rdo_uastc_a_psnr / total_a_images, total_rdo_uastc_rgba_psnr / total_images);
-	printf("Avg BC7 RGB PSNR:      %f, A PSNR: %f, RGBA PSNR: %f\n", total_bc7_psnr / total_images, total_bc7_a_psnr / total_a_images, total_bc7_rgba_psnr / total_images);
-	printf("Avg RDO BC7 RGB PSNR:  %f, A PSNR: %f, RGBA PSNR: %f\n", total_rdo_bc7_psnr / total_images, total_rdo_bc7_a_psnr / total_a_images, total_rdo_bc7_rgba_psnr / total_images);
-	//printf("Avg Opt BC7 RGB PSNR:  %f, A PSNR: %f, RGBA PSNR: %f\n", total_obc7_psnr / total_images, total_obc7_a_psnr / total_a_images, total_obc7_rgba_psnr / total_images);
-	//printf("Avg Opt ASTC RGB PSNR: %f, A PSNR: %f, RGBA PSNR: %f\n", total_oastc_psnr / total_images, total_oastc_a_psnr / total_a_images, total_oastc_rgba_psnr / total_images);
-	printf("Avg BC7ENC RGB PSNR:   %f, A PSNR: %f, RGBA PSNR: %f\n", total_bc7enc_psnr / total_images, total_bc7enc_a_psnr / total_a_images, total_bc7enc_rgba_psnr / total_images);
-
-	printf("Avg Opt BC1 PSNR: %f, std dev: %f\n", total_obc1_psnr / total_images, sqrtf(basisu::maximum(0.0f, (total_obc1_psnr_sq / total_images) - (total_obc1_psnr / total_images) * (total_obc1_psnr / total_images))));
-
-	printf("Avg Opt BC1 2 PSNR: %f, std dev: %f\n", total_obc1_2_psnr / total_images, sqrtf(basisu::maximum(0.0f, (total_obc1_2_psnr_sq / total_images) - (total_obc1_2_psnr / total_images) * (total_obc1_2_psnr / total_images))));
-
-	printf("Avg BC1 PSNR: %f, std dev: %f\n", total_bc1_psnr / total_images, sqrtf(basisu::maximum(0.0f, (total_bc1_psnr_sq / total_images) - (total_bc1_psnr / total_images) * (total_bc1_psnr / total_images))));
-
-	printf("Avg ETC1 RGB PSNR: %f\n", total_etc1_psnr / total_images);
-	printf("Avg ETC1 Y PSNR: %f\n", total_etc1_y_psnr / total_images);
-	printf("Avg ETC1 G PSNR: %f\n", total_etc1_g_psnr / total_images);
-
-	printf("Avg ETC2 RGB PSNR: %f\n", total_etc2_psnr / total_images);
-	printf("Avg ETC2 A PSNR: %f\n", total_etc2_a_psnr / total_a_images);
-	printf("Avg ETC2 RGBA PSNR: %f\n", total_etc2_rgba_psnr / total_images);
-
-	printf("Avg BC3 RGB PSNR: %f\n", total_bc3_psnr / total_images);
-	printf("Avg BC3 A PSNR: %f\n", total_bc3_a_psnr / total_a_images);
-	printf("Avg BC3 RGBA PSNR: %f\n", total_bc3_rgba_psnr / total_images);
-
-	printf("Avg EAC R11 PSNR: %f\n", total_eac_r11_psnr / total_images);
-	printf("Avg EAC RG11 PSNR: %f\n", total_eac_rg11_psnr / total_images);
-
-	if (total_pvrtc1_images)
-	{
-		printf("Avg PVRTC1 RGB PSNR: %f\n", total_pvrtc1_rgb_psnr / total_pvrtc1_images);
-		printf("Avg PVRTC1 A PSNR: %f\n", total_pvrtc1_a_psnr / total_pvrtc1_images);
-		printf("Avg PVRTC1 RGBA PSNR: %f\n", total_pvrtc1_rgba_psnr / total_pvrtc1_images);
-	}
-
-	return true;
-}
-
 static uint32_t compute_miniz_compressed_size(const char* pFilename, uint32_t &orig_size)
 {
 	orig_size = 0;
@@ -3768,6 +2923,17 @@ static int main_internal(int argc, const char **argv)
 	if (!opts.process_listing_files())
 		return EXIT_FAILURE;
 
+	if (opts.m_trace_file.size())
+	{
+#if BASISU_ENABLE_TRACING
+		trace_recorder::get().set_enabled(true);
+		BASISU_TRACE_SET_THREAD_NAME("main");
+#else
+		error_printf("-trace requires a build with tracing enabled (BASISU_ENABLE_TRACING=1, or cmake -DTRACE=TRUE)\n");
+		return EXIT_FAILURE;
+#endif
+	}
+
 	if (opts.m_mode == cDefault)
 	{
 		for (size_t i = 0; i < opts.m_input_filenames.size(); i++)
@@ -3801,9 +2967,6 @@ static int main_internal(int argc, const char **argv)
 	case cVersion:
 		status = true; // We printed the version at the beginning of main_internal
 		break;
-	case cBench:
-		status = bench_mode(opts);
-		break;
 	case cCompSize:
 		status = compsize_mode(opts);
 		break;
@@ -3812,6 +2975,21 @@ static int main_internal(int argc, const char **argv)
 		break;
 	}
 
+#if BASISU_ENABLE_TRACING
+	if (opts.m_trace_file.size())
+	{
+		trace_recorder::get().set_enabled(false);
+
+		if (!trace_recorder::get().write_json(opts.m_trace_file.c_str()))
+		{
+			error_printf("Failed writing trace file \"%s\"\n", opts.m_trace_file.c_str());
+			status = false;
+		}
+		else
+			printf("Wrote trace file \"%s\"\n", opts.m_trace_file.c_str());
+	}
+#endif
+
 	return status ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
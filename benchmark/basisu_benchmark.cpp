@@ -0,0 +1,569 @@
+// basisu_benchmark.cpp
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Encoder/transcoder regression benchmark. Runs a deterministic synthetic corpus (plus any user supplied images) through each
+// encoder mode and level, then transcodes every output to every supported transcoder format. Reports throughput, latency
+// percentiles, the process's memory high water mark and quality, optionally as JSON for comparing CI runs.
+#include "basisu_benchmark_common.h"
+#include "../transcoder/basisu_global_selector_palette.h"
+#include <thread>
+
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "../encoder/basisu_miniz.h"
+
+using namespace basisu;
+
+struct bench_options
+{
+	bench_options() :
+		m_synthetic(true),
+		m_synthetic_size(512),
+		m_num_threads(0),
+		m_encode_reps(3),
+		m_transcode_reps(10),
+		m_transcode(true),
+		m_etc1s(true),
+		m_uastc(true),
+		m_rdo(true),
+		m_quality_level(128)
+	{
+		m_etc1s_levels.push_back(0);
+		m_etc1s_levels.push_back(1);
+		m_etc1s_levels.push_back(2);
+
+		m_uastc_levels.push_back(0);
+		m_uastc_levels.push_back(1);
+		m_uastc_levels.push_back(2);
+
+		m_rdo_lambdas.push_back(1.0f);
+		m_rdo_lambdas.push_back(3.0f);
+	}
+
+	bool m_synthetic;
+	uint32_t m_synthetic_size;
+	uint32_t m_num_threads;
+	uint32_t m_encode_reps;
+	uint32_t m_transcode_reps;
+	bool m_transcode;
+	bool m_etc1s, m_uastc, m_rdo;
+	int m_quality_level;
+	std::vector<int> m_etc1s_levels;
+	std::vector<int> m_uastc_levels;
+	std::vector<float> m_rdo_lambdas;
+	std::vector<std::string> m_input_filenames;
+	std::string m_json_filename;
+};
+
+struct bench_image
+{
+	std::string m_name;
+	image m_img;
+	bool m_normal_map;
+};
+
+struct encode_config
+{
+	std::string m_mode;
+	bool m_uastc;
+	int m_level;
+	bool m_rdo;
+	float m_rdo_lambda;
+};
+
+static void print_usage()
+{
+	printf("\nUsage: basisu_benchmark <options> [image files]\n"
+		"Runs a synthetic corpus and any given images through each encoder mode, then transcodes the output to every supported format.\n"
+		"\nOptions:\n"
+		" -no_synthetic: Don't include the built-in synthetic images\n"
+		" -synthetic_size X: Width/height of the synthetic images (default 512, should be a power of 2 for PVRTC1)\n"
+		" -threads X: Encoder thread count (default is the number of hardware threads)\n"
+		" -reps X: Number of timed encodes per configuration (default 3)\n"
+		" -transcode_reps X: Number of timed transcodes per format, after one warmup (default 10)\n"
+		" -no_transcode: Skip the transcoder benchmarks\n"
+		" -modes X: Comma separated list of encoder modes to run, from etc1s,uastc,rdo (default all)\n"
+		" -etc1s_levels X: Comma separated list of ETC1S compression levels (default 0,1,2)\n"
+		" -uastc_levels X: Comma separated list of UASTC levels (default 0,1,2)\n"
+		" -rdo_lambdas X: Comma separated list of UASTC RDO lambdas, run at UASTC level 1 (default 1,3)\n"
+		" -q X: ETC1S quality level (default 128)\n"
+		" -json X: Write the results to JSON file X\n");
+}
+
+static std::vector<std::string> split_list(const char* pStr)
+{
+	std::vector<std::string> res;
+	std::string cur;
+	for (const char* p = pStr; ; p++)
+	{
+		if ((*p == ',') || (!*p))
+		{
+			if (cur.size())
+				res.push_back(cur);
+			cur.clear();
+			if (!*p)
+				break;
+		}
+		else
+			cur += *p;
+	}
+	return res;
+}
+
+static bool parse_options(int argc, const char** argv, bench_options& opts)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* pArg = argv[i];
+		const bool has_value = (i + 1) < argc;
+
+		if (strcasecmp(pArg, "-no_synthetic") == 0)
+			opts.m_synthetic = false;
+		else if (strcasecmp(pArg, "-no_transcode") == 0)
+			opts.m_transcode = false;
+		else if ((strcasecmp(pArg, "-synthetic_size") == 0) && has_value)
+			opts.m_synthetic_size = clamp<int>(atoi(argv[++i]), 4, 16384);
+		else if ((strcasecmp(pArg, "-threads") == 0) && has_value)
+			opts.m_num_threads = clamp<int>(atoi(argv[++i]), 1, 256);
+		else if ((strcasecmp(pArg, "-reps") == 0) && has_value)
+			opts.m_encode_reps = clamp<int>(atoi(argv[++i]), 1, 1000);
+		else if ((strcasecmp(pArg, "-transcode_reps") == 0) && has_value)
+			opts.m_transcode_reps = clamp<int>(atoi(argv[++i]), 1, 100000);
+		else if ((strcasecmp(pArg, "-q") == 0) && has_value)
+			opts.m_quality_level = clamp<int>(atoi(argv[++i]), BASISU_QUALITY_MIN, BASISU_QUALITY_MAX);
+		else if ((strcasecmp(pArg, "-json") == 0) && has_value)
+			opts.m_json_filename = argv[++i];
+		else if ((strcasecmp(pArg, "-modes") == 0) && has_value)
+		{
+			opts.m_etc1s = opts.m_uastc = opts.m_rdo = false;
+
+			const std::vector<std::string> modes(split_list(argv[++i]));
+			for (size_t j = 0; j < modes.size(); j++)
+			{
+				if (strcasecmp(modes[j].c_str(), "etc1s") == 0)
+					opts.m_etc1s = true;
+				else if (strcasecmp(modes[j].c_str(), "uastc") == 0)
+					opts.m_uastc = true;
+				else if (strcasecmp(modes[j].c_str(), "rdo") == 0)
+					opts.m_rdo = true;
+				else
+				{
+					error_printf("Unknown mode \"%s\"\n", modes[j].c_str());
+					return false;
+				}
+			}
+		}
+		else if ((strcasecmp(pArg, "-etc1s_levels") == 0) && has_value)
+		{
+			const std::vector<std::string> l(split_list(argv[++i]));
+			opts.m_etc1s_levels.clear();
+			for (size_t j = 0; j < l.size(); j++)
+				opts.m_etc1s_levels.push_back(clamp<int>(atoi(l[j].c_str()), 0, BASISU_MAX_COMPRESSION_LEVEL));
+		}
+		else if ((strcasecmp(pArg, "-uastc_levels") == 0) && has_value)
+		{
+			const std::vector<std::string> l(split_list(argv[++i]));
+			opts.m_uastc_levels.clear();
+			for (size_t j = 0; j < l.size(); j++)
+				opts.m_uastc_levels.push_back(clamp<int>(atoi(l[j].c_str()), 0, TOTAL_PACK_UASTC_LEVELS - 1));
+		}
+		else if ((strcasecmp(pArg, "-rdo_lambdas") == 0) && has_value)
+		{
+			const std::vector<std::string> l(split_list(argv[++i]));
+			opts.m_rdo_lambdas.clear();
+			for (size_t j = 0; j < l.size(); j++)
+				opts.m_rdo_lambdas.push_back(clamp<float>((float)atof(l[j].c_str()), .001f, 100.0f));
+		}
+		else if (pArg[0] == '-')
+		{
+			error_printf("Unrecognized or incomplete option: %s\n", pArg);
+			return false;
+		}
+		else
+			opts.m_input_filenames.push_back(pArg);
+	}
+
+	return true;
+}
+
+static bool encode(const bench_image& img, const encode_config& cfg, const bench_options& opts, job_pool& jpool, const basist::etc1_global_selector_codebook& sel_codebook,
+	uint8_vec& output, bool& has_alpha)
+{
+	static const uint32_t s_uastc_level_flags[TOTAL_PACK_UASTC_LEVELS] = { cPackUASTCLevelFastest, cPackUASTCLevelFaster, cPackUASTCLevelDefault, cPackUASTCLevelSlower, cPackUASTCLevelVerySlow };
+
+	basis_compressor_params params;
+	params.m_source_images.push_back(img.m_img);
+	params.m_read_source_images = false;
+	params.m_write_output_basis_files = false;
+	params.m_status_output = false;
+	params.m_pSel_codebook = &sel_codebook;
+	params.m_pJob_pool = &jpool;
+	params.m_multithreading = jpool.get_total_threads() > 1;
+	params.m_perceptual = !img.m_normal_map;
+
+	params.m_uastc = cfg.m_uastc;
+	if (cfg.m_uastc)
+	{
+		params.m_pack_uastc_flags = (params.m_pack_uastc_flags & ~cPackUASTCLevelMask) | s_uastc_level_flags[cfg.m_level];
+		params.m_rdo_uastc = cfg.m_rdo;
+		if (cfg.m_rdo)
+			params.m_rdo_uastc_quality_scalar = cfg.m_rdo_lambda;
+	}
+	else
+	{
+		params.m_compression_level = cfg.m_level;
+		params.m_quality_level = opts.m_quality_level;
+	}
+
+	basis_compressor c;
+	if (!c.init(params))
+		return false;
+
+	if (c.process() != basis_compressor::cECSuccess)
+		return false;
+
+	output = c.get_output_basis_file();
+	has_alpha = c.get_any_source_image_has_alpha();
+	return true;
+}
+
+struct transcode_result
+{
+	basist::transcoder_texture_format m_fmt;
+	timing_stats m_secs;
+};
+
+struct encode_result
+{
+	std::string m_image_name;
+	uint32_t m_width, m_height;
+	encode_config m_cfg;
+	timing_stats m_secs;
+	uint32_t m_output_size;
+	uint32_t m_deflate_size;
+	bool m_has_alpha;
+	float m_rgb_psnr, m_luma709_psnr, m_alpha_psnr;
+	uint64_t m_peak_memory_usage;
+	std::vector<transcode_result> m_transcodes;
+};
+
+// UASTC .basis files aren't supercompressed, so RDO only pays off after LZ compression.
+static uint32_t get_deflate_size(const uint8_vec& data)
+{
+	size_t comp_size = 0;
+	void* pComp_data = buminiz::tdefl_compress_mem_to_heap(data.data(), data.size(), &comp_size, buminiz::TDEFL_MAX_PROBES_MASK);
+	buminiz::mz_free(pComp_data);
+	return (uint32_t)comp_size;
+}
+
+static bool compute_quality(const bench_image& img, const uint8_vec& basis_data, const basist::etc1_global_selector_codebook& sel_codebook, encode_result& res)
+{
+	basist::basisu_transcoder dec(&sel_codebook);
+	if (!dec.start_transcoding(basis_data.data(), (uint32_t)basis_data.size()))
+		return false;
+
+	const uint32_t width = img.m_img.get_width(), height = img.m_img.get_height();
+
+	transcode_target_buffer buf;
+	buf.init(basist::transcoder_texture_format::cTFRGBA32, width, height);
+	if (!buf.transcode(dec, basis_data, 0, 0))
+		return false;
+
+	image decoded(width, height);
+	memcpy(decoded.get_ptr(), buf.get_buf().data(), width * height * sizeof(color_rgba));
+
+	image_metrics em;
+	em.calc(img.m_img, decoded, 0, 3);
+	res.m_rgb_psnr = em.m_psnr;
+
+	em.calc(img.m_img, decoded, 0, 0);
+	res.m_luma709_psnr = em.m_psnr;
+
+	res.m_alpha_psnr = 0.0f;
+	if (res.m_has_alpha)
+	{
+		em.calc(img.m_img, decoded, 3, 1);
+		res.m_alpha_psnr = em.m_psnr;
+	}
+
+	return true;
+}
+
+static bool benchmark_transcodes(const uint8_vec& basis_data, uint32_t width, uint32_t height, const bench_options& opts, const basist::etc1_global_selector_codebook& sel_codebook, encode_result& res)
+{
+	basist::basisu_transcoder dec(&sel_codebook);
+	if (!dec.start_transcoding(basis_data.data(), (uint32_t)basis_data.size()))
+		return false;
+
+	const basist::basis_tex_format src_fmt = res.m_cfg.m_uastc ? basist::basis_tex_format::cUASTC4x4 : basist::basis_tex_format::cETC1S;
+
+	for (uint32_t fmt_index = 0; fmt_index < (uint32_t)basist::transcoder_texture_format::cTFTotalTextureFormats; fmt_index++)
+	{
+		const basist::transcoder_texture_format fmt = static_cast<basist::transcoder_texture_format>(fmt_index);
+		if (!is_benchmarkable_transcoder_format(fmt, src_fmt, width, height))
+			continue;
+
+		transcode_target_buffer buf;
+		buf.init(fmt, width, height);
+
+		basist::basisu_transcoder_state state;
+
+		// Warmup
+		if (!buf.transcode(dec, basis_data, 0, 0, &state))
+		{
+			error_printf("Transcode to %s failed\n", basist::basis_get_format_name(fmt));
+			return false;
+		}
+
+		std::vector<double> samples;
+		for (uint32_t rep = 0; rep < opts.m_transcode_reps; rep++)
+		{
+			interval_timer tm;
+			tm.start();
+			buf.transcode(dec, basis_data, 0, 0, &state);
+			samples.push_back(tm.get_elapsed_secs());
+		}
+
+		transcode_result tr;
+		tr.m_fmt = fmt;
+		tr.m_secs.compute(samples);
+		res.m_transcodes.push_back(tr);
+	}
+
+	return true;
+}
+
+static double get_mpix_per_sec(uint32_t width, uint32_t height, double secs) { return (secs > 0.0f) ? ((double)width * height / 1000000.0f / secs) : 0.0f; }
+static double get_blocks_per_sec(uint32_t width, uint32_t height, double secs) { return (secs > 0.0f) ? ((double)((width + 3) / 4) * ((height + 3) / 4) / secs) : 0.0f; }
+
+static std::string get_results_json(const std::vector<encode_result>& results, const bench_options& opts, uint32_t num_threads)
+{
+	std::string json("{\n");
+	json += string_format("  \"basisu_version\": \"%s\",\n", BASISU_LIB_VERSION_STRING);
+	json += string_format("  \"threads\": %u,\n", num_threads);
+	json += string_format("  \"encode_reps\": %u,\n", opts.m_encode_reps);
+	json += string_format("  \"transcode_reps\": %u,\n", opts.m_transcode_reps);
+	json += "  \"encodes\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const encode_result& r = results[i];
+		const double secs = r.m_secs.m_median;
+
+		json += "    {\n";
+		json += string_format("      \"image\": %s,\n", get_json_string(r.m_image_name).c_str());
+		json += string_format("      \"width\": %u,\n      \"height\": %u,\n", r.m_width, r.m_height);
+		json += string_format("      \"mode\": \"%s\",\n      \"level\": %i,\n", r.m_cfg.m_mode.c_str(), r.m_cfg.m_level);
+		json += string_format("      \"rdo_lambda\": %f,\n", r.m_cfg.m_rdo ? r.m_cfg.m_rdo_lambda : 0.0f);
+		json += string_format("      \"encode_secs\": %s,\n", r.m_secs.get_json().c_str());
+		json += string_format("      \"mpix_per_sec\": %f,\n", get_mpix_per_sec(r.m_width, r.m_height, secs));
+		json += string_format("      \"blocks_per_sec\": %f,\n", get_blocks_per_sec(r.m_width, r.m_height, secs));
+		json += string_format("      \"output_size\": %u,\n", r.m_output_size);
+		json += string_format("      \"bits_per_texel\": %f,\n", r.m_output_size * 8.0f / (r.m_width * r.m_height));
+		json += string_format("      \"deflate_size\": %u,\n", r.m_deflate_size);
+		json += string_format("      \"deflate_bits_per_texel\": %f,\n", r.m_deflate_size * 8.0f / (r.m_width * r.m_height));
+		json += string_format("      \"has_alpha\": %s,\n", r.m_has_alpha ? "true" : "false");
+		json += string_format("      \"rgb_psnr\": %f,\n      \"luma709_psnr\": %f,\n      \"alpha_psnr\": %f,\n", r.m_rgb_psnr, r.m_luma709_psnr, r.m_alpha_psnr);
+		json += string_format("      \"peak_memory_bytes\": %llu,\n", (unsigned long long)r.m_peak_memory_usage);
+		json += "      \"transcodes\": [\n";
+
+		for (size_t j = 0; j < r.m_transcodes.size(); j++)
+		{
+			const transcode_result& t = r.m_transcodes[j];
+			json += string_format("        { \"format\": \"%s\", \"secs\": %s, \"mpix_per_sec\": %f, \"blocks_per_sec\": %f }%s\n",
+				basist::basis_get_format_name(t.m_fmt), t.m_secs.get_json().c_str(),
+				get_mpix_per_sec(r.m_width, r.m_height, t.m_secs.m_median), get_blocks_per_sec(r.m_width, r.m_height, t.m_secs.m_median),
+				((j + 1) == r.m_transcodes.size()) ? "" : ",");
+		}
+
+		json += "      ]\n";
+		json += string_format("    }%s\n", ((i + 1) == results.size()) ? "" : ",");
+	}
+
+	json += "  ]\n}\n";
+	return json;
+}
+
+static int main_internal(int argc, const char** argv)
+{
+	printf("Basis Universal Benchmark v" BASISU_LIB_VERSION_STRING "\n");
+
+	basisu_encoder_init();
+
+	bench_options opts;
+	if (!parse_options(argc, argv, opts))
+	{
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<bench_image> corpus;
+
+	if (opts.m_synthetic)
+	{
+		for (uint32_t t = 0; t < cTotalSynthImageTypes; t++)
+		{
+			bench_image bi;
+			bi.m_name = get_synthetic_image_name((synthetic_image_type)t);
+			bi.m_normal_map = (t == cSynthNormalMap);
+			create_synthetic_image(bi.m_img, opts.m_synthetic_size, opts.m_synthetic_size, (synthetic_image_type)t, 1);
+			corpus.push_back(bi);
+		}
+	}
+
+	for (size_t i = 0; i < opts.m_input_filenames.size(); i++)
+	{
+		bench_image bi;
+		bi.m_name = opts.m_input_filenames[i];
+		bi.m_normal_map = false;
+		if (!load_image(opts.m_input_filenames[i].c_str(), bi.m_img))
+		{
+			error_printf("Failed loading image \"%s\"\n", opts.m_input_filenames[i].c_str());
+			return EXIT_FAILURE;
+		}
+		corpus.push_back(bi);
+	}
+
+	if (corpus.empty())
+	{
+		error_printf("Nothing to benchmark!\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<encode_config> configs;
+	if (opts.m_etc1s)
+	{
+		for (size_t i = 0; i < opts.m_etc1s_levels.size(); i++)
+		{
+			encode_config cfg = { "etc1s", false, opts.m_etc1s_levels[i], false, 0.0f };
+			configs.push_back(cfg);
+		}
+	}
+	if (opts.m_uastc)
+	{
+		for (size_t i = 0; i < opts.m_uastc_levels.size(); i++)
+		{
+			encode_config cfg = { "uastc", true, opts.m_uastc_levels[i], false, 0.0f };
+			configs.push_back(cfg);
+		}
+	}
+	if (opts.m_rdo)
+	{
+		for (size_t i = 0; i < opts.m_rdo_lambdas.size(); i++)
+		{
+			encode_config cfg = { "uastc_rdo", true, 1, true, opts.m_rdo_lambdas[i] };
+			configs.push_back(cfg);
+		}
+	}
+
+	uint32_t num_threads = opts.m_num_threads;
+	if (!num_threads)
+		num_threads = maximum<uint32_t>(1, std::thread::hardware_concurrency());
+
+	job_pool jpool(num_threads);
+
+	basist::etc1_global_selector_codebook sel_codebook(basist::g_global_selector_cb_size, basist::g_global_selector_cb);
+
+	printf("%u image(s), %u encoder configuration(s), %u thread(s)\n\n", (uint32_t)corpus.size(), (uint32_t)configs.size(), num_threads);
+	printf("%-24s %-10s %5s %6s %10s %10s %10s %12s %8s %8s %8s %8s\n", "Image", "Mode", "Level", "Lambda", "Median ms", "P90 ms", "Mpix/s", "Blocks/s", "Bits/tx", "LZ b/tx", "RGB dB", "Luma dB");
+
+	std::vector<encode_result> results;
+
+	for (size_t image_index = 0; image_index < corpus.size(); image_index++)
+	{
+		const bench_image& img = corpus[image_index];
+
+		for (size_t cfg_index = 0; cfg_index < configs.size(); cfg_index++)
+		{
+			const encode_config& cfg = configs[cfg_index];
+
+			encode_result res;
+			res.m_image_name = img.m_name;
+			res.m_width = img.m_img.get_width();
+			res.m_height = img.m_img.get_height();
+			res.m_cfg = cfg;
+
+			uint8_vec basis_data;
+			std::vector<double> samples;
+
+			for (uint32_t rep = 0; rep < opts.m_encode_reps; rep++)
+			{
+				interval_timer tm;
+				tm.start();
+
+				if (!encode(img, cfg, opts, jpool, sel_codebook, basis_data, res.m_has_alpha))
+				{
+					error_printf("Encode of \"%s\" mode %s level %i failed\n", img.m_name.c_str(), cfg.m_mode.c_str(), cfg.m_level);
+					return EXIT_FAILURE;
+				}
+
+				samples.push_back(tm.get_elapsed_secs());
+			}
+
+			res.m_secs.compute(samples);
+			res.m_output_size = (uint32_t)basis_data.size();
+			res.m_deflate_size = get_deflate_size(basis_data);
+			res.m_peak_memory_usage = get_peak_memory_usage();
+
+			if (!compute_quality(img, basis_data, sel_codebook, res))
+			{
+				error_printf("Failed decoding output of \"%s\" mode %s level %i\n", img.m_name.c_str(), cfg.m_mode.c_str(), cfg.m_level);
+				return EXIT_FAILURE;
+			}
+
+			printf("%-24s %-10s %5i %6.2f %10.3f %10.3f %10.3f %12.0f %8.3f %8.3f %8.3f %8.3f\n",
+				img.m_name.c_str(), cfg.m_mode.c_str(), cfg.m_level, cfg.m_rdo ? cfg.m_rdo_lambda : 0.0f,
+				res.m_secs.m_median * 1000.0f, res.m_secs.m_p90 * 1000.0f,
+				get_mpix_per_sec(res.m_width, res.m_height, res.m_secs.m_median), get_blocks_per_sec(res.m_width, res.m_height, res.m_secs.m_median),
+				res.m_output_size * 8.0f / (res.m_width * res.m_height), res.m_deflate_size * 8.0f / (res.m_width * res.m_height), res.m_rgb_psnr, res.m_luma709_psnr);
+
+			if (opts.m_transcode)
+			{
+				if (!benchmark_transcodes(basis_data, res.m_width, res.m_height, opts, sel_codebook, res))
+					return EXIT_FAILURE;
+
+				for (size_t i = 0; i < res.m_transcodes.size(); i++)
+				{
+					const transcode_result& t = res.m_transcodes[i];
+					printf("    %-22s median %9.3f ms, p90 %9.3f ms, %10.3f Mpix/s, %12.0f blocks/s\n", basist::basis_get_format_name(t.m_fmt),
+						t.m_secs.m_median * 1000.0f, t.m_secs.m_p90 * 1000.0f,
+						get_mpix_per_sec(res.m_width, res.m_height, t.m_secs.m_median), get_blocks_per_sec(res.m_width, res.m_height, t.m_secs.m_median));
+				}
+			}
+
+			results.push_back(res);
+		}
+	}
+
+	printf("\nPeak memory usage: %llu bytes\n", (unsigned long long)get_peak_memory_usage());
+
+	if (opts.m_json_filename.size())
+	{
+		const std::string json(get_results_json(results, opts, num_threads));
+		if (!write_data_to_file(opts.m_json_filename.c_str(), json.data(), json.size()))
+		{
+			error_printf("Failed writing JSON file \"%s\"\n", opts.m_json_filename.c_str());
+			return EXIT_FAILURE;
+		}
+		printf("Wrote JSON file \"%s\"\n", opts.m_json_filename.c_str());
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, const char** argv)
+{
+	return main_internal(argc, argv);
+}
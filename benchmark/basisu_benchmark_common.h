@@ -0,0 +1,312 @@
+// basisu_benchmark_common.h
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Helpers shared by the benchmark executables: deterministic synthetic images, timing statistics, JSON output and transcoding helpers.
+#pragma once
+#include "../encoder/basisu_enc.h"
+#include "../encoder/basisu_comp.h"
+#include "../transcoder/basisu_transcoder.h"
+#include <vector>
+
+namespace basisu
+{
+	// Deterministic PRNG (splitmix64). Unlike the std:: distributions used by basisu::rand its output is identical with every compiler and
+	// standard library, so the synthetic corpus is the same everywhere.
+	class bench_rand
+	{
+	public:
+		bench_rand(uint64_t seed) : m_state(seed) { }
+
+		uint64_t next()
+		{
+			uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		// between [l,h]
+		int irand(int l, int h) { return l + (int)(next() % (uint64_t)(h - l + 1)); }
+
+		// between [0,1)
+		float frand() { return (float)(next() >> 40) * (1.0f / 16777216.0f); }
+
+	private:
+		uint64_t m_state;
+	};
+
+	enum synthetic_image_type
+	{
+		cSynthSmooth,		// smooth gradients and low frequency detail, photo-like
+		cSynthNoise,		// uniform random noise, worst case for every codec
+		cSynthText,			// high contrast rectangles and lines on a flat background, UI/text-like
+		cSynthAlpha,		// smooth color with a soft, partially noisy alpha channel
+		cSynthNormalMap,	// tangent space normal map generated from a height field
+		cTotalSynthImageTypes
+	};
+
+	inline const char* get_synthetic_image_name(synthetic_image_type t)
+	{
+		switch (t)
+		{
+		case cSynthSmooth: return "synth_smooth";
+		case cSynthNoise: return "synth_noise";
+		case cSynthText: return "synth_text";
+		case cSynthAlpha: return "synth_alpha";
+		case cSynthNormalMap: return "synth_normalmap";
+		default: break;
+		}
+		return "?";
+	}
+
+	inline void create_synthetic_image(image& img, uint32_t width, uint32_t height, synthetic_image_type t, uint64_t seed)
+	{
+		bench_rand r(seed * 0x100000001B3ULL + (uint64_t)t);
+
+		img.resize(width, height);
+
+		const float fw = (float)width, fh = (float)height;
+
+		// A few random low frequency sine components shared by the smooth/alpha/normal map types
+		float freq[4][2], phase[4];
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			freq[i][0] = (1.0f + r.frand() * 6.0f) * 6.2831853f / fw;
+			freq[i][1] = (1.0f + r.frand() * 6.0f) * 6.2831853f / fh;
+			phase[i] = r.frand() * 6.2831853f;
+		}
+
+		switch (t)
+		{
+		case cSynthSmooth:
+		case cSynthAlpha:
+		{
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const float gx = x / fw, gy = y / fh;
+
+					float c[3];
+					for (uint32_t i = 0; i < 3; i++)
+						c[i] = .5f + .25f * sinf(x * freq[i][0] + y * freq[i][1] + phase[i]) + .25f * (i == 0 ? gx : (i == 1 ? gy : (1.0f - gx)));
+
+					const float n = (r.frand() - .5f) * (4.0f / 255.0f);
+
+					color_rgba& p = img(x, y);
+					p.r = (uint8_t)clamp<int>((int)((c[0] + n) * 255.0f + .5f), 0, 255);
+					p.g = (uint8_t)clamp<int>((int)((c[1] + n) * 255.0f + .5f), 0, 255);
+					p.b = (uint8_t)clamp<int>((int)((c[2] + n) * 255.0f + .5f), 0, 255);
+					p.a = 255;
+
+					if (t == cSynthAlpha)
+					{
+						const float dx = gx - .5f, dy = gy - .5f;
+						float a = 1.0f - sqrtf(dx * dx + dy * dy) * 2.0f;
+						if (x < width / 4)
+							a += (r.frand() - .5f) * .5f;
+						p.a = (uint8_t)clamp<int>((int)(a * 255.0f + .5f), 0, 255);
+					}
+				}
+			}
+			break;
+		}
+		case cSynthNoise:
+		{
+			for (uint32_t y = 0; y < height; y++)
+				for (uint32_t x = 0; x < width; x++)
+					img(x, y).set((uint8_t)r.irand(0, 255), (uint8_t)r.irand(0, 255), (uint8_t)r.irand(0, 255), 255);
+			break;
+		}
+		case cSynthText:
+		{
+			img.set_all(color_rgba(240, 240, 235, 255));
+
+			const uint32_t total_rects = (width * height) / 256;
+			for (uint32_t i = 0; i < total_rects; i++)
+			{
+				const int rw = r.irand(1, 12), rh = r.irand(1, 12);
+				const int rx = r.irand(0, width - 1), ry = r.irand(0, height - 1);
+				const color_rgba c = r.irand(0, 3) ? color_rgba(20, 20, 25, 255) : color_rgba((uint8_t)r.irand(0, 255), (uint8_t)r.irand(0, 255), (uint8_t)r.irand(0, 255), 255);
+				img.fill_box(rx, ry, rw, rh, c);
+			}
+			break;
+		}
+		case cSynthNormalMap:
+		{
+			for (uint32_t y = 0; y < height; y++)
+			{
+				for (uint32_t x = 0; x < width; x++)
+				{
+					// Analytic gradient of the height field sum(sin(f.p + phase))
+					float dx = 0.0f, dy = 0.0f;
+					for (uint32_t i = 0; i < 4; i++)
+					{
+						const float c = cosf(x * freq[i][0] + y * freq[i][1] + phase[i]);
+						dx += c * freq[i][0] * fw * .02f;
+						dy += c * freq[i][1] * fh * .02f;
+					}
+
+					vec3F n(-dx, -dy, 1.0f);
+					n.normalize_in_place();
+
+					img(x, y).set((uint8_t)clamp<int>((int)((n[0] * .5f + .5f) * 255.0f + .5f), 0, 255),
+						(uint8_t)clamp<int>((int)((n[1] * .5f + .5f) * 255.0f + .5f), 0, 255),
+						(uint8_t)clamp<int>((int)((n[2] * .5f + .5f) * 255.0f + .5f), 0, 255), 255);
+				}
+			}
+			break;
+		}
+		default:
+			assert(0);
+			break;
+		}
+	}
+
+	// Order statistics over a set of timing samples (in seconds). Percentiles use the nearest rank method.
+	struct timing_stats
+	{
+		double m_min, m_max, m_mean, m_median, m_p90, m_p99;
+		uint32_t m_num_samples;
+
+		timing_stats() { clear(); }
+
+		void clear()
+		{
+			m_min = m_max = m_mean = m_median = m_p90 = m_p99 = 0.0f;
+			m_num_samples = 0;
+		}
+
+		void compute(std::vector<double> samples)
+		{
+			clear();
+			if (samples.empty())
+				return;
+
+			std::sort(samples.begin(), samples.end());
+
+			m_num_samples = (uint32_t)samples.size();
+			m_min = samples.front();
+			m_max = samples.back();
+
+			double sum = 0.0f;
+			for (size_t i = 0; i < samples.size(); i++)
+				sum += samples[i];
+			m_mean = sum / samples.size();
+
+			m_median = get_percentile(samples, 50.0f);
+			m_p90 = get_percentile(samples, 90.0f);
+			m_p99 = get_percentile(samples, 99.0f);
+		}
+
+		static double get_percentile(const std::vector<double>& sorted_samples, float p)
+		{
+			const size_t n = sorted_samples.size();
+			size_t rank = (size_t)ceil((p / 100.0f) * n);
+			rank = clamp<size_t>(rank, 1, n);
+			return sorted_samples[rank - 1];
+		}
+
+		std::string get_json() const
+		{
+			return string_format("{ \"min\": %.9f, \"median\": %.9f, \"mean\": %.9f, \"p90\": %.9f, \"p99\": %.9f, \"max\": %.9f, \"samples\": %u }",
+				m_min, m_median, m_mean, m_p90, m_p99, m_max, m_num_samples);
+		}
+	};
+
+	inline std::string get_json_string(const std::string& str)
+	{
+		std::string res("\"");
+		for (size_t i = 0; i < str.size(); i++)
+		{
+			const char c = str[i];
+			if ((c == '"') || (c == '\\'))
+			{
+				res += '\\';
+				res += c;
+			}
+			else if ((uint8_t)c < 32)
+				res += string_format("\\u%04X", (uint8_t)c);
+			else
+				res += c;
+		}
+		res += "\"";
+		return res;
+	}
+
+	// Returns true if level 0 of a file with the given dimensions can be transcoded to fmt. BC7_ALT is an alias kept for backwards
+	// compatibility and PVRTC1 requires power of 2 dimensions.
+	inline bool is_benchmarkable_transcoder_format(basist::transcoder_texture_format fmt, basist::basis_tex_format src_fmt, uint32_t width, uint32_t height)
+	{
+		if (fmt == basist::transcoder_texture_format::cTFBC7_ALT)
+			return false;
+
+		if (!basist::basis_is_format_supported(fmt, src_fmt))
+			return false;
+
+		if ((fmt == basist::transcoder_texture_format::cTFPVRTC1_4_RGB) || (fmt == basist::transcoder_texture_format::cTFPVRTC1_4_RGBA))
+		{
+			if ((!is_pow2(width)) || (!is_pow2(height)))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Output buffer big enough for one image level of the given dimensions in any transcoder format.
+	class transcode_target_buffer
+	{
+	public:
+		bool init(basist::transcoder_texture_format fmt, uint32_t width, uint32_t height)
+		{
+			m_fmt = fmt;
+			m_width = width;
+			m_height = height;
+
+			if (basist::basis_transcoder_format_is_uncompressed(fmt))
+			{
+				m_buf.resize(width * height * basist::basis_get_uncompressed_bytes_per_pixel(fmt));
+				m_size_in_blocks_or_pixels = width * height;
+			}
+			else
+			{
+				const uint32_t block_width = basist::basis_get_block_width(fmt), block_height = 4;
+				const uint32_t total_blocks = ((width + block_width - 1) / block_width) * ((height + block_height - 1) / block_height);
+				m_buf.resize(total_blocks * basist::basis_get_bytes_per_block_or_pixel(fmt));
+				m_size_in_blocks_or_pixels = total_blocks;
+			}
+
+			return m_buf.size() != 0;
+		}
+
+		bool transcode(basist::basisu_transcoder& dec, const uint8_vec& file_data, uint32_t image_index, uint32_t level_index, basist::basisu_transcoder_state* pState = nullptr)
+		{
+			const bool uncompressed = basist::basis_transcoder_format_is_uncompressed(m_fmt);
+
+			return dec.transcode_image_level(file_data.data(), (uint32_t)file_data.size(), image_index, level_index,
+				m_buf.data(), m_size_in_blocks_or_pixels, m_fmt, 0,
+				uncompressed ? m_width : 0, pState, uncompressed ? m_height : 0);
+		}
+
+		uint8_vec& get_buf() { return m_buf; }
+
+	private:
+		basist::transcoder_texture_format m_fmt;
+		uint32_t m_width, m_height;
+		uint32_t m_size_in_blocks_or_pixels;
+		uint8_vec m_buf;
+	};
+
+} // namespace basisu
@@ -0,0 +1,296 @@
+// basisu_transcoder_benchmark.cpp
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Transcoder microbenchmark. Encodes deterministic synthetic ETC1S and UASTC textures in memory at several sizes, then times
+// transcode_image_level() for every (source format, target format) pair. Throughput is reported per source 4x4 block.
+#include "basisu_benchmark_common.h"
+#include "../transcoder/basisu_global_selector_palette.h"
+#include <thread>
+
+using namespace basisu;
+
+struct transcoder_bench_options
+{
+	transcoder_bench_options() :
+		m_warmup_reps(2),
+		m_reps(20),
+		m_alpha(true),
+		m_etc1s(true),
+		m_uastc(true)
+	{
+		m_sizes.push_back(128);
+		m_sizes.push_back(512);
+		m_sizes.push_back(1024);
+	}
+
+	std::vector<uint32_t> m_sizes;
+	uint32_t m_warmup_reps;
+	uint32_t m_reps;
+	bool m_alpha;
+	bool m_etc1s, m_uastc;
+	std::string m_json_filename;
+};
+
+struct pair_result
+{
+	basist::basis_tex_format m_src_fmt;
+	basist::transcoder_texture_format m_dst_fmt;
+	uint32_t m_size;
+	uint32_t m_total_blocks;
+	timing_stats m_secs;
+};
+
+static void print_usage()
+{
+	printf("\nUsage: basisu_transcoder_benchmark <options>\n"
+		"Times transcoding of synthetic ETC1S and UASTC textures to every supported transcoder format.\n"
+		"\nOptions:\n"
+		" -sizes X: Comma separated list of texture widths/heights (default 128,512,1024, should be powers of 2 for PVRTC1)\n"
+		" -warmup X: Untimed transcodes per pair before timing (default 2)\n"
+		" -reps X: Timed transcodes per pair (default 20)\n"
+		" -no_alpha: Use an opaque source texture (by default the source has an alpha channel)\n"
+		" -etc1s_only: Only benchmark ETC1S sources\n"
+		" -uastc_only: Only benchmark UASTC sources\n"
+		" -json X: Write the results to JSON file X\n");
+}
+
+static bool parse_options(int argc, const char** argv, transcoder_bench_options& opts)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* pArg = argv[i];
+		const bool has_value = (i + 1) < argc;
+
+		if ((strcasecmp(pArg, "-sizes") == 0) && has_value)
+		{
+			opts.m_sizes.clear();
+
+			std::string cur;
+			for (const char* p = argv[++i]; ; p++)
+			{
+				if ((*p == ',') || (!*p))
+				{
+					if (cur.size())
+						opts.m_sizes.push_back(clamp<int>(atoi(cur.c_str()), 4, 16384));
+					cur.clear();
+					if (!*p)
+						break;
+				}
+				else
+					cur += *p;
+			}
+		}
+		else if ((strcasecmp(pArg, "-warmup") == 0) && has_value)
+			opts.m_warmup_reps = clamp<int>(atoi(argv[++i]), 0, 1000);
+		else if ((strcasecmp(pArg, "-reps") == 0) && has_value)
+			opts.m_reps = clamp<int>(atoi(argv[++i]), 1, 1000000);
+		else if (strcasecmp(pArg, "-no_alpha") == 0)
+			opts.m_alpha = false;
+		else if (strcasecmp(pArg, "-etc1s_only") == 0)
+			opts.m_uastc = false;
+		else if (strcasecmp(pArg, "-uastc_only") == 0)
+			opts.m_etc1s = false;
+		else if ((strcasecmp(pArg, "-json") == 0) && has_value)
+			opts.m_json_filename = argv[++i];
+		else
+		{
+			error_printf("Unrecognized or incomplete option: %s\n", pArg);
+			return false;
+		}
+	}
+
+	if (opts.m_sizes.empty())
+	{
+		error_printf("No sizes specified\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool encode_source(const image& img, bool uastc, const basist::etc1_global_selector_codebook& sel_codebook, job_pool& jpool, uint8_vec& output)
+{
+	basis_compressor_params params;
+	params.m_source_images.push_back(img);
+	params.m_read_source_images = false;
+	params.m_write_output_basis_files = false;
+	params.m_status_output = false;
+	params.m_pSel_codebook = &sel_codebook;
+	params.m_pJob_pool = &jpool;
+	params.m_multithreading = jpool.get_total_threads() > 1;
+	params.m_uastc = uastc;
+
+	if (uastc)
+		params.m_pack_uastc_flags = (params.m_pack_uastc_flags & ~cPackUASTCLevelMask) | cPackUASTCLevelFastest;
+	else
+	{
+		params.m_compression_level = 1;
+		params.m_quality_level = 128;
+	}
+
+	basis_compressor c;
+	if (!c.init(params))
+		return false;
+
+	if (c.process() != basis_compressor::cECSuccess)
+		return false;
+
+	output = c.get_output_basis_file();
+	return true;
+}
+
+static std::string get_results_json(const std::vector<pair_result>& results, const transcoder_bench_options& opts)
+{
+	std::string json("{\n");
+	json += string_format("  \"basisu_version\": \"%s\",\n", BASISU_LIB_VERSION_STRING);
+	json += string_format("  \"warmup_reps\": %u,\n  \"reps\": %u,\n", opts.m_warmup_reps, opts.m_reps);
+	json += string_format("  \"alpha\": %s,\n", opts.m_alpha ? "true" : "false");
+	json += "  \"results\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const pair_result& r = results[i];
+		const double secs = r.m_secs.m_median;
+
+		json += string_format("    { \"source\": \"%s\", \"target\": \"%s\", \"size\": %u, \"blocks\": %u, \"secs\": %s, \"blocks_per_sec\": %f, \"ns_per_block\": %f }%s\n",
+			(r.m_src_fmt == basist::basis_tex_format::cUASTC4x4) ? "UASTC" : "ETC1S", basist::basis_get_format_name(r.m_dst_fmt), r.m_size, r.m_total_blocks,
+			r.m_secs.get_json().c_str(), (secs > 0.0f) ? (r.m_total_blocks / secs) : 0.0f, secs * 1e+9f / r.m_total_blocks,
+			((i + 1) == results.size()) ? "" : ",");
+	}
+
+	json += "  ]\n}\n";
+	return json;
+}
+
+static int main_internal(int argc, const char** argv)
+{
+	printf("Basis Universal Transcoder Benchmark v" BASISU_LIB_VERSION_STRING "\n");
+
+	basisu_encoder_init();
+
+	transcoder_bench_options opts;
+	if (!parse_options(argc, argv, opts))
+	{
+		print_usage();
+		return EXIT_FAILURE;
+	}
+
+	basist::etc1_global_selector_codebook sel_codebook(basist::g_global_selector_cb_size, basist::g_global_selector_cb);
+
+	job_pool jpool(maximum<uint32_t>(1, std::thread::hardware_concurrency()));
+
+	std::vector<pair_result> results;
+
+	printf("%-6s %-16s %6s %10s %12s %12s %12s\n", "Source", "Target", "Size", "Blocks", "Median ms", "Blocks/s", "ns/block");
+
+	for (uint32_t uastc = 0; uastc < 2; uastc++)
+	{
+		if ((uastc && !opts.m_uastc) || (!uastc && !opts.m_etc1s))
+			continue;
+
+		const basist::basis_tex_format src_fmt = uastc ? basist::basis_tex_format::cUASTC4x4 : basist::basis_tex_format::cETC1S;
+
+		for (size_t size_index = 0; size_index < opts.m_sizes.size(); size_index++)
+		{
+			const uint32_t size = opts.m_sizes[size_index];
+			const uint32_t total_blocks = ((size + 3) / 4) * ((size + 3) / 4);
+
+			image img;
+			create_synthetic_image(img, size, size, opts.m_alpha ? cSynthAlpha : cSynthSmooth, 1);
+
+			uint8_vec basis_data;
+			if (!encode_source(img, uastc != 0, sel_codebook, jpool, basis_data))
+			{
+				error_printf("Failed encoding %ux%u %s source texture\n", size, size, uastc ? "UASTC" : "ETC1S");
+				return EXIT_FAILURE;
+			}
+
+			basist::basisu_transcoder dec(&sel_codebook);
+			if (!dec.start_transcoding(basis_data.data(), (uint32_t)basis_data.size()))
+			{
+				error_printf("start_transcoding() failed\n");
+				return EXIT_FAILURE;
+			}
+
+			for (uint32_t fmt_index = 0; fmt_index < (uint32_t)basist::transcoder_texture_format::cTFTotalTextureFormats; fmt_index++)
+			{
+				const basist::transcoder_texture_format fmt = static_cast<basist::transcoder_texture_format>(fmt_index);
+				if (!is_benchmarkable_transcoder_format(fmt, src_fmt, size, size))
+					continue;
+
+				transcode_target_buffer buf;
+				buf.init(fmt, size, size);
+
+				basist::basisu_transcoder_state state;
+
+				for (uint32_t rep = 0; rep < opts.m_warmup_reps; rep++)
+				{
+					if (!buf.transcode(dec, basis_data, 0, 0, &state))
+					{
+						error_printf("Transcode to %s failed\n", basist::basis_get_format_name(fmt));
+						return EXIT_FAILURE;
+					}
+				}
+
+				std::vector<double> samples;
+				samples.reserve(opts.m_reps);
+
+				for (uint32_t rep = 0; rep < opts.m_reps; rep++)
+				{
+					interval_timer tm;
+					tm.start();
+
+					if (!buf.transcode(dec, basis_data, 0, 0, &state))
+					{
+						error_printf("Transcode to %s failed\n", basist::basis_get_format_name(fmt));
+						return EXIT_FAILURE;
+					}
+
+					samples.push_back(tm.get_elapsed_secs());
+				}
+
+				pair_result r;
+				r.m_src_fmt = src_fmt;
+				r.m_dst_fmt = fmt;
+				r.m_size = size;
+				r.m_total_blocks = total_blocks;
+				r.m_secs.compute(samples);
+				results.push_back(r);
+
+				const double secs = r.m_secs.m_median;
+				printf("%-6s %-16s %6u %10u %12.4f %12.0f %12.2f\n", uastc ? "UASTC" : "ETC1S", basist::basis_get_format_name(fmt), size, total_blocks,
+					secs * 1000.0f, (secs > 0.0f) ? (total_blocks / secs) : 0.0f, secs * 1e+9f / total_blocks);
+			}
+		}
+	}
+
+	if (opts.m_json_filename.size())
+	{
+		const std::string json(get_results_json(results, opts));
+		if (!write_data_to_file(opts.m_json_filename.c_str(), json.data(), json.size()))
+		{
+			error_printf("Failed writing JSON file \"%s\"\n", opts.m_json_filename.c_str());
+			return EXIT_FAILURE;
+		}
+		printf("Wrote JSON file \"%s\"\n", opts.m_json_filename.c_str());
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, const char** argv)
+{
+	return main_internal(argc, argv);
+}
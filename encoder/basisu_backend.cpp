@@ -81,6 +81,8 @@ namespace basisu
 
 	void basisu_backend::create_endpoint_palette()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::create_endpoint_palette", "backend");
+
 		const basisu_frontend& r = *m_pFront_end;
 
 		m_output.m_num_endpoints = r.get_total_endpoint_clusters();
@@ -100,6 +102,8 @@ namespace basisu
 
 	void basisu_backend::create_selector_palette()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::create_selector_palette", "backend");
+
 		const basisu_frontend& r = *m_pFront_end;
 
 		m_output.m_num_selectors = r.get_total_selector_clusters();
@@ -454,6 +458,8 @@ namespace basisu
 
 	void basisu_backend::create_encoder_blocks()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::create_encoder_blocks", "backend");
+
 		basisu_frontend& r = *m_pFront_end;
 		const bool is_video = r.get_params().m_tex_type == basist::cBASISTexTypeVideoFrames;
 
@@ -710,6 +716,8 @@ namespace basisu
 	// TODO: Split this into multiple methods.
 	bool basisu_backend::encode_image()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::encode_image", "backend");
+
 		basisu_frontend& r = *m_pFront_end;
 		const bool is_video = r.get_params().m_tex_type == basist::cBASISTexTypeVideoFrames;
 
@@ -1380,6 +1388,8 @@ namespace basisu
 
 	bool basisu_backend::encode_endpoint_palette()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::encode_endpoint_palette", "backend");
+
 		const basisu_frontend& r = *m_pFront_end;
 
 		// The endpoint indices may have been changed by the backend's RDO step, so go and figure out which ones are actually used again.
@@ -1553,6 +1563,8 @@ namespace basisu
 
 	bool basisu_backend::encode_selector_palette()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::encode_selector_palette", "backend");
+
 		const basisu_frontend& r = *m_pFront_end;
 
 		if ((m_params.m_use_global_sel_codebook) && (!m_params.m_use_hybrid_sel_codebooks))
@@ -1773,6 +1785,8 @@ namespace basisu
 
 	uint32_t basisu_backend::encode()
 	{
+		BASISU_TRACE_SCOPE("basisu_backend::encode", "backend");
+
 		//const bool is_video = m_pFront_end->get_params().m_tex_type == basist::cBASISTexTypeVideoFrames;
 		m_output.m_slice_desc = m_slices;
 		m_output.m_etc1s = m_params.m_etc1s;
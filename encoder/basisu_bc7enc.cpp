@@ -14,6 +14,11 @@
 // limitations under the License.
 #include "basisu_bc7enc.h"
 
+#if BASISU_SUPPORT_SSE
+#define CPPSPMD_NAME(a) a##_sse41
+#include "basisu_kernels_declares.h"
+#endif
+
 #ifdef _DEBUG
 #define BC7ENC_CHECK_OVERALL_ERROR 1
 #else
@@ -895,6 +900,13 @@ static uint64_t evaluate_solution(const color_quad_u8 *pLow, const color_quad_u8
 			pResults->m_pSelectors_temp[i] = sel;
 		}
 	}
+#if BASISU_SUPPORT_SSE
+	else if ((!pParams->m_perceptual) && (g_cpu_supports_sse41) && (maximum(pParams->m_weights[0], pParams->m_weights[1], pParams->m_weights[2], pParams->m_weights[3]) < 8192))
+	{
+		find_selectors_linear_projected_N_sse41(&total_err, pResults->m_pSelectors_temp, (const color_rgba*)weightedColors, N, 
+			(const color_rgba*)pParams->m_pPixels, pParams->m_num_pixels, pParams->m_weights, pParams->m_has_alpha != 0);
+	}
+#endif
 	else if (!pParams->m_perceptual)
 	{
 		if (pParams->m_has_alpha)
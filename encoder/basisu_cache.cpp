@@ -0,0 +1,520 @@
+// basisu_cache.cpp
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "basisu_cache.h"
+#include <algorithm>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace basisu
+{
+	static const uint64_t HASH128_PRIME0 = 0x9E3779B185EBCA87ULL;
+	static const uint64_t HASH128_PRIME1 = 0xC2B2AE3D27D4EB4FULL;
+	static const uint64_t HASH128_PRIME2 = 0x165667B19E3779F9ULL;
+
+	static inline uint64_t rotl64(uint64_t v, uint32_t s) { return (v << s) | (v >> (64 - s)); }
+
+	static inline uint64_t read_le_qword(const uint8_t* pBytes)
+	{
+		return (uint64_t)read_le_dword(pBytes) | ((uint64_t)read_le_dword(pBytes + 4) << 32U);
+	}
+
+	static inline void write_le_qword(uint8_t* pBytes, uint64_t val)
+	{
+		write_le_dword(pBytes, (uint32_t)val);
+		write_le_dword(pBytes + 4, (uint32_t)(val >> 32U));
+	}
+
+	static inline uint64_t fmix64(uint64_t k)
+	{
+		k ^= k >> 33;
+		k *= 0xFF51AFD7ED558CCDULL;
+		k ^= k >> 33;
+		k *= 0xC4CEB9FE1A85EC53ULL;
+		k ^= k >> 33;
+		return k;
+	}
+
+	std::string hash128::get_string() const
+	{
+		return string_format("%08X%08X%08X%08X", (uint32_t)(m_hi >> 32), (uint32_t)m_hi, (uint32_t)(m_lo >> 32), (uint32_t)m_lo);
+	}
+
+	void hash128_builder::clear()
+	{
+		m_h0 = HASH128_PRIME2;
+		m_h1 = HASH128_PRIME1 ^ HASH128_PRIME0;
+		m_total_len = 0;
+		m_buf_size = 0;
+	}
+
+	void hash128_builder::add_word(uint64_t w)
+	{
+		m_h0 ^= rotl64(w * HASH128_PRIME1, 31) * HASH128_PRIME0;
+		m_h0 = rotl64(m_h0, 27) * HASH128_PRIME0 + HASH128_PRIME2;
+
+		m_h1 += w * HASH128_PRIME2;
+		m_h1 = rotl64(m_h1, 29) * HASH128_PRIME1;
+		m_h1 ^= m_h0;
+	}
+
+	void hash128_builder::add(const void* pData, size_t len)
+	{
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		m_total_len += len;
+
+		if (m_buf_size)
+		{
+			const size_t n = minimum<size_t>(len, 8 - m_buf_size);
+			memcpy(m_buf + m_buf_size, pBytes, n);
+			m_buf_size += (uint32_t)n;
+			pBytes += n;
+			len -= n;
+
+			if (m_buf_size < 8)
+				return;
+			
+			add_word(read_le_qword(m_buf));
+			m_buf_size = 0;
+		}
+
+		while (len >= 8)
+		{
+			add_word(read_le_qword(pBytes));
+			pBytes += 8;
+			len -= 8;
+		}
+
+		if (len)
+		{
+			memcpy(m_buf, pBytes, len);
+			m_buf_size = (uint32_t)len;
+		}
+	}
+
+	void hash128_builder::add_u32(uint32_t v)
+	{
+		uint8_t buf[4];
+		write_le_dword(buf, v);
+		add(buf, sizeof(buf));
+	}
+
+	void hash128_builder::add_u64(uint64_t v)
+	{
+		uint8_t buf[8];
+		write_le_qword(buf, v);
+		add(buf, sizeof(buf));
+	}
+
+	void hash128_builder::add_float(float v)
+	{
+		uint32_t u;
+		memcpy(&u, &v, sizeof(u));
+		add_u32(u);
+	}
+
+	hash128 hash128_builder::get_hash() const
+	{
+		uint64_t h0 = m_h0, h1 = m_h1;
+
+		uint64_t tail = 0;
+		for (uint32_t i = 0; i < m_buf_size; i++)
+			tail |= ((uint64_t)m_buf[i]) << (i * 8);
+
+		h0 ^= fmix64(tail ^ m_total_len);
+		h1 ^= fmix64(tail + HASH128_PRIME0) ^ m_total_len;
+
+		h0 += h1;
+		h1 += h0;
+
+		h0 = fmix64(h0);
+		h1 = fmix64(h1);
+
+		h0 += h1;
+		h1 += h0;
+
+		return hash128(h0, h1);
+	}
+
+	// On-disk entry layout: a 48 byte header followed by the payload bytes.
+	const uint32_t ENCODE_CACHE_ENTRY_MAGIC = 0x45435542; // "BUCE"
+	const uint32_t ENCODE_CACHE_ENTRY_VERSION = 1;
+	static const char* const s_encode_cache_entry_ext = ".bcache";
+	static const char* const s_encode_cache_temp_ext = ".tmp";
+
+	// Temporary files older than this are assumed to be left over from a crashed writer.
+	const int64_t ENCODE_CACHE_STALE_TEMP_FILE_SECS = 60 * 60;
+
+	// All fields are little endian.
+	enum
+	{
+		cEncodeCacheHdrMagicOfs = 0,
+		cEncodeCacheHdrVersionOfs = 4,
+		cEncodeCacheHdrKeyOfs = 8,
+		cEncodeCacheHdrPayloadSizeOfs = 24,
+		cEncodeCacheHdrPayloadHashOfs = 32,
+		cEncodeCacheHdrSize = 48
+	};
+
+	static hash128 hash_payload(const uint8_t* pData, size_t len)
+	{
+		hash128_builder hasher;
+		hasher.add(pData, len);
+		return hasher.get_hash();
+	}
+
+	static bool create_directory(const char* pDir)
+	{
+#ifdef _WIN32
+		if (_mkdir(pDir) == 0)
+			return true;
+#else
+		if (mkdir(pDir, 0777) == 0)
+			return true;
+#endif
+		return errno == EEXIST;
+	}
+
+	static bool is_directory(const char* pDir)
+	{
+#ifdef _WIN32
+		struct _stat64 s;
+		if (_stat64(pDir, &s) != 0)
+			return false;
+		return (s.st_mode & _S_IFDIR) != 0;
+#else
+		struct stat s;
+		if (stat(pDir, &s) != 0)
+			return false;
+		return S_ISDIR(s.st_mode);
+#endif
+	}
+
+	static void touch_file(const char* pFilename)
+	{
+#ifdef _WIN32
+		_utime(pFilename, nullptr);
+#else
+		utime(pFilename, nullptr);
+#endif
+	}
+
+	static bool replace_file(const char* pSrc_filename, const char* pDst_filename)
+	{
+#ifdef _WIN32
+		return MoveFileExA(pSrc_filename, pDst_filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		return rename(pSrc_filename, pDst_filename) == 0;
+#endif
+	}
+
+	static uint32_t get_process_id()
+	{
+#ifdef _WIN32
+		return (uint32_t)_getpid();
+#else
+		return (uint32_t)getpid();
+#endif
+	}
+
+	struct encode_cache_file
+	{
+		std::string m_filename;
+		uint64_t m_size;
+		int64_t m_mod_time;
+		bool m_temp;
+
+		bool operator< (const encode_cache_file& rhs) const
+		{
+			if (m_mod_time != rhs.m_mod_time)
+				return m_mod_time < rhs.m_mod_time;
+			return m_filename < rhs.m_filename;
+		}
+	};
+
+	// Lists the cache entries and temporary files in a cache directory. Anything else in the directory is left alone.
+	static void list_cache_files(const std::string& dir, std::vector<encode_cache_file>& files)
+	{
+		files.resize(0);
+
+		const std::string entry_ext(s_encode_cache_entry_ext);
+		const std::string temp_ext(s_encode_cache_temp_ext);
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA find_data;
+		HANDLE hFind = FindFirstFileA((dir + "\\*").c_str(), &find_data);
+		if (hFind == INVALID_HANDLE_VALUE)
+			return;
+
+		do
+		{
+			if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+				continue;
+
+			const std::string name(find_data.cFileName);
+			const bool is_entry = (name.size() > entry_ext.size()) && (name.compare(name.size() - entry_ext.size(), entry_ext.size(), entry_ext) == 0);
+			const bool is_temp = (name.size() > temp_ext.size()) && (name.compare(name.size() - temp_ext.size(), temp_ext.size(), temp_ext) == 0);
+			if ((!is_entry) && (!is_temp))
+				continue;
+
+			encode_cache_file f;
+			string_combine_path(f.m_filename, dir.c_str(), name.c_str());
+			f.m_size = ((uint64_t)find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+
+			// FILETIME is in 100ns units since 1601, convert to seconds since the Unix epoch.
+			const uint64_t ft = ((uint64_t)find_data.ftLastWriteTime.dwHighDateTime << 32) | find_data.ftLastWriteTime.dwLowDateTime;
+			f.m_mod_time = (int64_t)(ft / 10000000ULL) - 11644473600LL;
+			f.m_temp = is_temp;
+			files.push_back(f);
+
+		} while (FindNextFileA(hFind, &find_data));
+
+		FindClose(hFind);
+#else
+		DIR* pDir = opendir(dir.c_str());
+		if (!pDir)
+			return;
+
+		struct dirent* pEntry;
+		while ((pEntry = readdir(pDir)) != nullptr)
+		{
+			const std::string name(pEntry->d_name);
+			const bool is_entry = (name.size() > entry_ext.size()) && (name.compare(name.size() - entry_ext.size(), entry_ext.size(), entry_ext) == 0);
+			const bool is_temp = (name.size() > temp_ext.size()) && (name.compare(name.size() - temp_ext.size(), temp_ext.size(), temp_ext) == 0);
+			if ((!is_entry) && (!is_temp))
+				continue;
+
+			encode_cache_file f;
+			string_combine_path(f.m_filename, dir.c_str(), name.c_str());
+
+			// The file may have been evicted by another process since readdir() returned it.
+			struct stat s;
+			if (stat(f.m_filename.c_str(), &s) != 0)
+				continue;
+			if (!S_ISREG(s.st_mode))
+				continue;
+
+			f.m_size = (uint64_t)s.st_size;
+			f.m_mod_time = (int64_t)s.st_mtime;
+			f.m_temp = is_temp;
+			files.push_back(f);
+		}
+
+		closedir(pDir);
+#endif
+	}
+
+	encode_cache::encode_cache() :
+		m_max_size(0)
+	{
+	}
+
+	bool encode_cache::init(const char* pDir, uint64_t max_size_in_bytes)
+	{
+		m_dir.clear();
+		m_max_size = max_size_in_bytes;
+
+		if ((!pDir) || (!pDir[0]))
+			return false;
+
+		std::string dir(pDir);
+		while ((dir.size() > 1) && (is_path_separator(dir.back())))
+			dir.erase(dir.size() - 1, 1);
+
+		if (!is_directory(dir.c_str()))
+		{
+			// Another process may create it at the same time, which is fine.
+			create_directory(dir.c_str());
+
+			if (!is_directory(dir.c_str()))
+			{
+				error_printf("encode_cache::init: Failed creating cache directory \"%s\"\n", dir.c_str());
+				return false;
+			}
+		}
+
+		m_dir = dir;
+
+		return true;
+	}
+
+	std::string encode_cache::get_entry_filename(const hash128& key) const
+	{
+		std::string filename;
+		string_combine_path(filename, m_dir.c_str(), (key.get_string() + s_encode_cache_entry_ext).c_str());
+		return filename;
+	}
+
+	bool encode_cache::get(const hash128& key, uint8_vec& data)
+	{
+		data.resize(0);
+
+		if (!is_valid())
+			return false;
+
+		const std::string filename(get_entry_filename(key));
+
+		uint8_vec file_data;
+		if (!read_file_to_vec(filename.c_str(), file_data))
+			return false;
+
+		if (file_data.size() < cEncodeCacheHdrSize)
+		{
+			debug_printf("encode_cache::get: Entry \"%s\" is truncated\n", filename.c_str());
+			return false;
+		}
+
+		const uint8_t* pHdr = file_data.data();
+
+		if ((read_le_dword(pHdr + cEncodeCacheHdrMagicOfs) != ENCODE_CACHE_ENTRY_MAGIC) || (read_le_dword(pHdr + cEncodeCacheHdrVersionOfs) != ENCODE_CACHE_ENTRY_VERSION))
+			return false;
+
+		if (hash128(read_le_qword(pHdr + cEncodeCacheHdrKeyOfs), read_le_qword(pHdr + cEncodeCacheHdrKeyOfs + 8)) != key)
+			return false;
+
+		const uint64_t payload_size = read_le_qword(pHdr + cEncodeCacheHdrPayloadSizeOfs);
+		if (payload_size != (file_data.size() - cEncodeCacheHdrSize))
+		{
+			debug_printf("encode_cache::get: Entry \"%s\" has an invalid size\n", filename.c_str());
+			return false;
+		}
+
+		const uint8_t* pPayload = file_data.data() + cEncodeCacheHdrSize;
+		if (hash_payload(pPayload, (size_t)payload_size) != hash128(read_le_qword(pHdr + cEncodeCacheHdrPayloadHashOfs), read_le_qword(pHdr + cEncodeCacheHdrPayloadHashOfs + 8)))
+		{
+			debug_printf("encode_cache::get: Entry \"%s\" failed its payload hash check\n", filename.c_str());
+			return false;
+		}
+
+		data.resize((size_t)payload_size);
+		if (payload_size)
+			memcpy(data.data(), pPayload, (size_t)payload_size);
+
+		// Mark the entry as recently used.
+		touch_file(filename.c_str());
+
+		return true;
+	}
+
+	bool encode_cache::put(const hash128& key, const uint8_vec& data)
+	{
+		if (!is_valid())
+			return false;
+
+		const hash128 payload_hash(hash_payload(data.data(), data.size()));
+
+		uint8_vec file_data(cEncodeCacheHdrSize);
+		uint8_t* pHdr = file_data.data();
+		write_le_dword(pHdr + cEncodeCacheHdrMagicOfs, ENCODE_CACHE_ENTRY_MAGIC);
+		write_le_dword(pHdr + cEncodeCacheHdrVersionOfs, ENCODE_CACHE_ENTRY_VERSION);
+		write_le_qword(pHdr + cEncodeCacheHdrKeyOfs, key.m_lo);
+		write_le_qword(pHdr + cEncodeCacheHdrKeyOfs + 8, key.m_hi);
+		write_le_qword(pHdr + cEncodeCacheHdrPayloadSizeOfs, data.size());
+		write_le_qword(pHdr + cEncodeCacheHdrPayloadHashOfs, payload_hash.m_lo);
+		write_le_qword(pHdr + cEncodeCacheHdrPayloadHashOfs + 8, payload_hash.m_hi);
+
+		append_vector(file_data, data);
+
+		// The temporary filename must be unique across processes and threads sharing this cache directory.
+		static std::atomic<uint32_t> s_temp_counter;
+		const uint32_t counter = s_temp_counter++;
+		const uint32_t thread_hash = (uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+
+		std::string temp_filename;
+		string_combine_path(temp_filename, m_dir.c_str(),
+			string_format("%s.%X_%X_%X_%X%s", key.get_string().c_str(), get_process_id(), thread_hash, counter, (uint32_t)time(nullptr), s_encode_cache_temp_ext).c_str());
+
+		if (!write_vec_to_file(temp_filename.c_str(), file_data))
+		{
+			error_printf("encode_cache::put: Failed writing cache file \"%s\"\n", temp_filename.c_str());
+			remove(temp_filename.c_str());
+			return false;
+		}
+
+		const std::string filename(get_entry_filename(key));
+		if (!replace_file(temp_filename.c_str(), filename.c_str()))
+		{
+			// Most likely another process is replacing or reading the same entry, which will have identical contents.
+			debug_printf("encode_cache::put: Failed renaming \"%s\" to \"%s\"\n", temp_filename.c_str(), filename.c_str());
+			remove(temp_filename.c_str());
+			return false;
+		}
+
+		evict();
+
+		return true;
+	}
+
+	void encode_cache::evict()
+	{
+		if ((!is_valid()) || (!m_max_size))
+			return;
+
+		std::vector<encode_cache_file> files;
+		list_cache_files(m_dir, files);
+
+		const int64_t cur_time = (int64_t)time(nullptr);
+
+		uint64_t total_size = 0;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			if (files[i].m_temp)
+			{
+				if ((cur_time - files[i].m_mod_time) > ENCODE_CACHE_STALE_TEMP_FILE_SECS)
+				{
+					debug_printf("encode_cache::evict: Removing stale temporary file \"%s\"\n", files[i].m_filename.c_str());
+					remove(files[i].m_filename.c_str());
+				}
+				continue;
+			}
+
+			total_size += files[i].m_size;
+		}
+
+		if (total_size <= m_max_size)
+			return;
+
+		std::sort(files.begin(), files.end());
+
+		for (size_t i = 0; (i < files.size()) && (total_size > m_max_size); i++)
+		{
+			if (files[i].m_temp)
+				continue;
+
+			debug_printf("encode_cache::evict: Evicting \"%s\"\n", files[i].m_filename.c_str());
+
+			// Failure here usually means another process already evicted it.
+			remove(files[i].m_filename.c_str());
+
+			total_size -= files[i].m_size;
+		}
+	}
+
+} // namespace basisu
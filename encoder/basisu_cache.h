@@ -0,0 +1,96 @@
+// basisu_cache.h
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+#include "basisu_enc.h"
+
+namespace basisu
+{
+	// 128-bit non-cryptographic hash, used to key the on-disk encode cache.
+	struct hash128
+	{
+		uint64_t m_lo, m_hi;
+
+		hash128() : m_lo(0), m_hi(0) { }
+		hash128(uint64_t lo, uint64_t hi) : m_lo(lo), m_hi(hi) { }
+
+		bool operator== (const hash128& rhs) const { return (m_lo == rhs.m_lo) && (m_hi == rhs.m_hi); }
+		bool operator!= (const hash128& rhs) const { return !(*this == rhs); }
+
+		std::string get_string() const;
+	};
+
+	// Incremental two-lane 64-bit hasher. Values are fed in as little endian bytes, so keys are stable across platforms.
+	class hash128_builder
+	{
+	public:
+		hash128_builder() { clear(); }
+
+		void clear();
+
+		void add(const void* pData, size_t len);
+
+		void add_u8(uint8_t v) { add(&v, sizeof(v)); }
+		void add_u32(uint32_t v);
+		void add_u64(uint64_t v);
+		void add_int(int v) { add_u32((uint32_t)v); }
+		void add_bool(bool v) { add_u8(v ? 1 : 0); }
+		void add_float(float v);
+		void add_string(const std::string& s) { add_u64(s.size()); add(s.data(), s.size()); }
+
+		hash128 get_hash() const;
+
+	private:
+		uint64_t m_h0, m_h1, m_total_len;
+		uint8_t m_buf[8];
+		uint32_t m_buf_size;
+
+		void add_word(uint64_t w);
+	};
+
+	// Content-addressed, size-bounded on-disk cache of compressed output files.
+	// Multiple processes may share a cache directory: entries are written to a unique temporary file then atomically renamed into place,
+	// readers validate each entry's header and payload hash (a torn or stale entry is just a cache miss), and eviction tolerates concurrent deletes.
+	// LRU ordering uses each entry's modification time, which is refreshed on every hit.
+	class encode_cache
+	{
+		BASISU_NO_EQUALS_OR_COPY_CONSTRUCT(encode_cache);
+
+	public:
+		encode_cache();
+
+		// max_size_in_bytes==0 disables eviction.
+		bool init(const char* pDir, uint64_t max_size_in_bytes);
+
+		bool is_valid() const { return m_dir.size() != 0; }
+
+		const std::string& get_dir() const { return m_dir; }
+
+		// Returns true and fills in data on a hit.
+		bool get(const hash128& key, uint8_vec& data);
+
+		// Adds (or replaces) the entry for key, then evicts the least recently used entries until the cache fits in its size budget.
+		bool put(const hash128& key, const uint8_vec& data);
+
+		// Deletes the least recently used entries (and abandoned temporary files) until the total size is below the size budget.
+		void evict();
+
+	private:
+		std::string m_dir;
+		uint64_t m_max_size;
+
+		std::string get_entry_filename(const hash128& key) const;
+	};
+
+} // namespace basisu
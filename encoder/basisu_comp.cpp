@@ -49,7 +49,9 @@ namespace basisu
 		m_basis_bits_per_texel(0.0f),
 		m_total_blocks(0),
 		m_auto_global_sel_pal(false),
-		m_any_source_image_has_alpha(false)
+		m_any_source_image_has_alpha(false),
+		m_streamed_output_file_size(0),
+		m_cache_hit(false)
 	{
 		debug_printf("basis_compressor::basis_compressor\n");
 	}
@@ -105,6 +107,7 @@ namespace basisu
 				m_params.m_swizzle[2],
 				m_params.m_swizzle[3]);
 			PRINT_BOOL_VALUE(m_renormalize);
+			PRINT_BOOL_VALUE(m_high_precision_source);
 			PRINT_BOOL_VALUE(m_multithreading);
 			PRINT_BOOL_VALUE(m_disable_hierarchical_endpoint_codebooks);
 			
@@ -133,6 +136,7 @@ namespace basisu
 			debug_printf("m_tex_type: %u\n", m_params.m_tex_type);
 			debug_printf("m_userdata0: 0x%X, m_userdata1: 0x%X\n", m_params.m_userdata0, m_params.m_userdata1);
 			debug_printf("m_us_per_frame: %i (%f fps)\n", m_params.m_us_per_frame, m_params.m_us_per_frame ? 1.0f / (m_params.m_us_per_frame / 1000000.0f) : 0);
+			debug_printf("m_video_iframe_interval: %u\n", m_params.m_video_iframe_interval);
 			debug_printf("m_pack_uastc_flags: 0x%X\n", m_params.m_pack_uastc_flags);
 			
 			PRINT_BOOL_VALUE(m_rdo_uastc);
@@ -144,6 +148,9 @@ namespace basisu
 			PRINT_FLOAT_VALUE(m_rdo_uastc_smooth_block_max_std_dev);
 			PRINT_BOOL_VALUE(m_rdo_uastc_favor_simpler_modes_in_rdo_mode)
 			PRINT_BOOL_VALUE(m_rdo_uastc_multithreading);
+			PRINT_FLOAT_VALUE(m_rdo_uastc_target_bitrate);
+			PRINT_INT_VALUE(m_rdo_uastc_target_size);
+			PRINT_BOOL_VALUE(m_rdo_uastc_zstd_cost_model);
 
 			PRINT_INT_VALUE(m_resample_width);
 			PRINT_INT_VALUE(m_resample_height);
@@ -165,6 +172,13 @@ namespace basisu
 				debug_printf("Key: \"%s\"\n", m_params.m_ktx2_key_values[i].m_key.data());
 				debug_printf("Value size: %u\n", m_params.m_ktx2_key_values[i].m_value.size());
 			}
+
+			PRINT_BOOL_VALUE(m_uastc_streaming);
+			PRINT_INT_VALUE(m_uastc_streaming_strip_height);
+
+			debug_printf("m_validation_mode: %u\n", m_params.m_validation_mode);
+
+			debug_printf("Encode cache dir: \"%s\", max size: %llu\n", m_params.m_cache_dir.c_str(), (unsigned long long)m_params.m_cache_max_size);
 						
 #undef PRINT_BOOL_VALUE
 #undef PRINT_INT_VALUE
@@ -183,10 +197,81 @@ namespace basisu
 		
 	basis_compressor::error_code basis_compressor::process()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::process", "comp");
+
 		debug_printf("basis_compressor::process\n");
 
-		if (!read_source_images())
-			return cECFailedReadingSourceImages;
+		m_perf_stats.clear();
+
+		scoped_phase_timer total_timer(m_perf_stats.m_total, m_params.m_pJob_pool);
+		
+		error_code ec = process_internal();
+
+		total_timer.stop();
+
+		m_perf_stats.m_total_threads = m_params.m_pJob_pool ? (uint32_t)m_params.m_pJob_pool->get_total_threads() : 1;
+		m_perf_stats.m_peak_memory_usage = get_peak_memory_usage();
+		m_perf_stats.m_total_slices = (uint32_t)m_slice_descs.size();
+		m_perf_stats.m_total_blocks = m_total_blocks;
+		m_perf_stats.m_cache_hit = m_cache_hit;
+		if (m_params.m_uastc_streaming)
+			m_perf_stats.m_output_file_size = m_streamed_output_file_size;
+		else
+			m_perf_stats.m_output_file_size = m_params.m_create_ktx2_file ? m_output_ktx2_file.size() : m_output_basis_file.size();
+
+		if ((!m_params.m_uastc) && (!m_cache_hit))
+		{
+			m_perf_stats.m_frontend_steps = m_frontend.get_timings();
+			m_perf_stats.m_total_endpoint_clusters = m_frontend.get_total_endpoint_clusters();
+			m_perf_stats.m_total_selector_clusters = m_frontend.get_total_selector_clusters();
+		}
+
+		debug_printf("basis_compressor::process: Total time: %3.3f secs, CPU time: %3.3f secs, thread utilization: %3.1f%%, peak memory: %llu bytes\n",
+			m_perf_stats.m_total.m_wall_time, m_perf_stats.m_total.m_cpu_time,
+			m_perf_stats.m_total.get_thread_utilization(m_perf_stats.m_total_threads) * 100.0f,
+			(unsigned long long)m_perf_stats.m_peak_memory_usage);
+
+		return ec;
+	}
+
+	basis_compressor::error_code basis_compressor::process_internal()
+	{
+		m_cache_hit = false;
+		m_streamed_output_file_size = 0;
+
+		if (m_params.m_uastc_streaming)
+			return process_uastc_streaming();
+
+		// Stats and debug images need the intermediate data, so they always run the full pipeline.
+		bool use_cache = (m_params.m_cache_dir.size() != 0) && (!m_params.m_compute_stats) && (!m_params.m_debug_images);
+		if (use_cache)
+		{
+			scoped_phase_timer t(m_perf_stats.m_cache_lookup);
+
+			use_cache = m_cache.init(m_params.m_cache_dir.c_str(), m_params.m_cache_max_size) && compute_cache_key(m_cache_key);
+
+			if ((use_cache) && (read_from_cache()))
+			{
+				t.stop();
+
+				m_cache_hit = true;
+
+				if (m_params.m_status_output)
+					printf("Encode cache hit, key %s\n", m_cache_key.get_string().c_str());
+
+				scoped_phase_timer wt(m_perf_stats.m_write_output, m_params.m_pJob_pool);
+				if (!write_output_files_and_compute_stats())
+					return cECFailedWritingOutput;
+
+				return cECSuccess;
+			}
+		}
+
+		{
+			scoped_phase_timer t(m_perf_stats.m_read_source_images, m_params.m_pJob_pool);
+			if (!read_source_images())
+				return cECFailedReadingSourceImages;
+		}
 
 		if (!validate_texture_type_constraints())
 			return cECFailedValidating;
@@ -197,8 +282,11 @@ namespace basisu
 				return cECFailedValidating;
 		}
 
-		if (!extract_source_blocks())
-			return cECFailedFrontEnd;
+		{
+			scoped_phase_timer t(m_perf_stats.m_extract_source_blocks, m_params.m_pJob_pool);
+			if (!extract_source_blocks())
+				return cECFailedFrontEnd;
+		}
 
 		if (m_params.m_uastc)
 		{
@@ -208,14 +296,23 @@ namespace basisu
 		}
 		else
 		{
-			if (!process_frontend())
-				return cECFailedFrontEnd;
+			{
+				scoped_phase_timer t(m_perf_stats.m_frontend, m_params.m_pJob_pool);
+				if (!process_frontend())
+					return cECFailedFrontEnd;
+			}
 
-			if (!extract_frontend_texture_data())
-				return cECFailedFontendExtract;
+			{
+				scoped_phase_timer t(m_perf_stats.m_frontend_extract, m_params.m_pJob_pool);
+				if (!extract_frontend_texture_data())
+					return cECFailedFontendExtract;
+			}
 
-			if (!process_backend())
-				return cECFailedBackend;
+			{
+				scoped_phase_timer t(m_perf_stats.m_backend, m_params.m_pJob_pool);
+				if (!process_backend())
+					return cECFailedBackend;
+			}
 		}
 
 		if (!create_basis_file_and_transcode())
@@ -223,138 +320,1027 @@ namespace basisu
 		
 		if (m_params.m_create_ktx2_file)
 		{
+			scoped_phase_timer t(m_perf_stats.m_create_ktx2_file, m_params.m_pJob_pool);
 			if (!create_ktx2_file())
 				return cECFailedCreateKTX2File;
 		}
 
+		if (use_cache)
+			add_to_cache();
+
+		scoped_phase_timer wt(m_perf_stats.m_write_output, m_params.m_pJob_pool);
 		if (!write_output_files_and_compute_stats())
 			return cECFailedWritingOutput;
 
 		return cECSuccess;
 	}
 
+	// Hashes everything that can influence the output file's contents: the library version, the source images (or the raw contents of the 
+	// source files, which is equivalent and avoids decoding them), and every compressor parameter except those that only control 
+	// logging, debugging, or where the output is written.
+	bool basis_compressor::compute_cache_key(hash128& key)
+	{
+		hash128_builder h;
+
+		h.add_u32(BASISU_LIB_VERSION);
+		h.add_u32(BASISU_ENCODER_OUTPUT_REVISION);
+
+		if (m_params.m_read_source_images)
+		{
+			h.add_u32((uint32_t)m_params.m_source_filenames.size());
+			
+			for (uint32_t i = 0; i < m_params.m_source_filenames.size(); i++)
+			{
+				uint8_vec file_data;
+				if (!read_file_to_vec(m_params.m_source_filenames[i].c_str(), file_data))
+					return false;
+				
+				h.add_u64(file_data.size());
+				h.add(file_data.data(), file_data.size());
+
+				const bool has_alpha_file = (i < m_params.m_source_alpha_filenames.size()) && (m_params.m_source_alpha_filenames[i].size());
+				h.add_bool(has_alpha_file);
+
+				if (has_alpha_file)
+				{
+					if (!read_file_to_vec(m_params.m_source_alpha_filenames[i].c_str(), file_data))
+						return false;
+					
+					h.add_u64(file_data.size());
+					h.add(file_data.data(), file_data.size());
+				}
+			}
+		}
+		else
+		{
+			h.add_u32((uint32_t)m_params.m_source_images.size());
+
+			for (uint32_t i = 0; i < m_params.m_source_images.size(); i++)
+			{
+				const image& img = m_params.m_source_images[i];
+				h.add_u32(img.get_width());
+				h.add_u32(img.get_height());
+				for (uint32_t y = 0; y < img.get_height(); y++)
+					h.add(&img(0, y), img.get_width() * sizeof(color_rgba));
+			}
+		}
+
+		h.add_u32((uint32_t)m_params.m_source_mipmap_images.size());
+		for (uint32_t i = 0; i < m_params.m_source_mipmap_images.size(); i++)
+		{
+			h.add_u32((uint32_t)m_params.m_source_mipmap_images[i].size());
+			for (uint32_t j = 0; j < m_params.m_source_mipmap_images[i].size(); j++)
+			{
+				const image& img = m_params.m_source_mipmap_images[i][j];
+				h.add_u32(img.get_width());
+				h.add_u32(img.get_height());
+				for (uint32_t y = 0; y < img.get_height(); y++)
+					h.add(&img(0, y), img.get_width() * sizeof(color_rgba));
+			}
+		}
+
+#define HASH_BOOL_VALUE(v) h.add_bool(m_params.v)
+#define HASH_INT_VALUE(v) h.add_int((int)m_params.v)
+#define HASH_FLOAT_VALUE(v) h.add_float((float)m_params.v)
+
+		HASH_BOOL_VALUE(m_uastc);
+		HASH_BOOL_VALUE(m_y_flip);
+		HASH_INT_VALUE(m_compression_level);
+		HASH_BOOL_VALUE(m_global_sel_pal);
+		HASH_BOOL_VALUE(m_auto_global_sel_pal);
+		HASH_BOOL_VALUE(m_no_hybrid_sel_cb);
+		HASH_BOOL_VALUE(m_perceptual);
+		HASH_BOOL_VALUE(m_no_selector_rdo);
+		HASH_FLOAT_VALUE(m_selector_rdo_thresh);
+		HASH_BOOL_VALUE(m_no_endpoint_rdo);
+		HASH_FLOAT_VALUE(m_endpoint_rdo_thresh);
+		HASH_BOOL_VALUE(m_check_for_alpha);
+		HASH_BOOL_VALUE(m_force_alpha);
+		HASH_BOOL_VALUE(m_multithreading);
+		h.add(m_params.m_swizzle, sizeof(m_params.m_swizzle));
+		HASH_BOOL_VALUE(m_renormalize);
+		HASH_BOOL_VALUE(m_high_precision_source);
+		HASH_BOOL_VALUE(m_disable_hierarchical_endpoint_codebooks);
+		HASH_FLOAT_VALUE(m_hybrid_sel_cb_quality_thresh);
+		HASH_INT_VALUE(m_global_pal_bits);
+		HASH_INT_VALUE(m_global_mod_bits);
+
+		HASH_BOOL_VALUE(m_mip_gen);
+		HASH_FLOAT_VALUE(m_mip_scale);
+		h.add_string(m_params.m_mip_filter);
+		HASH_BOOL_VALUE(m_mip_srgb);
+		HASH_BOOL_VALUE(m_mip_premultiplied);
+		HASH_BOOL_VALUE(m_mip_renormalize);
+		HASH_BOOL_VALUE(m_mip_wrapping);
+		HASH_BOOL_VALUE(m_mip_fast);
+		HASH_INT_VALUE(m_mip_smallest_dimension);
+
+		HASH_INT_VALUE(m_max_endpoint_clusters);
+		HASH_INT_VALUE(m_max_selector_clusters);
+		HASH_INT_VALUE(m_quality_level);
+
+		HASH_INT_VALUE(m_tex_type);
+		HASH_INT_VALUE(m_userdata0);
+		HASH_INT_VALUE(m_userdata1);
+		HASH_INT_VALUE(m_us_per_frame);
+		HASH_INT_VALUE(m_video_iframe_interval);
+
+		HASH_INT_VALUE(m_pack_uastc_flags);
+		HASH_BOOL_VALUE(m_rdo_uastc);
+		HASH_FLOAT_VALUE(m_rdo_uastc_quality_scalar);
+		HASH_INT_VALUE(m_rdo_uastc_dict_size);
+		HASH_FLOAT_VALUE(m_rdo_uastc_max_smooth_block_error_scale);
+		HASH_FLOAT_VALUE(m_rdo_uastc_smooth_block_max_std_dev);
+		HASH_FLOAT_VALUE(m_rdo_uastc_max_allowed_rms_increase_ratio);
+		HASH_FLOAT_VALUE(m_rdo_uastc_skip_block_rms_thresh);
+		HASH_BOOL_VALUE(m_rdo_uastc_favor_simpler_modes_in_rdo_mode);
+		HASH_BOOL_VALUE(m_rdo_uastc_multithreading);
+		HASH_FLOAT_VALUE(m_rdo_uastc_target_bitrate);
+		HASH_INT_VALUE(m_rdo_uastc_target_size);
+		HASH_BOOL_VALUE(m_rdo_uastc_zstd_cost_model);
+
+		// Multithreaded UASTC RDO output depends on the number of RDO jobs, which depends on the number of threads.
+		if ((m_params.m_uastc) && (m_params.m_rdo_uastc) && (m_params.m_rdo_uastc_multithreading))
+			h.add_u32(m_params.m_pJob_pool ? (uint32_t)m_params.m_pJob_pool->get_total_threads() : 1);
+
+		HASH_INT_VALUE(m_resample_width);
+		HASH_INT_VALUE(m_resample_height);
+		HASH_FLOAT_VALUE(m_resample_factor);
+		h.add_string(m_params.m_resample_filter);
+		HASH_FLOAT_VALUE(m_resample_filter_scale);
+		HASH_BOOL_VALUE(m_resample_ifgt);
+		HASH_BOOL_VALUE(m_resample_aspect);
+
+		HASH_BOOL_VALUE(m_create_ktx2_file);
+		HASH_INT_VALUE(m_ktx2_uastc_supercompression);
+		HASH_INT_VALUE(m_ktx2_zstd_supercompression_level);
+		HASH_BOOL_VALUE(m_ktx2_srgb_transfer_func);
+		h.add_u32(m_params.m_ktx2_key_values.size());
+		for (uint32_t i = 0; i < m_params.m_ktx2_key_values.size(); i++)
+		{
+			h.add_u32(m_params.m_ktx2_key_values[i].m_key.size());
+			h.add(m_params.m_ktx2_key_values[i].m_key.data(), m_params.m_ktx2_key_values[i].m_key.size());
+			h.add_u32(m_params.m_ktx2_key_values[i].m_value.size());
+			h.add(m_params.m_ktx2_key_values[i].m_value.data(), m_params.m_ktx2_key_values[i].m_value.size());
+		}
+
+#undef HASH_BOOL_VALUE
+#undef HASH_INT_VALUE
+#undef HASH_FLOAT_VALUE
+
+		h.add_bool(m_params.m_pSel_codebook != nullptr);
+
+		h.add_bool(m_params.m_pGlobal_codebooks != nullptr);
+		if (m_params.m_pGlobal_codebooks)
+		{
+			const basist::basisu_lowlevel_etc1s_transcoder& cb = *m_params.m_pGlobal_codebooks;
+			h.add_u32(cb.get_endpoints().size());
+			h.add(cb.get_endpoints().data(), cb.get_endpoints().size_in_bytes());
+			h.add_u32(cb.get_selectors().size());
+			h.add(cb.get_selectors().data(), cb.get_selectors().size_in_bytes());
+		}
+
+		key = h.get_hash();
+
+		debug_printf("basis_compressor::compute_cache_key: %s\n", key.get_string().c_str());
+
+		return true;
+	}
+
+	// Cached payload layout (little endian): flags (4 bytes), bits per texel (4 byte float), .basis size (8 bytes), .ktx2 size (8 bytes), .basis data, .ktx2 data
+	enum
+	{
+		cCachedOutputFlagHasAlpha = 1,
+		cCachedOutputFlagHasKTX2 = 2
+	};
+
+	const uint32_t CACHED_OUTPUT_HEADER_SIZE = 24;
+
+	bool basis_compressor::read_from_cache()
+	{
+		uint8_vec payload;
+		if (!m_cache.get(m_cache_key, payload))
+		{
+			debug_printf("basis_compressor::read_from_cache: Cache miss\n");
+			return false;
+		}
+
+		if (payload.size() < CACHED_OUTPUT_HEADER_SIZE)
+			return false;
+
+		const uint8_t* pHdr = payload.data();
+		const uint32_t flags = read_le_dword(pHdr);
+		const uint32_t bits_per_texel_bits = read_le_dword(pHdr + 4);
+		const uint64_t basis_size = read_le_dword(pHdr + 8) | ((uint64_t)read_le_dword(pHdr + 12) << 32U);
+		const uint64_t ktx2_size = read_le_dword(pHdr + 16) | ((uint64_t)read_le_dword(pHdr + 20) << 32U);
+
+		if ((!basis_size) || ((basis_size + ktx2_size + CACHED_OUTPUT_HEADER_SIZE) != payload.size()))
+			return false;
+
+		if (((flags & cCachedOutputFlagHasKTX2) != 0) != (bool)m_params.m_create_ktx2_file)
+			return false;
+
+		const uint8_t* pBasis_data = payload.data() + CACHED_OUTPUT_HEADER_SIZE;
+		
+		m_output_basis_file.resize((size_t)basis_size);
+		memcpy(m_output_basis_file.data(), pBasis_data, (size_t)basis_size);
+
+		m_output_ktx2_file.resize((size_t)ktx2_size);
+		if (ktx2_size)
+			memcpy(m_output_ktx2_file.data(), pBasis_data + basis_size, (size_t)ktx2_size);
+
+		float bits_per_texel;
+		memcpy(&bits_per_texel, &bits_per_texel_bits, sizeof(bits_per_texel));
+
+		m_basis_file_size = (uint32_t)basis_size;
+		m_basis_bits_per_texel = bits_per_texel;
+		m_any_source_image_has_alpha = (flags & cCachedOutputFlagHasAlpha) != 0;
+
+		// There's no per-slice data on a hit.
+		m_stats.clear();
+		m_slice_descs.clear();
+		m_slice_images.clear();
+		
+		return true;
+	}
+
+	void basis_compressor::add_to_cache()
+	{
+		if (!m_cache.is_valid())
+			return;
+
+		uint32_t flags = 0;
+		if (m_any_source_image_has_alpha)
+			flags |= cCachedOutputFlagHasAlpha;
+		if (m_params.m_create_ktx2_file)
+			flags |= cCachedOutputFlagHasKTX2;
+
+		const float bits_per_texel = (float)m_basis_bits_per_texel;
+		uint32_t bits_per_texel_bits;
+		memcpy(&bits_per_texel_bits, &bits_per_texel, sizeof(bits_per_texel_bits));
+
+		const uint64_t basis_size = m_output_basis_file.size();
+		const uint64_t ktx2_size = m_params.m_create_ktx2_file ? m_output_ktx2_file.size() : 0;
+
+		uint8_vec payload(CACHED_OUTPUT_HEADER_SIZE);
+		uint8_t* pHdr = payload.data();
+		write_le_dword(pHdr, flags);
+		write_le_dword(pHdr + 4, bits_per_texel_bits);
+		write_le_dword(pHdr + 8, (uint32_t)basis_size);
+		write_le_dword(pHdr + 12, (uint32_t)(basis_size >> 32U));
+		write_le_dword(pHdr + 16, (uint32_t)ktx2_size);
+		write_le_dword(pHdr + 20, (uint32_t)(ktx2_size >> 32U));
+
+		append_vector(payload, m_output_basis_file);
+		if (ktx2_size)
+			append_vector(payload, m_output_ktx2_file);
+
+		// A failure to write to the cache isn't fatal, the output is still valid.
+		if (!m_cache.put(m_cache_key, payload))
+			debug_printf("basis_compressor::add_to_cache: Failed adding entry to encode cache\n");
+	}
+
 	basis_compressor::error_code basis_compressor::encode_slices_to_uastc()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::encode_slices_to_uastc", "comp");
+
 		debug_printf("basis_compressor::encode_slices_to_uastc\n");
 
-		m_uastc_slice_textures.resize(m_slice_descs.size());
-		for (uint32_t slice_index = 0; slice_index < m_slice_descs.size(); slice_index++)
+		const uint32_t total_slices = (uint32_t)m_slice_descs.size();
+
+		m_uastc_slice_textures.resize(total_slices);
+		for (uint32_t slice_index = 0; slice_index < total_slices; slice_index++)
 			m_uastc_slice_textures[slice_index].init(texture_format::cUASTC4x4, m_slice_descs[slice_index].m_orig_width, m_slice_descs[slice_index].m_orig_height);
 
 		m_uastc_backend_output.m_tex_format = basist::basis_tex_format::cUASTC4x4;
 		m_uastc_backend_output.m_etc1s = false;
 		m_uastc_backend_output.m_slice_desc = m_slice_descs;
-		m_uastc_backend_output.m_slice_image_data.resize(m_slice_descs.size());
-		m_uastc_backend_output.m_slice_image_crcs.resize(m_slice_descs.size());
-				
-		for (uint32_t slice_index = 0; slice_index < m_slice_descs.size(); slice_index++)
+		m_uastc_backend_output.m_slice_image_data.resize(total_slices);
+		m_uastc_backend_output.m_slice_image_crcs.resize(total_slices);
+
+		uint32_t uastc_flags = m_params.m_pack_uastc_flags;
+		if ((m_params.m_rdo_uastc) && (m_params.m_rdo_uastc_favor_simpler_modes_in_rdo_mode))
+			uastc_flags |= cPackUASTCFavorSimplerModes;
+
+		uastc_rdo_params rdo_params;
+		rdo_params.m_lambda = m_params.m_rdo_uastc_quality_scalar;
+		rdo_params.m_max_allowed_rms_increase_ratio = m_params.m_rdo_uastc_max_allowed_rms_increase_ratio;
+		rdo_params.m_skip_block_rms_thresh = m_params.m_rdo_uastc_skip_block_rms_thresh;
+		rdo_params.m_lz_dict_size = m_params.m_rdo_uastc_dict_size;
+		rdo_params.m_smooth_block_max_error_scale = m_params.m_rdo_uastc_max_smooth_block_error_scale;
+		rdo_params.m_max_smooth_block_std_dev = m_params.m_rdo_uastc_smooth_block_max_std_dev;
+		rdo_params.m_zstd_cost_model = m_params.m_rdo_uastc_zstd_cost_model;
+
+		const uint32_t total_rdo_jobs = m_params.m_rdo_uastc_multithreading ? (uint32_t)m_params.m_pJob_pool->get_total_threads() : 0;
+
+		// With rate control the RDO passes can't start until all slices are encoded and lambda has been chosen.
+		float target_bitrate = m_params.m_rdo_uastc_target_bitrate;
+		if (m_params.m_rdo_uastc_target_size > 0)
+		{
+			uint32_t total_texels = 0;
+			for (uint32_t slice_index = 0; slice_index < total_slices; slice_index++)
+				total_texels += m_uastc_slice_textures[slice_index].get_total_blocks() * 16;
+
+			target_bitrate = (float)((double)m_params.m_rdo_uastc_target_size * 8.0f / total_texels);
+		}
+
+		const bool rate_controlled_rdo = (m_params.m_rdo_uastc) && (target_bitrate > 0.0f);
+
+		// All slices are encoded by a single set of jobs, instead of draining the job pool after every slice, so small mips and array layers don't leave threads idle.
+		// The job that encodes a slice's last blocks queues that slice's RDO pass, and whichever job finishes the slice last copies it to the backend output and computes its CRC.
+		const uint32_t N = 256;
+
+		uint32_t total_blocks = 0;
+		std::vector<std::atomic<uint32_t> > slice_jobs_remaining(total_slices);
+		for (uint32_t slice_index = 0; slice_index < total_slices; slice_index++)
+		{
+			const uint32_t slice_blocks = m_uastc_slice_textures[slice_index].get_total_blocks();
+			slice_jobs_remaining[slice_index] = (slice_blocks + N - 1) / N;
+			total_blocks += slice_blocks;
+		}
+
+		std::atomic<uint32_t> total_blocks_processed(0);
+		std::atomic<bool> rdo_failed(false);
+		std::atomic<bool> rdo_started(false);
+		timer_ticks rdo_start_ticks = 0;
+
+		auto finalize_slice = [this](uint32_t slice_index)
+		{
+			const gpu_image& tex = m_uastc_slice_textures[slice_index];
+
+			m_uastc_backend_output.m_slice_image_data[slice_index].resize(tex.get_size_in_bytes());
+			memcpy(&m_uastc_backend_output.m_slice_image_data[slice_index][0], tex.get_ptr(), tex.get_size_in_bytes());
+
+			m_uastc_backend_output.m_slice_image_crcs[slice_index] = basist::crc16(tex.get_ptr(), tex.get_size_in_bytes(), 0);
+		};
+
+		auto start_slice_rdo = [this, &rdo_params, total_rdo_jobs, &rdo_failed, &rdo_started, &rdo_start_ticks, &finalize_slice](uint32_t slice_index)
 		{
+			if (!rdo_started.exchange(true))
+				rdo_start_ticks = interval_timer::get_ticks();
+
 			gpu_image& tex = m_uastc_slice_textures[slice_index];
-			basisu_backend_slice_desc& slice_desc = m_slice_descs[slice_index];
-			(void)slice_desc;
 
+			uastc_rdo_async(tex.get_total_blocks(), (basist::uastc_block*)tex.get_ptr(),
+				(const color_rgba*)m_source_blocks[m_slice_descs[slice_index].m_first_block_index].m_pixels, rdo_params, m_params.m_pack_uastc_flags, *m_params.m_pJob_pool, total_rdo_jobs,
+				[slice_index, &rdo_failed, &finalize_slice](bool status)
+				{
+					if (!status)
+						rdo_failed = true;
+					finalize_slice(slice_index);
+				});
+		};
+
+		auto slice_encoded = [this, rate_controlled_rdo, &start_slice_rdo, &finalize_slice](uint32_t slice_index)
+		{
+			if (!m_params.m_rdo_uastc)
+				finalize_slice(slice_index);
+			else if (!rate_controlled_rdo)
+				start_slice_rdo(slice_index);
+		};
+
+		scoped_phase_timer encode_timer(m_perf_stats.m_uastc_encode, m_params.m_pJob_pool);
+
+		// The job pool runs the most recently added jobs first, so queue the smallest slices first. The largest slices then finish (and start their RDO passes) earliest.
+		std::vector<uint32_t> slice_order(total_slices);
+		for (uint32_t i = 0; i < total_slices; i++)
+			slice_order[i] = i;
+		std::stable_sort(slice_order.begin(), slice_order.end(), [this](uint32_t a, uint32_t b) { return m_uastc_slice_textures[a].get_total_blocks() < m_uastc_slice_textures[b].get_total_blocks(); });
+
+		for (uint32_t order_index = 0; order_index < total_slices; order_index++)
+		{
+			const uint32_t slice_index = slice_order[order_index];
+
+			gpu_image& tex = m_uastc_slice_textures[slice_index];
 			const uint32_t num_blocks_x = tex.get_blocks_x();
-			const uint32_t num_blocks_y = tex.get_blocks_y();
-			const uint32_t total_blocks = tex.get_total_blocks();
-			const image& source_image = m_slice_images[slice_index];
-			
-			std::atomic<uint32_t> total_blocks_processed;
-			total_blocks_processed = 0;
+			const uint32_t slice_blocks = tex.get_total_blocks();
+			const pixel_block* pSource_blocks = &m_source_blocks[m_slice_descs[slice_index].m_first_block_index];
 
-			const uint32_t N = 256;
-			for (uint32_t block_index_iter = 0; block_index_iter < total_blocks; block_index_iter += N)
+			for (uint32_t block_index_iter = 0; block_index_iter < slice_blocks; block_index_iter += N)
 			{
 				const uint32_t first_index = block_index_iter;
-				const uint32_t last_index = minimum<uint32_t>(total_blocks, block_index_iter + N);
+				const uint32_t last_index = minimum<uint32_t>(slice_blocks, block_index_iter + N);
 
 				// FIXME: This sucks, but we're having a stack size related problem with std::function with emscripten.
 #ifndef __EMSCRIPTEN__
-				m_params.m_pJob_pool->add_job([this, first_index, last_index, num_blocks_x, num_blocks_y, total_blocks, &source_image, &tex, &total_blocks_processed]
+				m_params.m_pJob_pool->add_job([slice_index, first_index, last_index, num_blocks_x, total_blocks, uastc_flags, pSource_blocks, &tex, &total_blocks_processed, &slice_jobs_remaining, &slice_encoded]
 					{
 #endif
-						BASISU_NOTE_UNUSED(num_blocks_y);
-						
-						uint32_t uastc_flags = m_params.m_pack_uastc_flags;
-						if ((m_params.m_rdo_uastc) && (m_params.m_rdo_uastc_favor_simpler_modes_in_rdo_mode))
-							uastc_flags |= cPackUASTCFavorSimplerModes;
+						BASISU_TRACE_SCOPE_ARG("encode_uastc_blocks", "comp", slice_index);
 
-						for (uint32_t block_index = first_index; block_index < last_index; block_index++)
+						for (uint32_t batch_first_index = first_index; batch_first_index < last_index; batch_first_index += UASTC_ENCODE_BATCH_SIZE)
 						{
-							const uint32_t block_x = block_index % num_blocks_x;
-							const uint32_t block_y = block_index / num_blocks_x;
-
-							color_rgba block_pixels[4][4];
+							const uint32_t batch_size = minimum<uint32_t>(last_index - batch_first_index, UASTC_ENCODE_BATCH_SIZE);
 
-							source_image.extract_block_clamped((color_rgba*)block_pixels, block_x * 4, block_y * 4, 4, 4);
+							// The source blocks and the texture's blocks are both stored in raster order, so consecutive block indices are adjacent in memory.
+							basist::uastc_block* pDest_blocks = (basist::uastc_block*)tex.get_block_ptr(batch_first_index % num_blocks_x, batch_first_index / num_blocks_x);
 
-							basist::uastc_block& dest_block = *(basist::uastc_block*)tex.get_block_ptr(block_x, block_y);
+							encode_uastc_blocks(batch_size, pSource_blocks[batch_first_index].get_ptr(), pDest_blocks, uastc_flags);
 
-							encode_uastc(&block_pixels[0][0].r, dest_block, uastc_flags);
-
-							total_blocks_processed++;
-							
-							uint32_t val = total_blocks_processed;
-							if ((val & 16383) == 16383)
+							const uint32_t prev_val = total_blocks_processed.fetch_add(batch_size);
+							if ((prev_val >> 14) != ((prev_val + batch_size) >> 14))
 							{
-								debug_printf("basis_compressor::encode_slices_to_uastc: %3.1f%% done\n", static_cast<float>(val) * 100.0f / total_blocks);
+								debug_printf("basis_compressor::encode_slices_to_uastc: %3.1f%% done\n", static_cast<float>(prev_val + batch_size) * 100.0f / total_blocks);
 							}
-
 						}
 
+						if (slice_jobs_remaining[slice_index].fetch_sub(1) == 1)
+							slice_encoded(slice_index);
+
 #ifndef __EMSCRIPTEN__
 					});
 #endif
 
 			} // block_index_iter
 
+		} // order_index
+
 #ifndef __EMSCRIPTEN__
+		m_params.m_pJob_pool->wait_for_all();
+#endif
+
+		if (rate_controlled_rdo)
+		{
+			rdo_start_ticks = interval_timer::get_ticks();
+			rdo_started = true;
+
+			rdo_params.m_lambda = find_uastc_rdo_lambda(rdo_params, total_rdo_jobs, target_bitrate);
+
+			for (uint32_t order_index = 0; order_index < total_slices; order_index++)
+				start_slice_rdo(slice_order[order_index]);
+
 			m_params.m_pJob_pool->wait_for_all();
+		}
+
+		encode_timer.stop();
+
+		if (rdo_started)
+		{
+			m_perf_stats.m_uastc_rdo.m_wall_time += interval_timer::ticks_to_secs(interval_timer::get_ticks() - rdo_start_ticks);
+			m_perf_stats.m_uastc_rdo.m_num_runs++;
+		}
+
+		if (rdo_failed)
+			return cECFailedUASTCRDOPostProcess;
+				
+		return cECSuccess;
+	}
+
+	// Compresses a single 2D source image to a UASTC .KTX2 file in horizontal strips of blocks. Each strip is encoded (and optionally RDO'd), then 
+	// immediately written to the output file, Zstd supercompressed as a single streamed frame if requested. Besides the source image only one 
+	// strip's pixels and UASTC blocks are held in memory, instead of the entire slice's blocks, pixels, .basis file and .KTX2 file.
+	// The level index is written last, once the level's compressed size is known.
+	basis_compressor::error_code basis_compressor::process_uastc_streaming()
+	{
+		BASISU_TRACE_SCOPE("basis_compressor::process_uastc_streaming", "comp");
+
+		debug_printf("basis_compressor::process_uastc_streaming\n");
+
+		const uint32_t total_source_files = m_params.m_read_source_images ? (uint32_t)m_params.m_source_filenames.size() : (uint32_t)m_params.m_source_images.size();
+
+		if ((!m_params.m_uastc) || (!m_params.m_create_ktx2_file) || (!m_params.m_write_output_basis_files) || (!m_params.m_out_filename.size()))
+		{
+			error_printf("basis_compressor::process_uastc_streaming: Streaming requires UASTC and writing a .KTX2 output file\n");
+			return cECFailedValidating;
+		}
+
+		if ((total_source_files != 1) || (m_params.m_tex_type != basist::cBASISTexType2D) || (m_params.m_mip_gen) || (m_params.m_source_mipmap_images.size()))
+		{
+			error_printf("basis_compressor::process_uastc_streaming: Streaming requires a single 2D source image without mipmaps\n");
+			return cECFailedValidating;
+		}
+
+		if ((m_params.m_compute_stats) || (m_params.m_debug_images) || (m_params.m_rdo_uastc_target_bitrate > 0.0f) || (m_params.m_rdo_uastc_target_size > 0))
+		{
+			error_printf("basis_compressor::process_uastc_streaming: Streaming doesn't support stats, debug images, or UASTC RDO rate control\n");
+			return cECFailedValidating;
+		}
+
+		if ((m_params.m_ktx2_uastc_supercompression != basist::KTX2_SS_NONE) && (m_params.m_ktx2_uastc_supercompression != basist::KTX2_SS_ZSTANDARD))
+			return cECFailedValidating;
+
+		m_stats.resize(0);
+		m_slice_descs.resize(0);
+		m_slice_images.resize(0);
+		m_total_blocks = 0;
+
+		image source_image;
+		std::string source_filename;
+		bool has_alpha = false;
+
+		{
+			scoped_phase_timer t(m_perf_stats.m_read_source_images, m_params.m_pJob_pool);
+			if (!read_source_image(0, source_image, nullptr, source_filename, has_alpha, m_params.m_pJob_pool))
+				return cECFailedReadingSourceImages;
+		}
+
+		m_any_source_image_has_alpha = has_alpha;
+
+		// The source image isn't enlarged to 4x4 block boundaries, extract_block_clamped() duplicates the edge pixels instead.
+		const uint32_t width = source_image.get_width(), height = source_image.get_height();
+		const uint32_t num_blocks_x = source_image.get_block_width(4), num_blocks_y = source_image.get_block_height(4);
+
+		m_total_blocks = num_blocks_x * num_blocks_y;
+
+		m_stats.resize(1);
+		m_stats[0].m_filename = source_filename.c_str();
+		m_stats[0].m_width = width;
+		m_stats[0].m_height = height;
+
+		m_slice_descs.resize(1);
+		basisu_backend_slice_desc& slice_desc = m_slice_descs[0];
+		clear_obj(slice_desc);
+		slice_desc.m_orig_width = width;
+		slice_desc.m_orig_height = height;
+		slice_desc.m_width = num_blocks_x * 4;
+		slice_desc.m_height = num_blocks_y * 4;
+		slice_desc.m_num_blocks_x = num_blocks_x;
+		slice_desc.m_num_blocks_y = num_blocks_y;
+		slice_desc.m_num_macroblocks_x = (num_blocks_x + 1) >> 1;
+		slice_desc.m_num_macroblocks_y = (num_blocks_y + 1) >> 1;
+		slice_desc.m_alpha = has_alpha;
+
+		basist::ktx2_header header;
+		memset(&header, 0, sizeof(header));
+
+		memcpy(header.m_identifier, basist::g_ktx2_file_identifier, sizeof(basist::g_ktx2_file_identifier));
+		header.m_pixel_width = width;
+		header.m_pixel_height = height;
+		header.m_face_count = 1;
+		header.m_vk_format = basist::KTX2_VK_FORMAT_UNDEFINED;
+		header.m_type_size = 1;
+		header.m_level_count = 1;
+		header.m_supercompression_scheme = basist::KTX2_SS_NONE;
+
+#if BASISD_SUPPORT_KTX2_ZSTD
+		if (m_params.m_ktx2_uastc_supercompression == basist::KTX2_SS_ZSTANDARD)
+			header.m_supercompression_scheme = basist::KTX2_SS_ZSTANDARD;
 #endif
 
+		uint8_vec file_prefix;
+		if (!create_ktx2_file_prefix(header, 1, uint8_vec(), file_prefix))
+			return cECFailedCreateKTX2File;
+
+		memcpy(file_prefix.data(), &header, sizeof(header));
+
+		basist::ktx2_level_index level_index;
+		memset(&level_index, 0, sizeof(level_index));
+		level_index.m_byte_offset = file_prefix.size();
+		level_index.m_uncompressed_byte_length = (uint64_t)m_total_blocks * sizeof(basist::uastc_block);
+
+		FILE* pFile = nullptr;
+#ifdef _WIN32
+		fopen_s(&pFile, m_params.m_out_filename.c_str(), "wb");
+#else
+		pFile = fopen(m_params.m_out_filename.c_str(), "wb");
+#endif
+		if (!pFile)
+		{
+			error_printf("basis_compressor::process_uastc_streaming: Failed creating output file \"%s\"\n", m_params.m_out_filename.c_str());
+			return cECFailedWritingOutput;
+		}
+
+		error_code ec = cECSuccess;
+		uint64_t level_byte_length = 0;
+
+		if (fwrite(file_prefix.data(), file_prefix.size(), 1, pFile) != 1)
+			ec = cECFailedWritingOutput;
+		else
+		{
+			ec = encode_uastc_strips(source_image, header.m_supercompression_scheme == basist::KTX2_SS_ZSTANDARD, pFile, level_byte_length);
+
+			// Now that the level's size is known write the final level index.
+			level_index.m_byte_length = level_byte_length;
+
+			if ((ec == cECSuccess) && ((fseek(pFile, sizeof(header), SEEK_SET) != 0) || (fwrite(&level_index, sizeof(level_index), 1, pFile) != 1)))
+				ec = cECFailedWritingOutput;
+		}
+
+		if ((fclose(pFile) == EOF) && (ec == cECSuccess))
+			ec = cECFailedWritingOutput;
+
+		if (ec != cECSuccess)
+		{
+			if (ec == cECFailedWritingOutput)
+				error_printf("basis_compressor::process_uastc_streaming: Failed writing to output file \"%s\"\n", m_params.m_out_filename.c_str());
+			return ec;
+		}
+
+		m_streamed_output_file_size = file_prefix.size() + level_byte_length;
+
+		debug_printf("Total .ktx2 output file size: %llu\n", (unsigned long long)m_streamed_output_file_size);
+
+		if (m_params.m_status_output)
+			printf("Wrote output .ktx2 file \"%s\"\n", m_params.m_out_filename.c_str());
+
+		return cECSuccess;
+	}
+
+	// Encodes source_image to UASTC one strip of block rows at a time, writing each strip's blocks to pFile as soon as it's finished.
+	basis_compressor::error_code basis_compressor::encode_uastc_strips(const image& source_image, bool zstd_supercompression, FILE* pFile, uint64_t& level_byte_length)
+	{
+		level_byte_length = 0;
+
+		const uint32_t num_blocks_x = source_image.get_block_width(4), num_blocks_y = source_image.get_block_height(4);
+		const uint32_t strip_blocks_y = minimum<uint32_t>(num_blocks_y, maximum<uint32_t>(1, (m_params.m_uastc_streaming_strip_height + 3) / 4));
+
+		uint32_t uastc_flags = m_params.m_pack_uastc_flags;
+		if ((m_params.m_rdo_uastc) && (m_params.m_rdo_uastc_favor_simpler_modes_in_rdo_mode))
+			uastc_flags |= cPackUASTCFavorSimplerModes;
+
+		uastc_rdo_params rdo_params;
+		rdo_params.m_lambda = m_params.m_rdo_uastc_quality_scalar;
+		rdo_params.m_max_allowed_rms_increase_ratio = m_params.m_rdo_uastc_max_allowed_rms_increase_ratio;
+		rdo_params.m_skip_block_rms_thresh = m_params.m_rdo_uastc_skip_block_rms_thresh;
+		rdo_params.m_lz_dict_size = m_params.m_rdo_uastc_dict_size;
+		rdo_params.m_smooth_block_max_error_scale = m_params.m_rdo_uastc_max_smooth_block_error_scale;
+		rdo_params.m_max_smooth_block_std_dev = m_params.m_rdo_uastc_smooth_block_max_std_dev;
+		rdo_params.m_zstd_cost_model = m_params.m_rdo_uastc_zstd_cost_model;
+
+		const uint32_t total_rdo_jobs = m_params.m_rdo_uastc_multithreading ? (uint32_t)m_params.m_pJob_pool->get_total_threads() : 0;
+
+		basisu::vector<basist::uastc_block> strip_blocks(num_blocks_x * strip_blocks_y);
+		basisu::vector<color_rgba> strip_pixels(num_blocks_x * strip_blocks_y * 16);
+
+#if BASISD_SUPPORT_KTX2_ZSTD
+		ZSTD_CCtx* pZstd_cctx = nullptr;
+		uint8_vec zstd_output_buf;
+
+		if (zstd_supercompression)
+		{
+			pZstd_cctx = ZSTD_createCCtx();
+			if (!pZstd_cctx)
+				return cECFailedCreateKTX2File;
+
+			ZSTD_CCtx_setParameter(pZstd_cctx, ZSTD_c_compressionLevel, m_params.m_ktx2_zstd_supercompression_level);
+			ZSTD_CCtx_setPledgedSrcSize(pZstd_cctx, (unsigned long long)m_total_blocks * sizeof(basist::uastc_block));
+
+			zstd_output_buf.resize(ZSTD_CStreamOutSize());
+		}
+#else
+		if (zstd_supercompression)
+			return cECFailedCreateKTX2File;
+#endif
+
+		error_code ec = cECSuccess;
+
+		// Appends a strip's blocks to the level data. With Zstd the blocks are fed to the compressor, which may buffer them, so the final call flushes the frame.
+		auto write_blocks = [&](const basist::uastc_block* pBlocks, uint32_t num_blocks, bool last_strip) -> error_code
+		{
+			const size_t size_in_bytes = (size_t)num_blocks * sizeof(basist::uastc_block);
+
+#if BASISD_SUPPORT_KTX2_ZSTD
+			if (pZstd_cctx)
+			{
+				scoped_phase_timer zstd_timer(m_perf_stats.m_zstd);
+
+				ZSTD_inBuffer input = { pBlocks, size_in_bytes, 0 };
+				
+				for ( ; ; )
+				{
+					ZSTD_outBuffer output = { zstd_output_buf.data(), zstd_output_buf.size(), 0 };
+
+					const size_t remaining = ZSTD_compressStream2(pZstd_cctx, &output, &input, last_strip ? ZSTD_e_end : ZSTD_e_continue);
+					if (ZSTD_isError(remaining))
+						return cECFailedCreateKTX2File;
+
+					if ((output.pos) && (fwrite(zstd_output_buf.data(), output.pos, 1, pFile) != 1))
+						return cECFailedWritingOutput;
+
+					level_byte_length += output.pos;
+
+					if (last_strip ? (remaining == 0) : (input.pos == input.size))
+						break;
+				}
+
+				return cECSuccess;
+			}
+#else
+			BASISU_NOTE_UNUSED(last_strip);
+#endif
+
+			if (fwrite(pBlocks, size_in_bytes, 1, pFile) != 1)
+				return cECFailedWritingOutput;
+
+			level_byte_length += size_in_bytes;
+			return cECSuccess;
+		};
+
+		const uint32_t N = 256;
+
+		for (uint32_t first_block_y = 0; first_block_y < num_blocks_y; first_block_y += strip_blocks_y)
+		{
+			const uint32_t strip_height = minimum<uint32_t>(strip_blocks_y, num_blocks_y - first_block_y);
+			const uint32_t strip_total_blocks = num_blocks_x * strip_height;
+
+			{
+				scoped_phase_timer t(m_perf_stats.m_uastc_encode, m_params.m_pJob_pool);
+
+				for (uint32_t block_index_iter = 0; block_index_iter < strip_total_blocks; block_index_iter += N)
+				{
+					const uint32_t first_index = block_index_iter;
+					const uint32_t last_index = minimum<uint32_t>(strip_total_blocks, block_index_iter + N);
+
+					m_params.m_pJob_pool->add_job([first_index, last_index, first_block_y, num_blocks_x, uastc_flags, &source_image, &strip_blocks, &strip_pixels]
+						{
+							for (uint32_t block_index = first_index; block_index < last_index; block_index++)
+							{
+								const uint32_t block_x = block_index % num_blocks_x;
+								const uint32_t block_y = first_block_y + block_index / num_blocks_x;
+
+								source_image.extract_block_clamped(&strip_pixels[block_index * 16], block_x * 4, block_y * 4, 4, 4);
+							}
+
+							encode_uastc_blocks(last_index - first_index, &strip_pixels[first_index * 16], &strip_blocks[first_index], uastc_flags);
+						});
+				}
+
+				m_params.m_pJob_pool->wait_for_all();
+			}
+
 			if (m_params.m_rdo_uastc)
 			{
-				uastc_rdo_params rdo_params;
-				rdo_params.m_lambda = m_params.m_rdo_uastc_quality_scalar;
-				rdo_params.m_max_allowed_rms_increase_ratio = m_params.m_rdo_uastc_max_allowed_rms_increase_ratio;
-				rdo_params.m_skip_block_rms_thresh = m_params.m_rdo_uastc_skip_block_rms_thresh;
-				rdo_params.m_lz_dict_size = m_params.m_rdo_uastc_dict_size;
-				rdo_params.m_smooth_block_max_error_scale = m_params.m_rdo_uastc_max_smooth_block_error_scale;
-				rdo_params.m_max_smooth_block_std_dev = m_params.m_rdo_uastc_smooth_block_max_std_dev;
-								
-				bool status = uastc_rdo(tex.get_total_blocks(), (basist::uastc_block*)tex.get_ptr(),
-					(const color_rgba *)m_source_blocks[slice_desc.m_first_block_index].m_pixels, rdo_params, m_params.m_pack_uastc_flags, m_params.m_rdo_uastc_multithreading ? m_params.m_pJob_pool : nullptr,
-					(m_params.m_rdo_uastc_multithreading && m_params.m_pJob_pool) ? basisu::minimum<uint32_t>(4, (uint32_t)m_params.m_pJob_pool->get_total_threads()) : 0);
-				if (!status)
+				scoped_phase_timer t(m_perf_stats.m_uastc_rdo, m_params.m_pJob_pool);
+
+				if (!uastc_rdo(strip_total_blocks, strip_blocks.data(), strip_pixels.data(), rdo_params, m_params.m_pack_uastc_flags, m_params.m_pJob_pool, total_rdo_jobs))
 				{
-					return cECFailedUASTCRDOPostProcess;
+					ec = cECFailedUASTCRDOPostProcess;
+					break;
 				}
 			}
 
-			m_uastc_backend_output.m_slice_image_data[slice_index].resize(tex.get_size_in_bytes());
-			memcpy(&m_uastc_backend_output.m_slice_image_data[slice_index][0], tex.get_ptr(), tex.get_size_in_bytes());
+			{
+				scoped_phase_timer t(m_perf_stats.m_write_output);
+
+				ec = write_blocks(strip_blocks.data(), strip_total_blocks, (first_block_y + strip_height) == num_blocks_y);
+				if (ec != cECSuccess)
+					break;
+			}
+
+			debug_printf("basis_compressor::encode_uastc_strips: %3.1f%% done\n", (first_block_y + strip_height) * 100.0f / num_blocks_y);
+		}
+
+#if BASISD_SUPPORT_KTX2_ZSTD
+		if (pZstd_cctx)
+			ZSTD_freeCCtx(pZstd_cctx);
+#endif
+
+		return ec;
+	}
+
+	size_t basis_compressor::get_lz_compressed_size(const void* pData, size_t data_size) const
+	{
+#if BASISD_SUPPORT_KTX2_ZSTD
+		if ((m_params.m_create_ktx2_file) && (m_params.m_ktx2_uastc_supercompression == basist::KTX2_SS_ZSTANDARD))
+		{
+			uint8_vec comp_data(ZSTD_compressBound(data_size));
+
+			const size_t result = ZSTD_compress(comp_data.data(), comp_data.size(), pData, data_size, m_params.m_ktx2_zstd_supercompression_level);
 			
-			m_uastc_backend_output.m_slice_image_crcs[slice_index] = basist::crc16(tex.get_ptr(), tex.get_size_in_bytes(), 0);
-						
-		} // slice_index
-				
-		return cECSuccess;
+			return ZSTD_isError(result) ? data_size : result;
+		}
+#endif
+
+		size_t comp_size = 0;
+		void* pComp_data = tdefl_compress_mem_to_heap(pData, data_size, &comp_size, TDEFL_MAX_PROBES_MASK);
+		if (!pComp_data)
+			return data_size;
+
+		mz_free(pComp_data);
+		return comp_size;
 	}
 
-	bool basis_compressor::generate_mipmaps(const image &img, basisu::vector<image> &mips, bool has_alpha)
+	// Returns the UASTC RDO lambda which gets the LZ compressed size of the UASTC data closest to, but not over, target_bitrate (in bits per texel).
+	// The already encoded slices are reused: each step of the search runs RDO on a copy of evenly spaced runs of consecutive blocks, so it costs a fraction of an RDO pass 
+	// over the whole texture. The sample's compressed size is scaled by how much worse the sample compresses than all the data before RDO.
+	float basis_compressor::find_uastc_rdo_lambda(const uastc_rdo_params& rdo_params, uint32_t total_rdo_jobs, float target_bitrate)
 	{
-		debug_printf("basis_compressor::generate_mipmaps\n");
+		BASISU_TRACE_SCOPE("basis_compressor::find_uastc_rdo_lambda", "comp");
 
-		interval_timer tm;
-		tm.start();
+		const uint32_t MAX_SAMPLE_BLOCKS = 4096, SAMPLE_RUN_SIZE = 512, MAX_ITERATIONS = 12;
+		const float TOLERANCE = .015f;
+
+		uint8_vec all_blocks;
+		for (uint32_t slice_index = 0; slice_index < m_uastc_slice_textures.size(); slice_index++)
+		{
+			const gpu_image& tex = m_uastc_slice_textures[slice_index];
+			append_vector(all_blocks, (const uint8_t*)tex.get_ptr(), tex.get_size_in_bytes());
+		}
+
+		const uint32_t total_blocks = (uint32_t)(all_blocks.size() / sizeof(basist::uastc_block));
+		assert(total_blocks == m_source_blocks.size());
+
+		basisu::vector<basist::uastc_block> sample_blocks;
+		basisu::vector<color_rgba> sample_pixels;
+
+		if (total_blocks <= MAX_SAMPLE_BLOCKS)
+		{
+			sample_blocks.resize(total_blocks);
+			memcpy(sample_blocks.data(), all_blocks.data(), all_blocks.size());
+
+			sample_pixels.resize(total_blocks * 16);
+			for (uint32_t i = 0; i < total_blocks; i++)
+				memcpy(&sample_pixels[i * 16], m_source_blocks[i].get_ptr(), sizeof(color_rgba) * 16);
+		}
+		else
+		{
+			const uint32_t total_runs = MAX_SAMPLE_BLOCKS / SAMPLE_RUN_SIZE;
+			for (uint32_t run_index = 0; run_index < total_runs; run_index++)
+			{
+				const uint32_t first_block = (uint32_t)(((uint64_t)run_index * (total_blocks - SAMPLE_RUN_SIZE)) / (total_runs - 1));
+
+				for (uint32_t i = 0; i < SAMPLE_RUN_SIZE; i++)
+				{
+					sample_blocks.push_back(((const basist::uastc_block*)all_blocks.data())[first_block + i]);
+					append_vector(sample_pixels, m_source_blocks[first_block + i].get_ptr(), 16);
+				}
+			}
+		}
+
+		const uint32_t total_sample_blocks = (uint32_t)sample_blocks.size();
+
+		const size_t all_comp_size = get_lz_compressed_size(all_blocks.data(), all_blocks.size());
+		const size_t sample_comp_size = get_lz_compressed_size(sample_blocks.data(), sample_blocks.size_in_bytes());
+		const double sample_scale = (double)all_comp_size * total_sample_blocks / (maximum<size_t>(1, sample_comp_size) * total_blocks);
+
+		auto get_bitrate = [&](float lambda) -> float
+		{
+			basisu::vector<basist::uastc_block> blocks(sample_blocks);
+
+			uastc_rdo_params p(rdo_params);
+			p.m_lambda = lambda;
+
+			uastc_rdo(total_sample_blocks, blocks.data(), sample_pixels.data(), p, m_params.m_pack_uastc_flags, m_params.m_pJob_pool, total_rdo_jobs);
+
+			return (float)(get_lz_compressed_size(blocks.data(), blocks.size_in_bytes()) * sample_scale * 8.0f / (total_sample_blocks * 16));
+		};
+
+		// Search for lambda in the log domain with the Illinois variant of regula falsi. The bitrate is roughly an S shaped function of log(lambda), which
+		// plain bisection converges on slowly. lo always gives a bitrate over the target, hi a bitrate at or under it.
+		float lo = m_params.m_rdo_uastc_quality_scalar.m_min, hi = m_params.m_rdo_uastc_quality_scalar.m_max;
+
+		float lo_bitrate = get_bitrate(lo);
+		if (lo_bitrate <= target_bitrate)
+		{
+			debug_printf("basis_compressor::find_uastc_rdo_lambda: Target %3.3f bits/texel already met at lambda %f (%3.3f bits/texel)\n", target_bitrate, lo, lo_bitrate);
+			return lo;
+		}
+
+		float hi_bitrate = get_bitrate(hi);
+		if (hi_bitrate > target_bitrate)
+		{
+			if (m_params.m_status_output)
+				printf("Warning: UASTC RDO can't reach %3.3f bits/texel, using max lambda %f (%3.3f bits/texel)\n", target_bitrate, hi, hi_bitrate);
+			return hi;
+		}
+
+		float lo_err = lo_bitrate - target_bitrate, hi_err = hi_bitrate - target_bitrate;
+		int last_side = 0;
+
+		for (uint32_t iter = 0; iter < MAX_ITERATIONS; iter++)
+		{
+			if (hi_bitrate >= target_bitrate * (1.0f - TOLERANCE))
+				break;
+
+			const float log_lo = logf(lo), log_hi = logf(hi);
+
+			float log_mid = log_hi - hi_err * (log_hi - log_lo) / (hi_err - lo_err);
+
+			// Keep the new point away from the ends of the bracket so it always shrinks.
+			log_mid = clamp(log_mid, lerp(log_lo, log_hi, .05f), lerp(log_lo, log_hi, .95f));
+
+			const float mid = expf(log_mid);
+			const float mid_bitrate = get_bitrate(mid);
+
+			debug_printf("basis_compressor::find_uastc_rdo_lambda: Iteration %u lambda %f: %3.3f bits/texel\n", iter, mid, mid_bitrate);
 
+			if (mid_bitrate > target_bitrate)
+			{
+				lo = mid;
+				lo_bitrate = mid_bitrate;
+				lo_err = mid_bitrate - target_bitrate;
+				if (last_side == -1)
+					hi_err *= .5f;
+				last_side = -1;
+			}
+			else
+			{
+				hi = mid;
+				hi_bitrate = mid_bitrate;
+				hi_err = mid_bitrate - target_bitrate;
+				if (last_side == 1)
+					lo_err *= .5f;
+				last_side = 1;
+			}
+		}
+
+		if (m_params.m_status_output)
+			printf("UASTC RDO rate control: lambda %f, estimated %3.3f bits/texel (target %3.3f)\n", hi, hi_bitrate, target_bitrate);
+
+		return hi;
+	}
+
+	// Resamples mipmap levels 1 to total_levels-1 of img, appending them to mips. Shared by the 8-bit and high precision (float) paths.
+	template<typename IMAGE_TYPE>
+	static bool resample_mipmaps(const basis_compressor_params &params, const IMAGE_TYPE &img, basisu::vector<IMAGE_TYPE> &mips, uint32_t total_levels, bool has_alpha, job_pool *pJob_pool)
+	{
+		// A few bands per thread, so threads that finish early can pick up more work.
+		const uint32_t total_bands = pJob_pool ? (uint32_t)pJob_pool->get_total_threads() * 4 : 1;
+
+		// Size all the levels up front, so the level images don't move while they're being resampled.
+		const uint32_t first_mip = mips.size();
+		mips.resize(first_mip + total_levels - 1);
+
+		for (uint32_t level = 1; level < total_levels; level++)
+		{
+			const uint32_t level_width = maximum<uint32_t>(1, img.get_width() >> level);
+			const uint32_t level_height = maximum<uint32_t>(1, img.get_height() >> level);
+
+			mips[first_mip + level - 1].resize(level_width, level_height);
+		}
+
+		if (params.m_mip_fast)
+		{
+			// Each level depends on the previous one, so only the rows within each level can be resampled in parallel.
+			for (uint32_t level = 1; level < total_levels; level++)
+			{
+				IMAGE_TYPE& level_img = mips[first_mip + level - 1];
+
+				const IMAGE_TYPE* pSource_image = (level > 1) ? &mips[first_mip + level - 2] : &img;
+
+				image_resampler resampler;
+				if (!resampler.init(*pSource_image, level_img, params.m_mip_srgb, params.m_mip_filter.c_str(), params.m_mip_scale, params.m_mip_wrapping, 0, has_alpha ? 4 : 3, total_bands))
+				{
+					error_printf("resample_mipmaps: image_resample() failed!\n");
+					return false;
+				}
+
+				resampler.resample(pJob_pool);
+
+				if (params.m_mip_renormalize)
+					level_img.renormalize_normal_map();
+			}
+		}
+		else
+		{
+			// Every level is resampled from the source image, so the bands of all the levels can be resampled at the same time.
+			basisu::vector<image_resampler> resamplers;
+			resamplers.resize(total_levels - 1);
+
+			for (uint32_t level = 1; level < total_levels; level++)
+			{
+				if (!resamplers[level - 1].init(img, mips[first_mip + level - 1], params.m_mip_srgb, params.m_mip_filter.c_str(), params.m_mip_scale, params.m_mip_wrapping, 0, has_alpha ? 4 : 3, total_bands))
+				{
+					error_printf("resample_mipmaps: image_resample() failed!\n");
+					return false;
+				}
+			}
+
+			if (pJob_pool)
+			{
+				for (uint32_t level = 1; level < total_levels; level++)
+					resamplers[level - 1].add_jobs(*pJob_pool);
+
+				pJob_pool->wait_for_all();
+			}
+			else
+			{
+				for (uint32_t level = 1; level < total_levels; level++)
+					resamplers[level - 1].resample();
+			}
+
+			if (params.m_mip_renormalize)
+			{
+				for (uint32_t level = 1; level < total_levels; level++)
+					mips[first_mip + level - 1].renormalize_normal_map();
+			}
+		}
+
+		return true;
+	}
+
+	static uint32_t get_total_mip_levels(uint32_t w, uint32_t h, uint32_t smallest_dimension)
+	{
 		uint32_t total_levels = 1;
-		uint32_t w = img.get_width(), h = img.get_height();
-		while (maximum<uint32_t>(w, h) > (uint32_t)m_params.m_mip_smallest_dimension)
+		while (maximum<uint32_t>(w, h) > smallest_dimension)
 		{
 			w = maximum(w >> 1U, 1U);
 			h = maximum(h >> 1U, 1U);
 			total_levels++;
 		}
+		return total_levels;
+	}
+
+	bool basis_compressor::generate_mipmaps(const image &img, basisu::vector<image> &mips, bool has_alpha, job_pool *pJob_pool)
+	{
+		BASISU_TRACE_SCOPE("basis_compressor::generate_mipmaps", "comp");
+
+		debug_printf("basis_compressor::generate_mipmaps\n");
+
+		interval_timer tm;
+		tm.start();
+
+		const uint32_t total_levels = get_total_mip_levels(img.get_width(), img.get_height(), m_params.m_mip_smallest_dimension);
 
 #if BASISU_USE_STB_IMAGE_RESIZE_FOR_MIPMAP_GEN
 		// Requires stb_image_resize
@@ -395,142 +1381,240 @@ namespace basisu
 				level_img.renormalize_normal_map();
 		}
 #else
-		for (uint32_t level = 1; level < total_levels; level++)
-		{
-			const uint32_t level_width = maximum<uint32_t>(1, img.get_width() >> level);
-			const uint32_t level_height = maximum<uint32_t>(1, img.get_height() >> level);
+		if (!resample_mipmaps(m_params, img, mips, total_levels, has_alpha, pJob_pool))
+			return false;
+#endif
 
-			image& level_img = *enlarge_vector(mips, 1);
-			level_img.resize(level_width, level_height);
+		if (m_params.m_debug)
+			debug_printf("Total mipmap generation time: %f secs\n", tm.get_elapsed_secs());
+
+		return true;
+	}
 
-			const image* pSource_image = &img;
+	// High precision mipmap generation, always done with image_resampler.
+	bool basis_compressor::generate_mipmaps(const imagef &img, basisu::vector<imagef> &mips, bool has_alpha, job_pool *pJob_pool)
+	{
+		BASISU_TRACE_SCOPE("basis_compressor::generate_mipmaps", "comp");
+
+		debug_printf("basis_compressor::generate_mipmaps (high precision)\n");
+
+		interval_timer tm;
+		tm.start();
+
+		const uint32_t total_levels = get_total_mip_levels(img.get_width(), img.get_height(), m_params.m_mip_smallest_dimension);
+
+		if (!resample_mipmaps(m_params, img, mips, total_levels, has_alpha, pJob_pool))
+			return false;
+
+		if (m_params.m_debug)
+			debug_printf("Total mipmap generation time: %f secs\n", tm.get_elapsed_secs());
 
-			if (m_params.m_mip_fast)
+		return true;
+	}
+
+	// Returns true if any of the image's alpha values won't quantize to 255.
+	static bool has_alpha_hp(const imagef &img)
+	{
+		for (uint32_t y = 0; y < img.get_height(); y++)
+			for (uint32_t x = 0; x < img.get_width(); x++)
+				if (img(x, y)[3] < (254.5f / 255.0f))
+					return true;
+		return false;
+	}
+
+	// Computes the new dimensions of a source image if it should be resampled, from the m_resample_* parameters.
+	bool basis_compressor::get_source_resample_size(uint32_t src_width, uint32_t src_height, int &new_width, int &new_height) const
+	{
+		if (m_params.m_resample_width > 0 && m_params.m_resample_height > 0)
+		{
+			new_width = basisu::minimum<int>(m_params.m_resample_width, BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
+			new_height = basisu::minimum<int>(m_params.m_resample_height, BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
+
+			if (m_params.m_resample_ifgt && new_width >= (int)src_width && new_height >= (int)src_height)
 			{
-				if (level > 1)
-					pSource_image = &mips[level - 1];
+				debug_printf("Resampling skipped since source is <= %ix%i\n", (int)m_params.m_resample_width, (int)m_params.m_resample_height);
+				return false;
 			}
 
-			bool status = image_resample(*pSource_image, level_img, m_params.m_mip_srgb, m_params.m_mip_filter.c_str(), m_params.m_mip_scale, m_params.m_mip_wrapping, 0, has_alpha ? 4 : 3);
-			if (!status)
+			if (m_params.m_resample_aspect)
 			{
-				error_printf("basis_compressor::generate_mipmaps: image_resample() failed!\n");
-				return false;
+				if (src_width > src_height)
+				{
+					new_height = (int)roundf((float)new_width * (float)src_height / (float)src_width);
+				}
+				else
+				{
+					new_width = (int)roundf((float)new_height * (float)src_width / (float)src_height);
+				}
 			}
+			debug_printf("Resampling %ix%i -> %ix%i\n", src_width, src_height, new_width, new_height);
 
-			if (m_params.m_mip_renormalize)
-				level_img.renormalize_normal_map();
+			return true;
 		}
-#endif
+		else if (m_params.m_resample_factor > 0.0f)
+		{
+			new_width = basisu::minimum<int>(basisu::maximum(1, (int)ceilf(src_width * m_params.m_resample_factor)), BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
+			new_height = basisu::minimum<int>(basisu::maximum(1, (int)ceilf(src_height * m_params.m_resample_factor)), BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
 
-		if (m_params.m_debug)
-			debug_printf("Total mipmap generation time: %f secs\n", tm.get_elapsed_secs());
+			debug_printf("Resampling to %ix%i\n", new_width, new_height);
 
-		return true;
+			return true;
+		}
+
+		return false;
 	}
 
-	bool basis_compressor::read_source_images()
+	// Loads (or copies) one source image and applies the per-image preprocessing: alpha merging, swizzling, flipping and resampling.
+	// Only writes to the passed in objects, so different source images can be read at the same time.
+	// With m_high_precision_source the preprocessing is done on a float image, which is quantized into file_image at the end. If pFile_image_hp isn't
+	// nullptr it receives the float image, for mipmap generation.
+	bool basis_compressor::read_source_image(uint32_t source_file_index, image &file_image, imagef *pFile_image_hp, std::string &source_filename, bool &has_alpha, job_pool *pJob_pool)
 	{
-		debug_printf("basis_compressor::read_source_images\n");
+		const char *pSource_filename = "";
 
-		const uint32_t total_source_files = m_params.m_read_source_images ? (uint32_t)m_params.m_source_filenames.size() : (uint32_t)m_params.m_source_images.size();
-		if (!total_source_files)
-			return false;
+		const bool high_precision = m_params.m_high_precision_source;
+		imagef temp_image_hp;
+		imagef &file_image_hp = pFile_image_hp ? *pFile_image_hp : temp_image_hp;
 
-		m_stats.resize(0);
-		m_slice_descs.resize(0);
-		m_slice_images.resize(0);
+		if (m_params.m_read_source_images)
+		{
+			pSource_filename = m_params.m_source_filenames[source_file_index].c_str();
 
-		m_total_blocks = 0;
-		uint32_t total_macroblocks = 0;
+			// Load the source image
+			if (!(high_precision ? load_image(pSource_filename, file_image_hp) : load_image(pSource_filename, file_image)))
+			{
+				error_printf("Failed reading source image: %s\n", pSource_filename);
+				return false;
+			}
 
-		m_any_source_image_has_alpha = false;
+			const uint32_t width = high_precision ? file_image_hp.get_width() : file_image.get_width();
+			const uint32_t height = high_precision ? file_image_hp.get_height() : file_image.get_height();
 
-		basisu::vector<image> source_images;
-		basisu::vector<std::string> source_filenames;
-		
-		// First load all source images, and determine if any have an alpha channel.
-		for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
-		{
-			const char *pSource_filename = "";
+			if (m_params.m_status_output)
+			{
+				printf("Read source image \"%s\", %ux%u\n", pSource_filename, width, height);
+			}
 
-			image file_image;
-			
-			if (m_params.m_read_source_images)
+			// Optionally load another image and put a grayscale version of it into the alpha channel.
+			if ((source_file_index < m_params.m_source_alpha_filenames.size()) && (m_params.m_source_alpha_filenames[source_file_index].size()))
 			{
-				pSource_filename = m_params.m_source_filenames[source_file_index].c_str();
+				const char *pSource_alpha_image = m_params.m_source_alpha_filenames[source_file_index].c_str();
+
+				image alpha_data;
+				imagef alpha_data_hp;
 
-				// Load the source image
-				if (!load_image(pSource_filename, file_image))
+				if (!(high_precision ? load_image(pSource_alpha_image, alpha_data_hp) : load_image(pSource_alpha_image, alpha_data)))
 				{
-					error_printf("Failed reading source image: %s\n", pSource_filename);
+					error_printf("Failed reading source image: %s\n", pSource_alpha_image);
 					return false;
 				}
 
-				if (m_params.m_status_output)
-				{
-					printf("Read source image \"%s\", %ux%u\n", pSource_filename, file_image.get_width(), file_image.get_height());
-				}
+				printf("Read source alpha image \"%s\", %ux%u\n", pSource_alpha_image, 
+					high_precision ? alpha_data_hp.get_width() : alpha_data.get_width(), high_precision ? alpha_data_hp.get_height() : alpha_data.get_height());
 
-				// Optionally load another image and put a grayscale version of it into the alpha channel.
-				if ((source_file_index < m_params.m_source_alpha_filenames.size()) && (m_params.m_source_alpha_filenames[source_file_index].size()))
+				if (high_precision)
 				{
-					const char *pSource_alpha_image = m_params.m_source_alpha_filenames[source_file_index].c_str();
-
-					image alpha_data;
+					alpha_data_hp.crop(width, height);
 
-					if (!load_image(pSource_alpha_image, alpha_data))
+					for (uint32_t y = 0; y < height; y++)
 					{
-						error_printf("Failed reading source image: %s\n", pSource_alpha_image);
-						return false;
+						for (uint32_t x = 0; x < width; x++)
+						{
+							const vec4F &a = alpha_data_hp(x, y);
+							file_image_hp(x, y)[3] = saturate(a[0] * .2126f + a[1] * .7152f + a[2] * .0722f);
+						}
 					}
+				}
+				else
+				{
+					alpha_data.crop(width, height);
 
-					printf("Read source alpha image \"%s\", %ux%u\n", pSource_alpha_image, alpha_data.get_width(), alpha_data.get_height());
-
-					alpha_data.crop(file_image.get_width(), file_image.get_height());
-
-					for (uint32_t y = 0; y < file_image.get_height(); y++)
-						for (uint32_t x = 0; x < file_image.get_width(); x++)
+					for (uint32_t y = 0; y < height; y++)
+						for (uint32_t x = 0; x < width; x++)
 							file_image(x, y).a = (uint8_t)alpha_data(x, y).get_709_luma();
 				}
 			}
-			else
-			{
-				file_image = m_params.m_source_images[source_file_index];
-			}
+		}
+		else if (high_precision)
+		{
+			file_image_hp.set(m_params.m_source_images[source_file_index], vec4F(1.0f / 255.0f));
+		}
+		else
+		{
+			file_image = m_params.m_source_images[source_file_index];
+		}
 
-			if (m_params.m_renormalize)
+		if (m_params.m_renormalize)
+		{
+			if (high_precision)
+				file_image_hp.renormalize_normal_map();
+			else
 				file_image.renormalize_normal_map();
+		}
 
-			bool alpha_swizzled = false;
-			if (m_params.m_swizzle[0] != 0 ||
-				m_params.m_swizzle[1] != 1 ||
-				m_params.m_swizzle[2] != 2 ||
-				m_params.m_swizzle[3] != 3)
+		bool alpha_swizzled = false;
+		if (m_params.m_swizzle[0] != 0 ||
+			m_params.m_swizzle[1] != 1 ||
+			m_params.m_swizzle[2] != 2 ||
+			m_params.m_swizzle[3] != 3)
+		{
+			// Used for XY normal maps in RG - puts X in color, Y in alpha
+			if (high_precision)
+			{
+				for (uint32_t y = 0; y < file_image_hp.get_height(); y++)
+					for (uint32_t x = 0; x < file_image_hp.get_width(); x++)
+					{
+						const vec4F c(file_image_hp(x, y));
+						file_image_hp(x, y).set(c[m_params.m_swizzle[0]], c[m_params.m_swizzle[1]], c[m_params.m_swizzle[2]], c[m_params.m_swizzle[3]]);
+					}
+			}
+			else
 			{
-				// Used for XY normal maps in RG - puts X in color, Y in alpha
 				for (uint32_t y = 0; y < file_image.get_height(); y++)
 					for (uint32_t x = 0; x < file_image.get_width(); x++)
 					{
 						const color_rgba &c = file_image(x, y);
 						file_image(x, y).set_noclamp_rgba(c[m_params.m_swizzle[0]], c[m_params.m_swizzle[1]], c[m_params.m_swizzle[2]], c[m_params.m_swizzle[3]]);
 					}
-				alpha_swizzled = m_params.m_swizzle[3] != 3;
 			}
-						
-			bool has_alpha = false;
-			if (m_params.m_force_alpha || alpha_swizzled)
-				has_alpha = true;
-			else if (!m_params.m_check_for_alpha)
+			alpha_swizzled = m_params.m_swizzle[3] != 3;
+		}
+					
+		has_alpha = false;
+		if (m_params.m_force_alpha || alpha_swizzled)
+			has_alpha = true;
+		else if (!m_params.m_check_for_alpha)
+		{
+			if (high_precision)
+				file_image_hp.set_alpha(1.0f);
+			else
 				file_image.set_alpha(255);
-			else if (file_image.has_alpha())
-				has_alpha = true;
+		}
+		else if (high_precision ? has_alpha_hp(file_image_hp) : file_image.has_alpha())
+			has_alpha = true;
 
-			if (has_alpha)
-				m_any_source_image_has_alpha = true;
+		if (high_precision)
+		{
+			debug_printf("Source image index %u filename %s %ux%u has alpha: %u (high precision)\n", source_file_index, pSource_filename, file_image_hp.get_width(), file_image_hp.get_height(), has_alpha);
+
+			if (m_params.m_y_flip)
+				file_image_hp.flip_y();
+
+			int new_width = 0, new_height = 0;
+			if (get_source_resample_size(file_image_hp.get_width(), file_image_hp.get_height(), new_width, new_height))
+			{
+				imagef temp_img(new_width, new_height);
+				image_resample(file_image_hp, temp_img, m_params.m_perceptual, m_params.m_resample_filter.c_str(), m_params.m_resample_filter_scale, false, 0, 4, pJob_pool);
+				temp_img.swap(file_image_hp);
+			}
 
+			// This is the only place the source image is quantized to 8-bits. Mipmaps are generated from file_image_hp.
+			file_image_hp.quantize(file_image);
+		}
+		else
+		{
 			debug_printf("Source image index %u filename %s %ux%u has alpha: %u\n", source_file_index, pSource_filename, file_image.get_width(), file_image.get_height(), has_alpha);
-												
+											
 			if (m_params.m_y_flip)
 				file_image.flip_y();
 
@@ -546,65 +1630,239 @@ namespace basisu
 			file_image.resize(64, 64);
 #endif
 
-			if (m_params.m_resample_width > 0 && m_params.m_resample_height > 0)
+			int new_width = 0, new_height = 0;
+			if (get_source_resample_size(file_image.get_width(), file_image.get_height(), new_width, new_height))
 			{
-				int new_width = basisu::minimum<int>(m_params.m_resample_width, BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
-				int new_height = basisu::minimum<int>(m_params.m_resample_height, BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
+				// TODO: A box filter - kaiser looks too sharp on video. Let the caller control this.
+				image temp_img(new_width, new_height);
+				image_resample(file_image, temp_img, m_params.m_perceptual, m_params.m_resample_filter.c_str(), m_params.m_resample_filter_scale, false, 0, 4, pJob_pool);
+				temp_img.swap(file_image);
+			}
+		}
+
+		if ((!file_image.get_width()) || (!file_image.get_height()))
+		{
+			error_printf("basis_compressor::read_source_images: Source image has a zero width and/or height!\n");
+			return false;
+		}
+
+		if ((file_image.get_width() > BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION) || (file_image.get_height() > BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION))
+		{
+			error_printf("basis_compressor::read_source_images: Source image is too large (%ux%u, the maximum is %u), it must be resampled first!\n", file_image.get_width(), file_image.get_height(), BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
+			return false;
+		}
+
+
+		source_filename = pSource_filename;
+
+		return true;
+	}
 
-				int src_width = (int)file_image.get_width();
-				int src_height = (int)file_image.get_height();
+	// Creates the slices of one source image: its mipmap levels (user supplied or generated), split into RGB and alpha slices for ETC1S, 
+	// and each enlarged to 4x4 block boundaries. Only writes to the passed in objects and to this source image's user supplied mipmaps, 
+	// so different source images can be processed at the same time. If pFile_image_hp isn't nullptr the mipmaps are generated from it, in float.
+	bool basis_compressor::create_source_slices(uint32_t source_file_index, const image &file_image, const imagef *pFile_image_hp, std::vector<source_slice> &out_slices, job_pool *pJob_pool)
+	{
+		basisu::vector<image> slices;
+			
+		slices.reserve(32);
+			
+		// The first (largest) mipmap level.
+		slices.push_back(file_image);
+			
+		if (m_params.m_source_mipmap_images.size())
+		{
+			// User-provided mipmaps for each layer or image in the texture array.
+			for (uint32_t mip_index = 0; mip_index < m_params.m_source_mipmap_images[source_file_index].size(); mip_index++)
+			{
+				image& mip_img = m_params.m_source_mipmap_images[source_file_index][mip_index];
 
-				if (!m_params.m_resample_ifgt || new_width < src_width || new_height < src_height)
+				if (m_params.m_swizzle[0] != 0 ||
+					m_params.m_swizzle[1] != 1 ||
+					m_params.m_swizzle[2] != 2 ||
+					m_params.m_swizzle[3] != 3)
 				{
-					if (m_params.m_resample_aspect)
-					{
-						if (src_width > src_height)
-						{
-							new_height = (int)roundf((float)new_width * (float)src_height / (float)src_width);
-						}
-						else
+					// Used for XY normal maps in RG - puts X in color, Y in alpha
+					for (uint32_t y = 0; y < mip_img.get_height(); y++)
+						for (uint32_t x = 0; x < mip_img.get_width(); x++)
 						{
-							new_width = (int)roundf((float)new_height * (float)src_width / (float)src_height);
+							const color_rgba &c = mip_img(x, y);
+							mip_img(x, y).set_noclamp_rgba(c[m_params.m_swizzle[0]], c[m_params.m_swizzle[1]], c[m_params.m_swizzle[2]], c[m_params.m_swizzle[3]]);
 						}
+				}
+
+				slices.push_back(mip_img);
+			}
+		}
+		else if ((m_params.m_mip_gen) && (pFile_image_hp))
+		{
+			basisu::vector<imagef> mips_hp;
+			if (!generate_mipmaps(*pFile_image_hp, mips_hp, m_any_source_image_has_alpha, pJob_pool))
+				return false;
+
+			for (uint32_t mip_index = 0; mip_index < mips_hp.size(); mip_index++)
+			{
+				mips_hp[mip_index].quantize(*enlarge_vector(slices, 1));
+				mips_hp[mip_index].clear();
+			}
+		}
+		else if (m_params.m_mip_gen)
+		{
+			if (!generate_mipmaps(file_image, slices, m_any_source_image_has_alpha, pJob_pool))
+				return false;
+		}
+
+		uint_vec mip_indices(slices.size());
+		for (uint32_t i = 0; i < slices.size(); i++)
+			mip_indices[i] = i;
+						
+		if ((m_any_source_image_has_alpha) && (!m_params.m_uastc))
+		{
+			// For ETC1S, if source has alpha, then even mips will have RGB, and odd mips will have alpha in RGB. 
+			basisu::vector<image> alpha_slices;
+			uint_vec new_mip_indices;
+
+			alpha_slices.reserve(slices.size() * 2);
+
+			for (uint32_t i = 0; i < slices.size(); i++)
+			{
+				image lvl_rgb(slices[i]);
+				image lvl_a(lvl_rgb);
+
+				for (uint32_t y = 0; y < lvl_a.get_height(); y++)
+				{
+					for (uint32_t x = 0; x < lvl_a.get_width(); x++)
+					{
+						uint8_t a = lvl_a(x, y).a;
+						lvl_a(x, y).set_noclamp_rgba(a, a, a, 255);
 					}
-					debug_printf("Resampling %ix%i -> %ix%i\n", src_width, src_height, new_width, new_height);
+				}
+					
+				lvl_rgb.set_alpha(255);
+
+				alpha_slices.push_back(lvl_rgb);
+				new_mip_indices.push_back(i);
+
+				alpha_slices.push_back(lvl_a);
+				new_mip_indices.push_back(i);
+			}
+
+			slices.swap(alpha_slices);
+			mip_indices.swap(new_mip_indices);
+		}
+
+		assert(slices.size() == mip_indices.size());
+
+		out_slices.resize(slices.size());
+						
+		for (uint32_t slice_index = 0; slice_index < slices.size(); slice_index++)
+		{
+			image& slice_image = slices[slice_index];
+			source_slice& out_slice = out_slices[slice_index];
 
-					image temp_img(new_width, new_height);
-					image_resample(file_image, temp_img, m_params.m_perceptual, m_params.m_resample_filter.c_str(), m_params.m_resample_filter_scale);
-					temp_img.swap(file_image);
+			out_slice.m_orig_width = slice_image.get_width();
+			out_slice.m_orig_height = slice_image.get_height();
+			out_slice.m_mip_index = mip_indices[slice_index];
+
+			out_slice.m_alpha = false;
+			if (m_any_source_image_has_alpha)
+			{
+				if (m_params.m_uastc)
+				{
+					out_slice.m_alpha = slice_image.has_alpha();
 				}
 				else
 				{
-					debug_printf("Resampling skipped since source is <= %ix%i\n", (int)m_params.m_resample_width, (int)m_params.m_resample_height);
+					out_slice.m_alpha = (slice_index & 1) != 0;
 				}
 			}
-			else if (m_params.m_resample_factor > 0.0f)
-			{
-				int new_width = basisu::minimum<int>(basisu::maximum(1, (int)ceilf(file_image.get_width() * m_params.m_resample_factor)), BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
-				int new_height = basisu::minimum<int>(basisu::maximum(1, (int)ceilf(file_image.get_height() * m_params.m_resample_factor)), BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION);
 
-				debug_printf("Resampling to %ix%i\n", new_width, new_height);
+			// Enlarge the source image to 4x4 block boundaries, duplicating edge pixels if necessary to avoid introducing extra colors into blocks.
+			slice_image.crop_dup_borders(slice_image.get_block_width(4) * 4, slice_image.get_block_height(4) * 4);
 
-				// TODO: A box filter - kaiser looks too sharp on video. Let the caller control this.
-				image temp_img(new_width, new_height);
-				image_resample(file_image, temp_img, m_params.m_perceptual, m_params.m_resample_filter.c_str(), m_params.m_resample_filter_scale);
-				temp_img.swap(file_image);
+			if (m_params.m_debug_images)
+			{
+				save_png(string_format("basis_debug_source_image_%u_slice_%u.png", source_file_index, slice_index).c_str(), slice_image);
 			}
 
-			if ((!file_image.get_width()) || (!file_image.get_height()))
+			out_slice.m_image.swap(slice_image);
+		}
+
+		return true;
+	}
+
+	bool basis_compressor::read_source_images()
+	{
+		BASISU_TRACE_SCOPE("basis_compressor::read_source_images", "comp");
+
+		debug_printf("basis_compressor::read_source_images\n");
+
+		const uint32_t total_source_files = m_params.m_read_source_images ? (uint32_t)m_params.m_source_filenames.size() : (uint32_t)m_params.m_source_images.size();
+		if (!total_source_files)
+			return false;
+
+		m_stats.resize(0);
+		m_slice_descs.resize(0);
+		m_slice_images.resize(0);
+
+		m_total_blocks = 0;
+		uint32_t total_macroblocks = 0;
+
+		m_any_source_image_has_alpha = false;
+
+		basisu::vector<image> source_images;
+		basisu::vector<std::string> source_filenames;
+
+		// High precision copies of the source images, only kept when mipmaps will be generated from them.
+		const bool keep_source_images_hp = m_params.m_high_precision_source && m_params.m_mip_gen && !m_params.m_source_mipmap_images.size();
+		basisu::vector<imagef> source_images_hp;
+		
+		// First load all source images, and determine if any have an alpha channel. With multiple source images they're read in parallel,
+		// each job writing only to its own entries so the results are in the same order as the source images. With a single source 
+		// image the job pool is used to resample it and generate its mipmaps instead.
+		job_pool *pJob_pool = m_params.m_multithreading ? m_params.m_pJob_pool : nullptr;
+		const bool parallel_sources = (pJob_pool != nullptr) && (pJob_pool->get_total_threads() > 1) && (total_source_files > 1);
+
+		source_images.resize(total_source_files);
+		source_filenames.resize(total_source_files);
+		if (keep_source_images_hp)
+			source_images_hp.resize(total_source_files);
+
+		uint8_vec source_status(total_source_files), source_has_alpha(total_source_files);
+
+		for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
+		{
+			if (parallel_sources)
 			{
-				error_printf("basis_compressor::read_source_images: Source image has a zero width and/or height!\n");
-				return false;
+				pJob_pool->add_job([this, source_file_index, keep_source_images_hp, &source_images, &source_images_hp, &source_filenames, &source_status, &source_has_alpha] {
+					bool has_alpha = false;
+					source_status[source_file_index] = read_source_image(source_file_index, source_images[source_file_index], keep_source_images_hp ? &source_images_hp[source_file_index] : nullptr, 
+						source_filenames[source_file_index], has_alpha, nullptr);
+					source_has_alpha[source_file_index] = has_alpha;
+				});
 			}
-
-			if ((file_image.get_width() > BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION) || (file_image.get_height() > BASISU_MAX_SUPPORTED_TEXTURE_DIMENSION))
+			else
 			{
-				error_printf("basis_compressor::read_source_images: Source image is too large!\n");
-				return false;
+				bool has_alpha = false;
+				if (!read_source_image(source_file_index, source_images[source_file_index], keep_source_images_hp ? &source_images_hp[source_file_index] : nullptr, 
+					source_filenames[source_file_index], has_alpha, pJob_pool))
+					return false;
+
+				source_status[source_file_index] = true;
+				source_has_alpha[source_file_index] = has_alpha;
 			}
+		}
+
+		if (parallel_sources)
+			pJob_pool->wait_for_all();
+
+		for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
+		{
+			if (!source_status[source_file_index])
+				return false;
 
-			source_images.push_back(file_image);
-			source_filenames.push_back(pSource_filename);
+			if (source_has_alpha[source_file_index])
+				m_any_source_image_has_alpha = true;
 		}
 
 		// Check if the caller has generated their own mipmaps. 
@@ -642,117 +1900,62 @@ namespace basisu
 
 		debug_printf("Any source image has alpha: %u\n", m_any_source_image_has_alpha);
 
-		for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
+		// Now, for each source image, create the slices corresponding to that image.
+		// std::vector, because basisu::vector's relocation would instantiate a bitwise copy of source_slice (which owns an image).
+		basisu::vector< std::vector<source_slice> > source_slices;
+		source_slices.resize(total_source_files);
+
 		{
-			image &file_image = source_images[source_file_index];
-			const std::string &source_filename = source_filenames[source_file_index];
+			phase_timing unused_timing;
+			scoped_phase_timer mip_timer((m_params.m_mip_gen && !m_params.m_source_mipmap_images.size()) ? m_perf_stats.m_mipgen : unused_timing, pJob_pool);
 
-			// Now, for each source image, create the slices corresponding to that image.
-			basisu::vector<image> slices;
-			
-			slices.reserve(32);
-			
-			// The first (largest) mipmap level.
-			slices.push_back(file_image);
-			
-			if (m_params.m_source_mipmap_images.size())
+			for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
 			{
-				// User-provided mipmaps for each layer or image in the texture array.
-				for (uint32_t mip_index = 0; mip_index < m_params.m_source_mipmap_images[source_file_index].size(); mip_index++)
+				if (parallel_sources)
 				{
-					image& mip_img = m_params.m_source_mipmap_images[source_file_index][mip_index];
-
-					if (m_params.m_swizzle[0] != 0 ||
-						m_params.m_swizzle[1] != 1 ||
-						m_params.m_swizzle[2] != 2 ||
-						m_params.m_swizzle[3] != 3)
-					{
-						// Used for XY normal maps in RG - puts X in color, Y in alpha
-						for (uint32_t y = 0; y < mip_img.get_height(); y++)
-							for (uint32_t x = 0; x < mip_img.get_width(); x++)
-							{
-								const color_rgba &c = mip_img(x, y);
-								mip_img(x, y).set_noclamp_rgba(c[m_params.m_swizzle[0]], c[m_params.m_swizzle[1]], c[m_params.m_swizzle[2]], c[m_params.m_swizzle[3]]);
-							}
-					}
+					pJob_pool->add_job([this, source_file_index, keep_source_images_hp, &source_images, &source_images_hp, &source_slices, &source_status] {
+						source_status[source_file_index] = create_source_slices(source_file_index, source_images[source_file_index], keep_source_images_hp ? &source_images_hp[source_file_index] : nullptr, 
+							source_slices[source_file_index], nullptr);
+
+						// The source image has been copied into the first slice.
+						source_images[source_file_index].clear();
+						if (keep_source_images_hp)
+							source_images_hp[source_file_index].clear();
+					});
+				}
+				else
+				{
+					if (!create_source_slices(source_file_index, source_images[source_file_index], keep_source_images_hp ? &source_images_hp[source_file_index] : nullptr, 
+						source_slices[source_file_index], pJob_pool))
+						return false;
 
-					slices.push_back(mip_img);
+					source_images[source_file_index].clear();
+					if (keep_source_images_hp)
+						source_images_hp[source_file_index].clear();
 				}
 			}
-			else if (m_params.m_mip_gen)
-			{
-				// Automatically generate mipmaps.
-				if (!generate_mipmaps(file_image, slices, m_any_source_image_has_alpha))
-					return false;
-			}
 
-			uint_vec mip_indices(slices.size());
-			for (uint32_t i = 0; i < slices.size(); i++)
-				mip_indices[i] = i;
-						
-			if ((m_any_source_image_has_alpha) && (!m_params.m_uastc))
+			if (parallel_sources)
 			{
-				// For ETC1S, if source has alpha, then even mips will have RGB, and odd mips will have alpha in RGB. 
-				basisu::vector<image> alpha_slices;
-				uint_vec new_mip_indices;
+				pJob_pool->wait_for_all();
 
-				alpha_slices.reserve(slices.size() * 2);
-
-				for (uint32_t i = 0; i < slices.size(); i++)
-				{
-					image lvl_rgb(slices[i]);
-					image lvl_a(lvl_rgb);
-
-					for (uint32_t y = 0; y < lvl_a.get_height(); y++)
-					{
-						for (uint32_t x = 0; x < lvl_a.get_width(); x++)
-						{
-							uint8_t a = lvl_a(x, y).a;
-							lvl_a(x, y).set_noclamp_rgba(a, a, a, 255);
-						}
-					}
-					
-					lvl_rgb.set_alpha(255);
-
-					alpha_slices.push_back(lvl_rgb);
-					new_mip_indices.push_back(i);
-
-					alpha_slices.push_back(lvl_a);
-					new_mip_indices.push_back(i);
-				}
-
-				slices.swap(alpha_slices);
-				mip_indices.swap(new_mip_indices);
+				for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
+					if (!source_status[source_file_index])
+						return false;
 			}
+		}
 
-			assert(slices.size() == mip_indices.size());
+		for (uint32_t source_file_index = 0; source_file_index < total_source_files; source_file_index++)
+		{
+			const std::string &source_filename = source_filenames[source_file_index];
+			std::vector<source_slice> &slices = source_slices[source_file_index];
 						
 			for (uint32_t slice_index = 0; slice_index < slices.size(); slice_index++)
-			{
-				image& slice_image = slices[slice_index];
-				const uint32_t orig_width = slice_image.get_width();
-				const uint32_t orig_height = slice_image.get_height();
-
-				bool is_alpha_slice = false;
-				if (m_any_source_image_has_alpha)
-				{
-					if (m_params.m_uastc)
-					{
-						is_alpha_slice = slice_image.has_alpha();
-					}
-					else
-					{
-						is_alpha_slice = (slice_index & 1) != 0;
-					}
-				}
-
-				// Enlarge the source image to 4x4 block boundaries, duplicating edge pixels if necessary to avoid introducing extra colors into blocks.
-				slice_image.crop_dup_borders(slice_image.get_block_width(4) * 4, slice_image.get_block_height(4) * 4);
-
-				if (m_params.m_debug_images)
-				{
-					save_png(string_format("basis_debug_source_image_%u_slice_%u.png", source_file_index, slice_index).c_str(), slice_image);
-				}
+			{
+				image& slice_image = slices[slice_index].m_image;
+				const uint32_t orig_width = slices[slice_index].m_orig_width;
+				const uint32_t orig_height = slices[slice_index].m_orig_height;
+				const bool is_alpha_slice = slices[slice_index].m_alpha;
 
 				enlarge_vector(m_stats, 1);
 				enlarge_vector(m_slice_images, 1);
@@ -764,9 +1967,11 @@ namespace basisu
 				m_stats[dest_image_index].m_width = orig_width;
 				m_stats[dest_image_index].m_height = orig_height;
 
-				m_slice_images[dest_image_index] = slice_image;
+				m_slice_images[dest_image_index].swap(slice_image);
+
+				const image& dest_image = m_slice_images[dest_image_index];
 
-				debug_printf("****** Slice %u: mip %u, alpha_slice: %u, filename: \"%s\", original: %ux%u actual: %ux%u\n", m_slice_descs.size() - 1, mip_indices[slice_index], is_alpha_slice, source_filename.c_str(), orig_width, orig_height, slice_image.get_width(), slice_image.get_height());
+				debug_printf("****** Slice %u: mip %u, alpha_slice: %u, filename: \"%s\", original: %ux%u actual: %ux%u\n", m_slice_descs.size() - 1, slices[slice_index].m_mip_index, is_alpha_slice, source_filename.c_str(), orig_width, orig_height, dest_image.get_width(), dest_image.get_height());
 
 				basisu_backend_slice_desc &slice_desc = m_slice_descs[dest_image_index];
 
@@ -775,24 +1980,27 @@ namespace basisu
 				slice_desc.m_orig_width = orig_width;
 				slice_desc.m_orig_height = orig_height;
 
-				slice_desc.m_width = slice_image.get_width();
-				slice_desc.m_height = slice_image.get_height();
+				slice_desc.m_width = dest_image.get_width();
+				slice_desc.m_height = dest_image.get_height();
 
-				slice_desc.m_num_blocks_x = slice_image.get_block_width(4);
-				slice_desc.m_num_blocks_y = slice_image.get_block_height(4);
+				slice_desc.m_num_blocks_x = dest_image.get_block_width(4);
+				slice_desc.m_num_blocks_y = dest_image.get_block_height(4);
 
 				slice_desc.m_num_macroblocks_x = (slice_desc.m_num_blocks_x + 1) >> 1;
 				slice_desc.m_num_macroblocks_y = (slice_desc.m_num_blocks_y + 1) >> 1;
 
 				slice_desc.m_source_file_index = source_file_index;
 				
-				slice_desc.m_mip_index = mip_indices[slice_index];
+				slice_desc.m_mip_index = slices[slice_index].m_mip_index;
 
 				slice_desc.m_alpha = is_alpha_slice;
 				slice_desc.m_iframe = false;
 				if (m_params.m_tex_type == basist::cBASISTexTypeVideoFrames)
 				{
-					slice_desc.m_iframe = (source_file_index == 0);
+					if (m_params.m_video_iframe_interval)
+						slice_desc.m_iframe = (source_file_index % m_params.m_video_iframe_interval) == 0;
+					else
+						slice_desc.m_iframe = (source_file_index == 0);
 				}
 
 				m_total_blocks += slice_desc.m_num_blocks_x * slice_desc.m_num_blocks_y;
@@ -958,29 +2166,52 @@ namespace basisu
 
 	bool basis_compressor::extract_source_blocks()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::extract_source_blocks", "comp");
+
 		debug_printf("basis_compressor::extract_source_blocks\n");
 
+		// This is the only copy of the source pixels in block order: the frontend, backend, UASTC encoder and UASTC RDO all read their blocks from m_source_blocks.
 		m_source_blocks.resize(m_total_blocks);
 
-		for (uint32_t slice_index = 0; slice_index < m_slice_images.size(); slice_index++)
+		auto extract_block_rows = [this](uint32_t slice_index, uint32_t first_block_y, uint32_t last_block_y)
 		{
 			const basisu_backend_slice_desc& slice_desc = m_slice_descs[slice_index];
-
 			const uint32_t num_blocks_x = slice_desc.m_num_blocks_x;
-			const uint32_t num_blocks_y = slice_desc.m_num_blocks_y;
-
 			const image& source_image = m_slice_images[slice_index];
 
-			for (uint32_t block_y = 0; block_y < num_blocks_y; block_y++)
+			for (uint32_t block_y = first_block_y; block_y < last_block_y; block_y++)
 				for (uint32_t block_x = 0; block_x < num_blocks_x; block_x++)
 					source_image.extract_block_clamped(m_source_blocks[slice_desc.m_first_block_index + block_x + block_y * num_blocks_x].get_ptr(), block_x * 4, block_y * 4, 4, 4);
+		};
+
+		// Each job extracts up to N rows of blocks.
+		const uint32_t N = 16;
+
+		for (uint32_t slice_index = 0; slice_index < m_slice_images.size(); slice_index++)
+		{
+			const uint32_t num_blocks_y = m_slice_descs[slice_index].m_num_blocks_y;
+
+			for (uint32_t first_block_y = 0; first_block_y < num_blocks_y; first_block_y += N)
+			{
+				const uint32_t last_block_y = minimum<uint32_t>(num_blocks_y, first_block_y + N);
+
+				if (m_params.m_pJob_pool)
+					m_params.m_pJob_pool->add_job([slice_index, first_block_y, last_block_y, &extract_block_rows] { extract_block_rows(slice_index, first_block_y, last_block_y); });
+				else
+					extract_block_rows(slice_index, first_block_y, last_block_y);
+			}
 		}
 
+		if (m_params.m_pJob_pool)
+			m_params.m_pJob_pool->wait_for_all();
+
 		return true;
 	}
 
 	bool basis_compressor::process_frontend()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::process_frontend", "comp");
+
 		debug_printf("basis_compressor::process_frontend\n");
 						
 #if 0
@@ -1204,6 +2435,8 @@ namespace basisu
 
 	bool basis_compressor::extract_frontend_texture_data()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::extract_frontend_texture_data", "comp");
+
 		debug_printf("basis_compressor::extract_frontend_texture_data\n");
 
 		m_frontend_output_textures.resize(m_slice_descs.size());
@@ -1248,6 +2481,8 @@ namespace basisu
 
 	bool basis_compressor::process_backend()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::process_backend", "comp");
+
 		debug_printf("basis_compressor::process_backend\n");
 
 		basisu_backend_params backend_params;
@@ -1284,10 +2519,14 @@ namespace basisu
 
 	bool basis_compressor::create_basis_file_and_transcode()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::create_basis_file_and_transcode", "comp");
+
 		debug_printf("basis_compressor::create_basis_file_and_transcode\n");
 
 		const basisu_backend_output& encoded_output = m_params.m_uastc ? m_uastc_backend_output : m_backend.get_output();
 
+		scoped_phase_timer create_timer(m_perf_stats.m_create_basis_file, m_params.m_pJob_pool);
+
 		if (!m_basis_file.init(encoded_output, m_params.m_tex_type, m_params.m_userdata0, m_params.m_userdata1, m_params.m_y_flip, m_params.m_us_per_frame))
 		{
 			error_printf("basis_compressor::create_basis_file_and_transcode: basisu_backend:init() failed!\n");
@@ -1298,6 +2537,33 @@ namespace basisu
 
 		m_output_basis_file = comp_data;
 
+		create_timer.stop();
+
+		uint32_t total_orig_texels = 0;
+		for (uint32_t slice_index = 0; slice_index < m_slice_descs.size(); slice_index++)
+			total_orig_texels += m_slice_descs[slice_index].m_orig_width * m_slice_descs[slice_index].m_orig_height;
+
+		m_basis_file_size = (uint32_t)comp_data.size();
+		m_basis_bits_per_texel = (comp_data.size() * 8.0f) / total_orig_texels;
+
+		debug_printf("Total .basis output file size: %u, %3.3f bits/texel\n", comp_data.size(), m_basis_bits_per_texel);
+
+		m_decoded_output_textures.clear();
+		m_decoded_output_textures_unpacked.clear();
+		m_decoded_output_textures_bc7.clear();
+		m_decoded_output_textures_unpacked_bc7.clear();
+
+		// The stats and debug images are computed from the fully transcoded slices.
+		const bool need_decoded_textures = m_params.m_compute_stats || m_params.m_debug_images;
+		const basis_validation_mode validation_mode = need_decoded_textures ? cValidationFull : m_params.m_validation_mode;
+
+		debug_printf("Validation mode: %u\n", validation_mode);
+
+		if (validation_mode == cValidationNone)
+			return true;
+
+		scoped_phase_timer validation_timer(m_perf_stats.m_validation, m_params.m_pJob_pool);
+
 		interval_timer tm;
 		tm.start();
 
@@ -1313,12 +2579,6 @@ namespace basisu
 			return false;
 		}
 
-		m_decoded_output_textures.resize(m_slice_descs.size());
-		m_decoded_output_textures_unpacked.resize(m_slice_descs.size());
-
-		m_decoded_output_textures_bc7.resize(m_slice_descs.size());
-		m_decoded_output_textures_unpacked_bc7.resize(m_slice_descs.size());
-								
 		tm.start();
 		if (m_params.m_pGlobal_codebooks)
 		{
@@ -1335,111 +2595,199 @@ namespace basisu
 
 		debug_printf("basisu_compressor::start_transcoding() took %3.3fms\n", start_transcoding_time * 1000.0f);
 
-		uint32_t total_orig_pixels = 0;
-		uint32_t total_texels = 0;
+		if ((validation_mode == cValidationSampled) && (m_params.m_uastc))
+			return validate_sampled_uastc_blocks();
 
-		double total_time_etc1s_or_astc = 0;
+		// ETC1S slices can't be sampled (each block's endpoint/selector codes depend on the previous blocks), so they're always fully transcoded to ETC1 
+		// and CRC checked. The sampled mode skips their BC7 transcode.
+		const bool transcode_bc7 = (validation_mode == cValidationFull) && 
+			basist::basis_is_format_supported(basist::transcoder_texture_format::cTFBC7_RGBA, basist::basis_tex_format::cUASTC4x4) &&
+			basist::basis_is_format_supported(basist::transcoder_texture_format::cTFBC7_RGBA, basist::basis_tex_format::cETC1S);
 
-		for (uint32_t i = 0; i < m_slice_descs.size(); i++)
-		{
-			gpu_image decoded_texture;
-			decoded_texture.init(m_params.m_uastc ? texture_format::cASTC4x4 : texture_format::cETC1, m_slice_descs[i].m_width, m_slice_descs[i].m_height);
-						
-			tm.start();
+		tm.start();
 
-			basist::block_format format = m_params.m_uastc ? basist::block_format::cASTC_4x4 : basist::block_format::cETC1;
-			uint32_t bytes_per_block = m_params.m_uastc ? 16 : 8;
-						
-			if (!decoder.transcode_slice(&comp_data[0], (uint32_t)comp_data.size(), i,
-				reinterpret_cast<etc_block *>(decoded_texture.get_ptr()), m_slice_descs[i].m_num_blocks_x * m_slice_descs[i].m_num_blocks_y, format, bytes_per_block))
-			{
-				error_printf("Transcoding failed on slice %u!\n", i);
-				return false;
-			}
+		if (!transcode_output_slices(decoder, transcode_bc7, need_decoded_textures))
+			return false;
 
-			total_time_etc1s_or_astc += tm.get_elapsed_secs();
+		const double total_time = tm.get_elapsed_secs();
 
-			if (encoded_output.m_tex_format == basist::basis_tex_format::cETC1S)
-			{
-				uint32_t image_crc16 = basist::crc16(decoded_texture.get_ptr(), decoded_texture.get_size_in_bytes(), 0);
-				if (image_crc16 != encoded_output.m_slice_image_crcs[i])
-				{
-					error_printf("Decoded image data CRC check failed on slice %u!\n", i);
-					return false;
-				}
-				debug_printf("Decoded image data CRC check succeeded on slice %i\n", i);
-			}
+		debug_printf("Transcoded to %s%s in %3.3fms, %f texels/sec\n", m_params.m_uastc ? "ASTC" : "ETC1", transcode_bc7 ? " and BC7" : "", total_time * 1000.0f, total_orig_texels / total_time);
+
+		return true;
+	}
 
-			m_decoded_output_textures[i] = decoded_texture;
+	// Transcodes every output slice to ASTC (or ETC1), and optionally BC7, into m_decoded_output_textures/m_decoded_output_textures_bc7 and checks the
+	// ETC1S slice CRC's. With multithreading each slice is transcoded by its own job, except for ETC1S video frames which depend on the previous frame.
+	bool basis_compressor::transcode_output_slices(const basist::basisu_transcoder &decoder, bool transcode_bc7, bool unpack)
+	{
+		const basisu_backend_output& encoded_output = m_params.m_uastc ? m_uastc_backend_output : m_backend.get_output();
+		const uint8_vec& comp_data = m_basis_file.get_compressed_data();
+		const uint32_t total_slices = m_slice_descs.size();
 
-			total_orig_pixels += m_slice_descs[i].m_orig_width * m_slice_descs[i].m_orig_height;
-			total_texels += m_slice_descs[i].m_width * m_slice_descs[i].m_height;
+		m_decoded_output_textures.resize(total_slices);
+		m_decoded_output_textures_bc7.resize(total_slices);
+		if (unpack)
+		{
+			m_decoded_output_textures_unpacked.resize(total_slices);
+			m_decoded_output_textures_unpacked_bc7.resize(total_slices);
 		}
-												
-		double total_time_bc7 = 0;
 
-		if (basist::basis_is_format_supported(basist::transcoder_texture_format::cTFBC7_RGBA, basist::basis_tex_format::cUASTC4x4) &&
-			basist::basis_is_format_supported(basist::transcoder_texture_format::cTFBC7_RGBA, basist::basis_tex_format::cETC1S))
+		// Transcodes slices [first_slice, last_slice) in order, using its own transcoder states so it can run in parallel with other calls.
+		auto transcode_slices = [this, &decoder, &encoded_output, &comp_data, transcode_bc7, unpack](uint32_t first_slice, uint32_t last_slice) -> bool
 		{
-			for (uint32_t i = 0; i < m_slice_descs.size(); i++)
+			basist::basisu_transcoder_state state, bc7_state;
+
+			for (uint32_t i = first_slice; i < last_slice; i++)
 			{
-				gpu_image decoded_texture;
-				decoded_texture.init(texture_format::cBC7, m_slice_descs[i].m_width, m_slice_descs[i].m_height);
+				const basisu_backend_slice_desc& slice_desc = m_slice_descs[i];
+				const uint32_t total_blocks = slice_desc.m_num_blocks_x * slice_desc.m_num_blocks_y;
 
-				tm.start();
+				gpu_image& decoded_texture = m_decoded_output_textures[i];
+				decoded_texture.init(m_params.m_uastc ? texture_format::cASTC4x4 : texture_format::cETC1, slice_desc.m_width, slice_desc.m_height);
+
+				basist::block_format format = m_params.m_uastc ? basist::block_format::cASTC_4x4 : basist::block_format::cETC1;
+				uint32_t bytes_per_block = m_params.m_uastc ? 16 : 8;
 
 				if (!decoder.transcode_slice(&comp_data[0], (uint32_t)comp_data.size(), i,
-					reinterpret_cast<etc_block*>(decoded_texture.get_ptr()), m_slice_descs[i].m_num_blocks_x * m_slice_descs[i].m_num_blocks_y, basist::block_format::cBC7, 16))
+					reinterpret_cast<etc_block *>(decoded_texture.get_ptr()), total_blocks, format, bytes_per_block, 0, 0, &state))
 				{
-					error_printf("Transcoding failed to BC7 on slice %u!\n", i);
+					error_printf("Transcoding failed on slice %u!\n", i);
 					return false;
 				}
 
-				total_time_bc7 += tm.get_elapsed_secs();
+				if (encoded_output.m_tex_format == basist::basis_tex_format::cETC1S)
+				{
+					uint32_t image_crc16 = basist::crc16(decoded_texture.get_ptr(), decoded_texture.get_size_in_bytes(), 0);
+					if (image_crc16 != encoded_output.m_slice_image_crcs[i])
+					{
+						error_printf("Decoded image data CRC check failed on slice %u!\n", i);
+						return false;
+					}
+					debug_printf("Decoded image data CRC check succeeded on slice %i\n", i);
+				}
+
+				if (transcode_bc7)
+				{
+					gpu_image& decoded_texture_bc7 = m_decoded_output_textures_bc7[i];
+					decoded_texture_bc7.init(texture_format::cBC7, slice_desc.m_width, slice_desc.m_height);
+
+					if (!decoder.transcode_slice(&comp_data[0], (uint32_t)comp_data.size(), i,
+						reinterpret_cast<etc_block*>(decoded_texture_bc7.get_ptr()), total_blocks, basist::block_format::cBC7, 16, 0, 0, &bc7_state))
+					{
+						error_printf("Transcoding failed to BC7 on slice %u!\n", i);
+						return false;
+					}
+				}
+
+				if (unpack)
+				{
+					decoded_texture.unpack(m_decoded_output_textures_unpacked[i]);
 
-				m_decoded_output_textures_bc7[i] = decoded_texture;
+					if (transcode_bc7)
+						m_decoded_output_textures_bc7[i].unpack(m_decoded_output_textures_unpacked_bc7[i]);
+				}
 			}
-		}
 
-		for (uint32_t i = 0; i < m_slice_descs.size(); i++)
-		{
-			m_decoded_output_textures[i].unpack(m_decoded_output_textures_unpacked[i]);
+			return true;
+		};
 
-			if (m_decoded_output_textures_bc7[i].get_pixel_width())
-				m_decoded_output_textures_bc7[i].unpack(m_decoded_output_textures_unpacked_bc7[i]);
-		}
+		job_pool *pJob_pool = m_params.m_multithreading ? m_params.m_pJob_pool : nullptr;
+		const bool is_etc1s_video = (m_params.m_tex_type == basist::cBASISTexTypeVideoFrames) && !m_params.m_uastc;
 
-		debug_printf("Transcoded to %s in %3.3fms, %f texels/sec\n", m_params.m_uastc ? "ASTC" : "ETC1", total_time_etc1s_or_astc * 1000.0f, total_orig_pixels / total_time_etc1s_or_astc);
+		if ((!pJob_pool) || (pJob_pool->get_total_threads() <= 1) || (total_slices <= 1) || (is_etc1s_video))
+			return transcode_slices(0, total_slices);
 
-		if (total_time_bc7 != 0)
-			debug_printf("Transcoded to BC7 in %3.3fms, %f texels/sec\n", total_time_bc7 * 1000.0f, total_orig_pixels / total_time_bc7);
+		uint8_vec slice_status(total_slices);
+
+		for (uint32_t i = 0; i < total_slices; i++)
+			pJob_pool->add_job([i, &slice_status, &transcode_slices] { slice_status[i] = transcode_slices(i, i + 1); });
+
+		pJob_pool->wait_for_all();
+
+		for (uint32_t i = 0; i < total_slices; i++)
+			if (!slice_status[i])
+				return false;
+
+		return true;
+	}
+
+	// Checks a deterministic sample of each UASTC slice's blocks: they must match the encoder's output, unpack, and transcode to ASTC and BC7.
+	bool basis_compressor::validate_sampled_uastc_blocks()
+	{
+		const uint8_vec& comp_data = m_basis_file.get_compressed_data();
+
+		const basist::basis_file_header* pHeader = reinterpret_cast<const basist::basis_file_header*>(&comp_data[0]);
+		const basist::basis_slice_desc* pSlice_descs = reinterpret_cast<const basist::basis_slice_desc*>(&comp_data[pHeader->m_slice_desc_file_ofs]);
+
+		const bool transcode_bc7 = basist::basis_is_format_supported(basist::transcoder_texture_format::cTFBC7_RGBA, basist::basis_tex_format::cUASTC4x4);
+
+		uint32_t total_sampled_blocks = 0;
 
-		debug_printf("Total .basis output file size: %u, %3.3f bits/texel\n", comp_data.size(), comp_data.size() * 8.0f / total_orig_pixels);
-				
-		uint32_t total_orig_texels = 0;
 		for (uint32_t slice_index = 0; slice_index < m_slice_descs.size(); slice_index++)
 		{
-			const basisu_backend_slice_desc &slice_desc = m_slice_descs[slice_index];
+			const basisu_backend_slice_desc& slice_desc = m_slice_descs[slice_index];
+			const uint32_t total_blocks = slice_desc.m_num_blocks_x * slice_desc.m_num_blocks_y;
+			const uint8_vec& slice_data = m_uastc_backend_output.m_slice_image_data[slice_index];
 
-			total_orig_texels += slice_desc.m_orig_width * slice_desc.m_orig_height;
+			if ((pSlice_descs[slice_index].m_file_size != total_blocks * sizeof(basist::uastc_block)) || (slice_data.size() != total_blocks * sizeof(basist::uastc_block)))
+			{
+				error_printf("Slice %u has an invalid size!\n", slice_index);
+				return false;
+			}
 
-			const uint32_t total_blocks = slice_desc.m_num_blocks_x * slice_desc.m_num_blocks_y;
-			BASISU_NOTE_UNUSED(total_blocks);
+			const basist::uastc_block* pBlocks = reinterpret_cast<const basist::uastc_block*>(&comp_data[pSlice_descs[slice_index].m_file_ofs]);
+
+			const uint32_t total_samples = minimum<uint32_t>(total_blocks, BASISU_VALIDATION_SAMPLED_BLOCKS_PER_SLICE);
+
+			for (uint32_t sample_index = 0; sample_index < total_samples; sample_index++)
+			{
+				// Evenly spaced across the slice, from the first to the last block.
+				const uint32_t block_index = (total_samples > 1) ? (uint32_t)(((uint64_t)sample_index * (total_blocks - 1)) / (total_samples - 1)) : 0;
+				const basist::uastc_block& blk = pBlocks[block_index];
+
+				if (memcmp(&blk, &slice_data[block_index * sizeof(basist::uastc_block)], sizeof(basist::uastc_block)) != 0)
+				{
+					error_printf("Block %u of slice %u doesn't match the encoded data!\n", block_index, slice_index);
+					return false;
+				}
+
+				basist::color32 block_pixels[16];
+				if (!basist::unpack_uastc(blk, block_pixels, false))
+				{
+					error_printf("Unpacking block %u of slice %u failed!\n", block_index, slice_index);
+					return false;
+				}
+
+				uint8_t astc_blk[16];
+				if (!basist::transcode_uastc_to_astc(blk, astc_blk))
+				{
+					error_printf("Transcoding block %u of slice %u to ASTC failed!\n", block_index, slice_index);
+					return false;
+				}
+
+				uint8_t bc7_blk[16];
+				if ((transcode_bc7) && (!basist::transcode_uastc_to_bc7(blk, bc7_blk)))
+				{
+					error_printf("Transcoding block %u of slice %u to BC7 failed!\n", block_index, slice_index);
+					return false;
+				}
+			}
 
-			assert(m_decoded_output_textures[slice_index].get_total_blocks() == total_blocks);
+			total_sampled_blocks += total_samples;
 		}
 
-		m_basis_file_size = (uint32_t)comp_data.size();
-		m_basis_bits_per_texel = (comp_data.size() * 8.0f) / total_orig_texels;
+		debug_printf("Validated %u sampled UASTC blocks\n", total_sampled_blocks);
 
 		return true;
 	}
 
 	bool basis_compressor::write_output_files_and_compute_stats()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::write_output_files_and_compute_stats", "comp");
+
 		debug_printf("basis_compressor::write_output_files_and_compute_stats\n");
 
-		const uint8_vec& comp_data = m_params.m_create_ktx2_file ? m_output_ktx2_file : m_basis_file.get_compressed_data();
+		const uint8_vec& comp_data = m_params.m_create_ktx2_file ? m_output_ktx2_file : m_output_basis_file;
 		if (m_params.m_write_output_basis_files)
 		{
 			const std::string& output_filename = m_params.m_out_filename;
@@ -1502,39 +2850,42 @@ namespace basisu
 				// TODO: We used to output SSIM (during heavy encoder development), but this slowed down compression too much. We'll be adding it back.
 
 				image_metrics em;
+
+				// The metrics run in parallel bands of rows when multithreading.
+				job_pool *pJob_pool = m_params.m_multithreading ? m_params.m_pJob_pool : nullptr;
 								
 				// ---- .basis stats
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 3);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 3, true, false, pJob_pool);
 				em.print(".basis RGB Avg:          ");
 				s.m_basis_rgb_avg_psnr = em.m_psnr;
 
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 4);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 4, true, false, pJob_pool);
 				em.print(".basis RGBA Avg:         ");
 				s.m_basis_rgba_avg_psnr = em.m_psnr;
 
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 1);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 1, true, false, pJob_pool);
 				em.print(".basis R   Avg:          ");
 				
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 1, 1);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 1, 1, true, false, pJob_pool);
 				em.print(".basis G   Avg:          ");
 				
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 2, 1);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 2, 1, true, false, pJob_pool);
 				em.print(".basis B   Avg:          ");
 
 				if (m_params.m_uastc)
 				{
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 3, 1);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 3, 1, true, false, pJob_pool);
 					em.print(".basis A   Avg:          ");
 
 					s.m_basis_a_avg_psnr = em.m_psnr;
 				}
 
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 0);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 0, true, false, pJob_pool);
 				em.print(".basis 709 Luma:         ");
 				s.m_basis_luma_709_psnr = static_cast<float>(em.m_psnr);
 				s.m_basis_luma_709_ssim = static_cast<float>(em.m_ssim);
 
-				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 0, true, true);
+				em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked[slice_index], 0, 0, true, true, pJob_pool);
 				em.print(".basis 601 Luma:         ");
 				s.m_basis_luma_601_psnr = static_cast<float>(em.m_psnr);
 								
@@ -1548,37 +2899,37 @@ namespace basisu
 				if (m_decoded_output_textures_unpacked_bc7[slice_index].get_width())
 				{
 					// ---- BC7 stats
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 3);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 3, true, false, pJob_pool);
 					em.print("BC7 RGB Avg:             ");
 					s.m_bc7_rgb_avg_psnr = em.m_psnr;
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 4);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 4, true, false, pJob_pool);
 					em.print("BC7 RGBA Avg:            ");
 					s.m_bc7_rgba_avg_psnr = em.m_psnr;
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 1);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 1, true, false, pJob_pool);
 					em.print("BC7 R   Avg:             ");
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 1, 1);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 1, 1, true, false, pJob_pool);
 					em.print("BC7 G   Avg:             ");
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 2, 1);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 2, 1, true, false, pJob_pool);
 					em.print("BC7 B   Avg:             ");
 
 					if (m_params.m_uastc)
 					{
-						em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 3, 1);
+						em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 3, 1, true, false, pJob_pool);
 						em.print("BC7 A   Avg:             ");
 
 						s.m_bc7_a_avg_psnr = em.m_psnr;
 					}
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 0);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 0, true, false, pJob_pool);
 					em.print("BC7 709 Luma:            ");
 					s.m_bc7_luma_709_psnr = static_cast<float>(em.m_psnr);
 					s.m_bc7_luma_709_ssim = static_cast<float>(em.m_ssim);
 
-					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 0, true, true);
+					em.calc(m_slice_images[slice_index], m_decoded_output_textures_unpacked_bc7[slice_index], 0, 0, true, true, pJob_pool);
 					em.print("BC7 601 Luma:            ");
 					s.m_bc7_luma_601_psnr = static_cast<float>(em.m_psnr);
 				}
@@ -1586,18 +2937,18 @@ namespace basisu
 				if (!m_params.m_uastc)
 				{
 					// ---- Nearly best possible ETC1S stats
-					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 0);
+					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 0, true, false, pJob_pool);
 					em.print("Unquantized ETC1S 709 Luma:    ");
 
 					s.m_best_etc1s_luma_709_psnr = static_cast<float>(em.m_psnr);
 					s.m_best_etc1s_luma_709_ssim = static_cast<float>(em.m_ssim);
 
-					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 0, true, true);
+					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 0, true, true, pJob_pool);
 					em.print("Unquantized ETC1S 601 Luma:    ");
 
 					s.m_best_etc1s_luma_601_psnr = static_cast<float>(em.m_psnr);
 
-					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 3);
+					em.calc(m_slice_images[slice_index], m_best_etc1s_images_unpacked[slice_index], 0, 3, true, false, pJob_pool);
 					em.print("Unquantized ETC1S RGB Avg:     ");
 
 					s.m_best_etc1s_rgb_avg_psnr = static_cast<float>(em.m_psnr);
@@ -1735,51 +3086,221 @@ namespace basisu
 				dfd_len = sizeof(g_ktx2_etc1s_nonalpha_dfd);
 			}
 		}
-				
-		assert(dfd_len >= 44);
+				
+		assert(dfd_len >= 44);
+
+		dfd.resize(dfd_len);
+		memcpy(dfd.data(), pDFD, dfd_len);
+
+		uint32_t dfd_bits = basisu::read_le_dword(dfd.data() + 3 * sizeof(uint32_t));
+		
+		dfd_bits &= ~(0xFF << 16);
+
+		if (m_params.m_ktx2_srgb_transfer_func)
+			dfd_bits |= (basist::KTX2_KHR_DF_TRANSFER_SRGB << 16);
+		else
+			dfd_bits |= (basist::KTX2_KHR_DF_TRANSFER_LINEAR << 16);
+
+		basisu::write_le_dword(dfd.data() + 3 * sizeof(uint32_t), dfd_bits);
+
+		if (header.m_supercompression_scheme != basist::KTX2_SS_NONE)
+		{
+			uint32_t plane_bits = basisu::read_le_dword(dfd.data() + 5 * sizeof(uint32_t));
+
+			plane_bits &= ~0xFF;
+
+			basisu::write_le_dword(dfd.data() + 5 * sizeof(uint32_t), plane_bits);
+		}
+
+		// Fix up the DFD channel(s)
+		uint32_t dfd_chan0 = basisu::read_le_dword(dfd.data() + 7 * sizeof(uint32_t));
+
+		if (m_params.m_uastc)
+		{
+			dfd_chan0 &= ~(0xF << 24);
+			
+			// TODO: Allow the caller to override this
+			if (m_any_source_image_has_alpha)
+				dfd_chan0 |= (basist::KTX2_DF_CHANNEL_UASTC_RGBA << 24);
+			else
+				dfd_chan0 |= (basist::KTX2_DF_CHANNEL_UASTC_RGB << 24);
+		}
+
+		basisu::write_le_dword(dfd.data() + 7 * sizeof(uint32_t), dfd_chan0);
+	}
+
+	// Creates everything in a .KTX2 file before the level data: a placeholder header and level index array (the caller writes the final
+	// ones once the level data's offsets and sizes are known), DFD, key values, global supercompressed data, and mipPadding. Fills in the
+	// header's DFD, key value and SGD offsets.
+	bool basis_compressor::create_ktx2_file_prefix(basist::ktx2_header& header, uint32_t total_levels, const uint8_vec& etc1s_global_data, uint8_vec& out_file)
+	{
+		// Key values
+		basist::ktx2_transcoder::key_value_vec key_values(m_params.m_ktx2_key_values);
+		key_values.enlarge(1);
+		
+		const char* pKTXwriter = "KTXwriter";
+		key_values.back().m_key.resize(strlen(pKTXwriter) + 1);
+		memcpy(key_values.back().m_key.data(), pKTXwriter, strlen(pKTXwriter) + 1);
+
+		char writer_id[128];
+#ifdef _MSC_VER
+		sprintf_s(writer_id, sizeof(writer_id), "Basis Universal %s", BASISU_LIB_VERSION_STRING);
+#else
+		snprintf(writer_id, sizeof(writer_id), "Basis Universal %s", BASISU_LIB_VERSION_STRING);
+#endif
+		key_values.back().m_value.resize(strlen(writer_id) + 1);
+		memcpy(key_values.back().m_value.data(), writer_id, strlen(writer_id) + 1);
+
+		key_values.sort();
+
+#if BASISU_DISABLE_KTX2_KEY_VALUES
+		// HACK HACK - Clear the key values array, which causes no key values to be written (triggering the ktx2check validator bug).
+		key_values.clear();
+#endif
+
+		uint8_vec key_value_data;
+
+		// DFD
+		uint8_vec dfd;
+		get_dfd(dfd, header);
+
+		const uint32_t kvd_file_offset = sizeof(header) + sizeof(basist::ktx2_level_index) * total_levels + dfd.size();
+
+		for (uint32_t pass = 0; pass < 2; pass++)
+		{
+			for (uint32_t i = 0; i < key_values.size(); i++)
+			{
+				if (key_values[i].m_key.size() < 2)
+					return false;
+
+				if (key_values[i].m_key.back() != 0)
+					return false;
+
+				const uint64_t total_len = (uint64_t)key_values[i].m_key.size() + (uint64_t)key_values[i].m_value.size();
+				if (total_len >= UINT32_MAX)
+					return false;
+
+				packed_uint<4> le_len((uint32_t)total_len);
+				append_vector(key_value_data, (const uint8_t*)&le_len, sizeof(le_len));
+
+				append_vector(key_value_data, key_values[i].m_key);
+				append_vector(key_value_data, key_values[i].m_value);
+
+				const uint32_t ofs = key_value_data.size() & 3;
+				const uint32_t padding = (4 - ofs) & 3;
+				for (uint32_t p = 0; p < padding; p++)
+					key_value_data.push_back(0);
+			}
+
+			if (header.m_supercompression_scheme != basist::KTX2_SS_NONE)
+				break;
+
+#if BASISU_DISABLE_KTX2_ALIGNMENT_WORKAROUND
+			break;
+#endif
+			
+			// Hack to ensure the KVD block ends on a 16 byte boundary, because we have no other official way of aligning the data.
+			uint32_t kvd_end_file_offset = kvd_file_offset + key_value_data.size();
+			uint32_t bytes_needed_to_pad = (16 - (kvd_end_file_offset & 15)) & 15;
+			if (!bytes_needed_to_pad)
+			{
+				// We're good. No need to add a dummy key.
+				break;
+			}
+
+			assert(!pass);
+			if (pass)
+				return false;
+
+			if (bytes_needed_to_pad < 6)
+				bytes_needed_to_pad += 16;
+
+			printf("WARNING: Due to a KTX2 validator bug related to mipPadding, we must insert a dummy key into the KTX2 file of %u bytes\n", bytes_needed_to_pad);
+			
+			// We're not good - need to add a dummy key large enough to force file alignment so the mip level array gets aligned. 
+			// We can't just add some bytes before the mip level array because ktx2check will see that as extra data in the file that shouldn't be there in ktxValidator::validateDataSize().
+			key_values.enlarge(1);
+			for (uint32_t i = 0; i < (bytes_needed_to_pad - 4 - 1 - 1); i++)
+				key_values.back().m_key.push_back(127);
+			
+			key_values.back().m_key.push_back(0);
+
+			key_values.back().m_value.push_back(0);
+
+			key_values.sort();
+
+			key_value_data.resize(0);
+			
+			// Try again
+		}
 
-		dfd.resize(dfd_len);
-		memcpy(dfd.data(), pDFD, dfd_len);
+		basisu::vector<basist::ktx2_level_index> level_index_array(total_levels);
+		memset(level_index_array.data(), 0, level_index_array.size_in_bytes());
 
-		uint32_t dfd_bits = basisu::read_le_dword(dfd.data() + 3 * sizeof(uint32_t));
-		
-		dfd_bits &= ~(0xFF << 16);
+		assert(out_file.empty());
 
-		if (m_params.m_ktx2_srgb_transfer_func)
-			dfd_bits |= (basist::KTX2_KHR_DF_TRANSFER_SRGB << 16);
-		else
-			dfd_bits |= (basist::KTX2_KHR_DF_TRANSFER_LINEAR << 16);
+		// Dummy header
+		out_file.resize(sizeof(header));
 
-		basisu::write_le_dword(dfd.data() + 3 * sizeof(uint32_t), dfd_bits);
+		// Dummy level index array
+		append_vector(out_file, (const uint8_t*)level_index_array.data(), level_index_array.size_in_bytes());
+				
+		// DFD
+		const uint8_t* pDFD = dfd.data();
+		uint32_t dfd_len = dfd.size();
 
-		if (header.m_supercompression_scheme != basist::KTX2_SS_NONE)
-		{
-			uint32_t plane_bits = basisu::read_le_dword(dfd.data() + 5 * sizeof(uint32_t));
+		header.m_dfd_byte_offset = out_file.size();
+		header.m_dfd_byte_length = dfd_len;
+		append_vector(out_file, pDFD, dfd_len);
 
-			plane_bits &= ~0xFF;
+		// Key value data
+		if (key_value_data.size())
+		{
+			assert(kvd_file_offset == out_file.size());
 
-			basisu::write_le_dword(dfd.data() + 5 * sizeof(uint32_t), plane_bits);
+			header.m_kvd_byte_offset = out_file.size();
+			header.m_kvd_byte_length = key_value_data.size();
+			append_vector(out_file, key_value_data);
 		}
 
-		// Fix up the DFD channel(s)
-		uint32_t dfd_chan0 = basisu::read_le_dword(dfd.data() + 7 * sizeof(uint32_t));
+		// Global Supercompressed Data
+		if (etc1s_global_data.size())
+		{
+			uint32_t ofs = out_file.size() & 7;
+			uint32_t padding = (8 - ofs) & 7;
+			for (uint32_t i = 0; i < padding; i++)
+				out_file.push_back(0);
 
-		if (m_params.m_uastc)
+			header.m_sgd_byte_length = etc1s_global_data.size();
+			header.m_sgd_byte_offset = out_file.size();
+
+			append_vector(out_file, etc1s_global_data);
+		}
+
+		// mipPadding
+		if (header.m_supercompression_scheme == basist::KTX2_SS_NONE)
 		{
-			dfd_chan0 &= ~(0xF << 24);
-			
-			// TODO: Allow the caller to override this
-			if (m_any_source_image_has_alpha)
-				dfd_chan0 |= (basist::KTX2_DF_CHANNEL_UASTC_RGBA << 24);
-			else
-				dfd_chan0 |= (basist::KTX2_DF_CHANNEL_UASTC_RGB << 24);
+			// We currently can't do this or the validator will incorrectly give an error.
+			uint32_t ofs = out_file.size() & 15;
+			uint32_t padding = (16 - ofs) & 15;
+
+			// Make sure we're always aligned here (due to a validator bug).
+			if (padding)
+			{
+				printf("Warning: KTX2 mip level data is not 16-byte aligned. This may trigger a ktx2check validation bug. Writing %u bytes of mipPadding.\n", padding);
+			}
+
+			for (uint32_t i = 0; i < padding; i++)
+				out_file.push_back(0);
 		}
 
-		basisu::write_le_dword(dfd.data() + 7 * sizeof(uint32_t), dfd_chan0);
+		return true;
 	}
 
 	bool basis_compressor::create_ktx2_file()
 	{
+		BASISU_TRACE_SCOPE("basis_compressor::create_ktx2_file", "comp");
+
 		if (m_params.m_uastc)
 		{
 			if ((m_params.m_ktx2_uastc_supercompression != basist::KTX2_SS_NONE) && (m_params.m_ktx2_uastc_supercompression != basist::KTX2_SS_ZSTANDARD))
@@ -1871,6 +3392,8 @@ namespace basisu
 		if ((m_params.m_uastc) && (header.m_supercompression_scheme == basist::KTX2_SS_ZSTANDARD))
 		{
 #if BASISD_SUPPORT_KTX2_ZSTD
+			scoped_phase_timer zstd_timer(m_perf_stats.m_zstd);
+
 			for (uint32_t level_index = 0; level_index < total_levels; level_index++)
 			{
 				compressed_level_data_bytes[level_index].resize(ZSTD_compressBound(level_data_bytes[level_index].size()));
@@ -1953,185 +3476,162 @@ namespace basisu
 			header.m_supercompression_scheme = basist::KTX2_SS_BASISLZ;
 		}
 
-		// Key values
-		basist::ktx2_transcoder::key_value_vec key_values(m_params.m_ktx2_key_values);
-		key_values.enlarge(1);
-		
-		const char* pKTXwriter = "KTXwriter";
-		key_values.back().m_key.resize(strlen(pKTXwriter) + 1);
-		memcpy(key_values.back().m_key.data(), pKTXwriter, strlen(pKTXwriter) + 1);
+		m_output_ktx2_file.clear();
+		m_output_ktx2_file.reserve(m_output_basis_file.size());
 
-		char writer_id[128];
-#ifdef _MSC_VER
-		sprintf_s(writer_id, sizeof(writer_id), "Basis Universal %s", BASISU_LIB_VERSION_STRING);
-#else
-		snprintf(writer_id, sizeof(writer_id), "Basis Universal %s", BASISU_LIB_VERSION_STRING);
-#endif
-		key_values.back().m_value.resize(strlen(writer_id) + 1);
-		memcpy(key_values.back().m_value.data(), writer_id, strlen(writer_id) + 1);
+		if (!create_ktx2_file_prefix(header, total_levels, etc1s_global_data, m_output_ktx2_file))
+			return false;
 
-		key_values.sort();
+		basisu::vector<basist::ktx2_level_index> level_index_array(total_levels);
+		memset(level_index_array.data(), 0, level_index_array.size_in_bytes());
 
-#if BASISU_DISABLE_KTX2_KEY_VALUES
-		// HACK HACK - Clear the key values array, which causes no key values to be written (triggering the ktx2check validator bug).
-		key_values.clear();
-#endif
+		// Level data - write the smallest mipmap first.
+		for (int level = total_levels - 1; level >= 0; level--)
+		{
+			level_index_array[level].m_byte_length = compressed_level_data_bytes[level].size();
+			if (m_params.m_uastc)
+				level_index_array[level].m_uncompressed_byte_length = level_data_bytes[level].size();
 
-		uint8_vec key_value_data;
+			level_index_array[level].m_byte_offset = m_output_ktx2_file.size();
+			append_vector(m_output_ktx2_file, compressed_level_data_bytes[level]);
+		}
+		
+		// Write final header
+		memcpy(m_output_ktx2_file.data(), &header, sizeof(header));
 
-		// DFD
-		uint8_vec dfd;
-		get_dfd(dfd, header);
+		// Write final level index array
+		memcpy(m_output_ktx2_file.data() + sizeof(header), level_index_array.data(), level_index_array.size_in_bytes());
 
-		const uint32_t kvd_file_offset = sizeof(header) + sizeof(basist::ktx2_level_index) * total_levels + dfd.size();
+		debug_printf("Total .ktx2 output file size: %u\n", m_output_ktx2_file.size());
 
-		for (uint32_t pass = 0; pass < 2; pass++)
-		{
-			for (uint32_t i = 0; i < key_values.size(); i++)
-			{
-				if (key_values[i].m_key.size() < 2)
-					return false;
+		return true;
+	}
 
-				if (key_values[i].m_key.back() != 0)
-					return false;
+	bool basis_parallel_compress(uint32_t total_threads, const basisu::vector<basis_compressor_params>& params_vec, basisu::vector<parallel_results>& results_vec)
+	{
+		BASISU_TRACE_SCOPE("basis_parallel_compress", "comp");
 
-				const uint64_t total_len = (uint64_t)key_values[i].m_key.size() + (uint64_t)key_values[i].m_value.size();
-				if (total_len >= UINT32_MAX)
-					return false;
+		assert(total_threads >= 1);
+		total_threads = basisu::maximum<uint32_t>(total_threads, 1);
 
-				packed_uint<4> le_len((uint32_t)total_len);
-				append_vector(key_value_data, (const uint8_t*)&le_len, sizeof(le_len));
+		job_pool jpool(total_threads);
 
-				append_vector(key_value_data, key_values[i].m_key);
-				append_vector(key_value_data, key_values[i].m_value);
+		results_vec.resize(0);
+		results_vec.resize(params_vec.size());
 
-				const uint32_t ofs = key_value_data.size() & 3;
-				const uint32_t padding = (4 - ofs) & 3;
-				for (uint32_t p = 0; p < padding; p++)
-					key_value_data.push_back(0);
-			}
+		std::atomic<bool> result;
+		result = true;
 
-			if (header.m_supercompression_scheme != basist::KTX2_SS_NONE)
-				break;
+		for (uint32_t pindex = 0; pindex < params_vec.size(); pindex++)
+		{
+			jpool.add_job([pindex, &params_vec, &results_vec, &result] {
 
-#if BASISU_DISABLE_KTX2_ALIGNMENT_WORKAROUND
-			break;
-#endif
-			
-			// Hack to ensure the KVD block ends on a 16 byte boundary, because we have no other official way of aligning the data.
-			uint32_t kvd_end_file_offset = kvd_file_offset + key_value_data.size();
-			uint32_t bytes_needed_to_pad = (16 - (kvd_end_file_offset & 15)) & 15;
-			if (!bytes_needed_to_pad)
-			{
-				// We're good. No need to add a dummy key.
-				break;
-			}
+				basis_compressor_params params = params_vec[pindex];
+				parallel_results& results = results_vec[pindex];
 
-			assert(!pass);
-			if (pass)
-				return false;
+				interval_timer tm;
+				tm.start();
 
-			if (bytes_needed_to_pad < 6)
-				bytes_needed_to_pad += 16;
+				// The compressor waits on its job pool, which can't be the pool running this job, so give it its own. A single thread job pool runs
+				// queued jobs on the calling thread when it's waited on.
+				job_pool task_jpool(1);
+				params.m_pJob_pool = &task_jpool;
+				params.m_multithreading = false;
 
-			printf("WARNING: Due to a KTX2 validator bug related to mipPadding, we must insert a dummy key into the KTX2 file of %u bytes\n", bytes_needed_to_pad);
-			
-			// We're not good - need to add a dummy key large enough to force file alignment so the mip level array gets aligned. 
-			// We can't just add some bytes before the mip level array because ktx2check will see that as extra data in the file that shouldn't be there in ktxValidator::validateDataSize().
-			key_values.enlarge(1);
-			for (uint32_t i = 0; i < (bytes_needed_to_pad - 4 - 1 - 1); i++)
-				key_values.back().m_key.push_back(127);
-			
-			key_values.back().m_key.push_back(0);
+				basis_compressor c;
 
-			key_values.back().m_value.push_back(0);
+				if (!c.init(params))
+				{
+					result = false;
+					results.m_error_code = basis_compressor::cECFailedValidating;
+				}
+				else
+				{
+					results.m_error_code = c.process();
 
-			key_values.sort();
+					if (results.m_error_code == basis_compressor::cECSuccess)
+					{
+						results.m_basis_file = c.get_output_basis_file();
+						results.m_ktx2_file = c.get_output_ktx2_file();
+						results.m_stats.assign(c.get_stats().begin(), c.get_stats().end());
+						results.m_basis_bits_per_texel = c.get_basis_bits_per_texel();
+						results.m_any_source_image_has_alpha = c.get_any_source_image_has_alpha();
+					}
+					else
+						result = false;
+				}
 
-			key_value_data.resize(0);
-			
-			// Try again
+				results.m_perf_stats = c.get_perf_stats();
+				results.m_total_time = tm.get_elapsed_secs();
+			});
 		}
 
-		basisu::vector<basist::ktx2_level_index> level_index_array(total_levels);
-		memset(level_index_array.data(), 0, level_index_array.size_in_bytes());
-				
-		m_output_ktx2_file.clear();
-		m_output_ktx2_file.reserve(m_output_basis_file.size());
-
-		// Dummy header
-		m_output_ktx2_file.resize(sizeof(header));
+		jpool.wait_for_all();
 
-		// Level index array
-		append_vector(m_output_ktx2_file, (const uint8_t*)level_index_array.data(), level_index_array.size_in_bytes());
-				
-		// DFD
-		const uint8_t* pDFD = dfd.data();
-		uint32_t dfd_len = dfd.size();
+		return result;
+	}
 
-		header.m_dfd_byte_offset = m_output_ktx2_file.size();
-		header.m_dfd_byte_length = dfd_len;
-		append_vector(m_output_ktx2_file, pDFD, dfd_len);
+	bool basis_split_video_gops(const basis_compressor_params& params, uint32_t gop_size, basisu::vector<basis_compressor_params>& gop_params_vec)
+	{
+		gop_params_vec.resize(0);
 
-		// Key value data
-		if (key_value_data.size())
+		if ((params.m_tex_type != basist::cBASISTexTypeVideoFrames) || (!gop_size))
 		{
-			assert(kvd_file_offset == m_output_ktx2_file.size());
-
-			header.m_kvd_byte_offset = m_output_ktx2_file.size();
-			header.m_kvd_byte_length = key_value_data.size();
-			append_vector(m_output_ktx2_file, key_value_data);
+			error_printf("basis_split_video_gops: Texture type must be video frames and the GOP size must be non-zero\n");
+			return false;
 		}
 
-		// Global Supercompressed Data
-		if (etc1s_global_data.size())
+		const uint32_t total_frames = params.m_read_source_images ? (uint32_t)params.m_source_filenames.size() : (uint32_t)params.m_source_images.size();
+		if (!total_frames)
 		{
-			uint32_t ofs = m_output_ktx2_file.size() & 7;
-			uint32_t padding = (8 - ofs) & 7;
-			for (uint32_t i = 0; i < padding; i++)
-				m_output_ktx2_file.push_back(0);
-
-			header.m_sgd_byte_length = etc1s_global_data.size();
-			header.m_sgd_byte_offset = m_output_ktx2_file.size();
-
-			append_vector(m_output_ktx2_file, etc1s_global_data);
+			error_printf("basis_split_video_gops: No frames\n");
+			return false;
 		}
 
-		// mipPadding
-		if (header.m_supercompression_scheme == basist::KTX2_SS_NONE)
+		std::string out_base(params.m_out_filename), out_ext;
+		const size_t dot_ofs = out_base.find_last_of('.');
+		const size_t sep_ofs = out_base.find_last_of("/\\:");
+		if ((dot_ofs != std::string::npos) && ((sep_ofs == std::string::npos) || (dot_ofs > sep_ofs)))
 		{
-			// We currently can't do this or the validator will incorrectly give an error.
-			uint32_t ofs = m_output_ktx2_file.size() & 15;
-			uint32_t padding = (16 - ofs) & 15;
-
-			// Make sure we're always aligned here (due to a validator bug).
-			if (padding)
-			{
-				printf("Warning: KTX2 mip level data is not 16-byte aligned. This may trigger a ktx2check validation bug. Writing %u bytes of mipPadding.\n", padding);
-			}
-
-			for (uint32_t i = 0; i < padding; i++)
-				m_output_ktx2_file.push_back(0);
+			out_ext = out_base.substr(dot_ofs);
+			out_base.resize(dot_ofs);
 		}
 
-		// Level data - write the smallest mipmap first.
-		for (int level = total_levels - 1; level >= 0; level--)
+		const uint32_t total_gops = (total_frames + gop_size - 1) / gop_size;
+		gop_params_vec.resize(total_gops);
+
+		for (uint32_t gop_index = 0; gop_index < total_gops; gop_index++)
 		{
-			level_index_array[level].m_byte_length = compressed_level_data_bytes[level].size();
-			if (m_params.m_uastc)
-				level_index_array[level].m_uncompressed_byte_length = level_data_bytes[level].size();
+			const uint32_t first_frame = gop_index * gop_size;
+			const uint32_t last_frame = basisu::minimum(total_frames, first_frame + gop_size);
 
-			level_index_array[level].m_byte_offset = m_output_ktx2_file.size();
-			append_vector(m_output_ktx2_file, compressed_level_data_bytes[level]);
-		}
-		
-		// Write final header
-		memcpy(m_output_ktx2_file.data(), &header, sizeof(header));
+			basis_compressor_params& p = gop_params_vec[gop_index];
+			p = params;
 
-		// Write final level index array
-		memcpy(m_output_ktx2_file.data() + sizeof(header), level_index_array.data(), level_index_array.size_in_bytes());
+			p.m_source_filenames.resize(0);
+			p.m_source_alpha_filenames.resize(0);
+			p.m_source_images.resize(0);
+			p.m_source_mipmap_images.resize(0);
 
-		debug_printf("Total .ktx2 output file size: %u\n", m_output_ktx2_file.size());
+			for (uint32_t frame_index = first_frame; frame_index < last_frame; frame_index++)
+			{
+				if (params.m_read_source_images)
+				{
+					p.m_source_filenames.push_back(params.m_source_filenames[frame_index]);
+					if (frame_index < params.m_source_alpha_filenames.size())
+						p.m_source_alpha_filenames.push_back(params.m_source_alpha_filenames[frame_index]);
+				}
+				else
+				{
+					p.m_source_images.push_back(params.m_source_images[frame_index]);
+					if (frame_index < params.m_source_mipmap_images.size())
+						p.m_source_mipmap_images.push_back(params.m_source_mipmap_images[frame_index]);
+				}
+			}
+
+			if (params.m_out_filename.size())
+				p.m_out_filename = out_base + string_format("_gop%04u", gop_index) + out_ext;
+		}
 
 		return true;
 	}
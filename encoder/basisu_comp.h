@@ -19,6 +19,7 @@
 #include "../transcoder/basisu_global_selector_palette.h"
 #include "../transcoder/basisu_transcoder.h"
 #include "basisu_uastc_enc.h"
+#include "basisu_cache.h"
 
 #define BASISU_LIB_VERSION 115
 #define BASISU_LIB_VERSION_STRING "1.15"
@@ -59,6 +60,23 @@ namespace basisu
 	const int BASISU_RDO_UASTC_DICT_SIZE_MIN = 64;
 	const int BASISU_RDO_UASTC_DICT_SIZE_MAX = 65536;
 
+	const uint64_t BASISU_DEFAULT_ENCODE_CACHE_MAX_SIZE = 1024ULL * 1024ULL * 1024ULL;
+
+	// Bumped whenever the encoder's output changes without a BASISU_LIB_VERSION change, so stale encode cache entries aren't reused.
+	const uint32_t BASISU_ENCODER_OUTPUT_REVISION = 3;
+
+	// How the compressor verifies its output after encoding, by transcoding it back.
+	enum basis_validation_mode
+	{
+		cValidationNone,		// Only the file is created, nothing is transcoded
+		cValidationSampled,		// Checksums, plus a sample of each UASTC slice's blocks (ETC1S slices are always fully transcoded to ETC1 and CRC checked)
+		cValidationFull,		// Every slice is transcoded to ASTC or ETC1 and BC7
+		cTotalValidationModes
+	};
+
+	// Blocks transcoded from each UASTC slice by cValidationSampled (the first and last blocks are always included).
+	const uint32_t BASISU_VALIDATION_SAMPLED_BLOCKS_PER_SLICE = 256;
+
 	struct image_stats
 	{
 		image_stats()
@@ -119,6 +137,76 @@ namespace basisu
 		float m_best_etc1s_luma_709_ssim;
 	};
 
+	// Per-phase timings and counters collected by basis_compressor::process().
+	// Each phase_timing records wall clock time, process CPU time (all threads), and time spent executing job pool jobs.
+	struct basis_compressor_perf_stats
+	{
+		basis_compressor_perf_stats()
+		{
+			clear();
+		}
+
+		void clear()
+		{
+			m_total.clear();
+			m_cache_lookup.clear();
+			m_read_source_images.clear();
+			m_mipgen.clear();
+			m_extract_source_blocks.clear();
+			m_frontend.clear();
+			m_frontend_steps.clear();
+			m_frontend_extract.clear();
+			m_backend.clear();
+			m_uastc_encode.clear();
+			m_uastc_rdo.clear();
+			m_create_basis_file.clear();
+			m_validation.clear();
+			m_create_ktx2_file.clear();
+			m_zstd.clear();
+			m_write_output.clear();
+
+			m_total_threads = 0;
+			m_peak_memory_usage = 0;
+			m_total_slices = 0;
+			m_total_blocks = 0;
+			m_total_endpoint_clusters = 0;
+			m_total_selector_clusters = 0;
+			m_output_file_size = 0;
+			m_cache_hit = false;
+		}
+
+		phase_timing m_total;
+		phase_timing m_cache_lookup;
+		phase_timing m_read_source_images; // includes m_mipgen
+		phase_timing m_mipgen;
+		phase_timing m_extract_source_blocks;
+		
+		// ETC1S
+		phase_timing m_frontend;
+		basisu_frontend::timings m_frontend_steps;
+		phase_timing m_frontend_extract;
+		phase_timing m_backend;
+
+		// UASTC
+		phase_timing m_uastc_encode; // RDO overlaps block encoding, so this includes m_uastc_rdo
+		phase_timing m_uastc_rdo; // wall time only, from the first slice's RDO pass starting until all slices are done
+
+		phase_timing m_create_basis_file;
+		phase_timing m_validation; // transcoding the output and checking its CRC's
+		phase_timing m_create_ktx2_file; // includes m_zstd
+		phase_timing m_zstd;
+		phase_timing m_write_output; // includes computing image stats, if enabled
+
+		uint32_t m_total_threads;
+		uint64_t m_peak_memory_usage; // process-wide high water mark, in bytes
+		uint32_t m_total_slices;
+		uint32_t m_total_blocks;
+		uint32_t m_total_endpoint_clusters;
+		uint32_t m_total_selector_clusters;
+		uint64_t m_output_file_size;
+		bool m_cache_hit;
+	};
+
 	template<bool def>
 	struct bool_param
 	{
@@ -222,6 +310,8 @@ namespace basisu
 			m_rdo_uastc_smooth_block_max_std_dev(UASTC_RDO_DEFAULT_MAX_SMOOTH_BLOCK_STD_DEV, .01f, 65536.0f),
 			m_rdo_uastc_max_allowed_rms_increase_ratio(UASTC_RDO_DEFAULT_MAX_ALLOWED_RMS_INCREASE_RATIO, .01f, 100.0f),
 			m_rdo_uastc_skip_block_rms_thresh(UASTC_RDO_DEFAULT_SKIP_BLOCK_RMS_THRESH, .01f, 100.0f),
+			m_rdo_uastc_target_bitrate(0.0f, 0.0f, 128.0f),
+			m_rdo_uastc_target_size(0, 0, INT_MAX),
 			m_resample_width(0, 1, 16384),
 			m_resample_height(0, 1, 16384),
 			m_resample_factor(0.0f, .00125f, 100.0f),
@@ -229,6 +319,9 @@ namespace basisu
 			m_resample_filter_scale(1.0f, .000125f, 4.0f),
 			m_ktx2_uastc_supercompression(basist::KTX2_SS_NONE),
 			m_ktx2_zstd_supercompression_level(6, INT_MIN, INT_MAX),
+			m_uastc_streaming_strip_height(256, 4, 16384),
+			m_cache_max_size(BASISU_DEFAULT_ENCODE_CACHE_MAX_SIZE),
+			m_validation_mode(cValidationFull),
 			m_pJob_pool(nullptr)
 		{
 			clear();
@@ -271,6 +364,7 @@ namespace basisu
 			m_swizzle[2] = 2;
 			m_swizzle[3] = 3;
 			m_renormalize.clear();
+			m_high_precision_source.clear();
 			m_hybrid_sel_cb_quality_thresh.clear();
 			m_global_pal_bits.clear();
 			m_global_mod_bits.clear();
@@ -298,6 +392,7 @@ namespace basisu
 			m_userdata0 = 0;
 			m_userdata1 = 0;
 			m_us_per_frame = 0;
+			m_video_iframe_interval = 0;
 
 			m_pack_uastc_flags = cPackUASTCLevelDefault;
 			m_rdo_uastc.clear();
@@ -308,6 +403,9 @@ namespace basisu
 			m_rdo_uastc_skip_block_rms_thresh.clear();
 			m_rdo_uastc_favor_simpler_modes_in_rdo_mode.clear();
 			m_rdo_uastc_multithreading.clear();
+			m_rdo_uastc_target_bitrate.clear();
+			m_rdo_uastc_target_size.clear();
+			m_rdo_uastc_zstd_cost_model.clear();
 
 			m_resample_width.clear();
 			m_resample_height.clear();
@@ -325,6 +423,14 @@ namespace basisu
 			m_ktx2_zstd_supercompression_level.clear();
 			m_ktx2_srgb_transfer_func.clear();
 
+			m_uastc_streaming.clear();
+			m_uastc_streaming_strip_height.clear();
+
+			m_cache_dir.clear();
+			m_cache_max_size = BASISU_DEFAULT_ENCODE_CACHE_MAX_SIZE;
+
+			m_validation_mode = cValidationFull;
+
 			m_pJob_pool = nullptr;
 		}
 				
@@ -404,6 +510,10 @@ namespace basisu
 
 		bool_param<false> m_renormalize;
 
+		// Read 16-bit PNG's at full precision, and do alpha merging, renormalization, swizzling, resampling and mipmap generation on float 
+		// images. Each mip level is only quantized to 8-bits once, just before it's compressed. 8-bit source images are converted to float.
+		bool_param<false> m_high_precision_source;
+
 		bool_param<false> m_disable_hierarchical_endpoint_codebooks;
 
 		// Global/hybrid selector codebook parameters
@@ -435,6 +545,10 @@ namespace basisu
 		uint32_t m_userdata1;
 		uint32_t m_us_per_frame;
 
+		// Video only: if non-zero, every m_video_iframe_interval'th frame (starting with the first) is coded as an I-Frame, which doesn't reference the previous frame.
+		// Transcoders can then seek to any frame by starting at the closest I-Frame before it. If 0 only the first frame is an I-Frame.
+		uint32_t m_video_iframe_interval;
+
 		// cPackUASTCLevelDefault, etc.
 		uint32_t m_pack_uastc_flags;
 		bool_param<false> m_rdo_uastc;
@@ -447,6 +561,15 @@ namespace basisu
 		bool_param<true> m_rdo_uastc_favor_simpler_modes_in_rdo_mode;
 		bool_param<true> m_rdo_uastc_multithreading;
 
+		// UASTC RDO rate control. If m_rdo_uastc is true and either of these is > 0, m_rdo_uastc_quality_scalar is ignored and the compressor searches for the lambda
+		// which gets the LZ compressed UASTC data closest to (but not over) the target. The compressed size is measured with Zstd at m_ktx2_zstd_supercompression_level
+		// when writing Zstd supercompressed .KTX2 files, otherwise with Deflate. m_rdo_uastc_target_size (in bytes) takes precedence over m_rdo_uastc_target_bitrate.
+		param<float> m_rdo_uastc_target_bitrate;
+		param<int> m_rdo_uastc_target_size;
+
+		// If true, UASTC RDO estimates match costs for Zstd (which codes matches at its 3 most recently used offsets cheaply) instead of Deflate.
+		bool_param<false> m_rdo_uastc_zstd_cost_model;
+
 		param<int> m_resample_width;
 		param<int> m_resample_height;
 		param<float> m_resample_factor;
@@ -464,6 +587,27 @@ namespace basisu
 		param<int> m_ktx2_zstd_supercompression_level;
 		bool_param<false> m_ktx2_srgb_transfer_func;
 
+		// UASTC streaming parameters.
+		// If true, process() encodes a single 2D image (no mipmaps) to UASTC m_uastc_streaming_strip_height texel rows at a time, writing each strip 
+		// straight to the .KTX2 file m_out_filename (optionally Zstd supercompressed), so the peak memory use doesn't grow with the size of the output.
+		// m_create_ktx2_file and m_write_output_basis_files must be true. Stats, debug images, UASTC RDO rate control and the encode cache aren't 
+		// supported. UASTC RDO runs on each strip independently.
+		bool_param<false> m_uastc_streaming;
+		param<int> m_uastc_streaming_strip_height;
+
+		// Encode cache parameters.
+		// If m_cache_dir isn't empty, process() first looks for a previously compressed output file in this directory, keyed by a hash of the source
+		// images (or source file contents) and all parameters which affect the output. On a miss the output is added to the cache.
+		// The cache is bypassed when m_compute_stats or m_debug_images are enabled, because those need the full compression pipeline to run.
+		std::string m_cache_dir;
+		
+		// Least recently used entries are evicted once the cache directory's entries exceed this many bytes. 0=unlimited.
+		uint64_t m_cache_max_size;
+
+		// Post-encode validation of the output file. m_compute_stats and m_debug_images need the fully transcoded slices, so they always use cValidationFull.
+		// The slices are transcoded in parallel when m_multithreading is true.
+		basis_validation_mode m_validation_mode;
+
 		job_pool *m_pJob_pool;
 	};
 	
@@ -505,6 +649,12 @@ namespace basisu
 		double get_basis_bits_per_texel() const { return m_basis_bits_per_texel; }
 		
 		bool get_any_source_image_has_alpha() const { return m_any_source_image_has_alpha; }
+
+		// True if the last call to process() returned an output file from the encode cache.
+		bool get_cache_hit() const { return m_cache_hit; }
+
+		// Timings and counters from the last call to process(), valid even if it failed.
+		const basis_compressor_perf_stats &get_perf_stats() const { return m_perf_stats; }
 								
 	private:
 		basis_compressor_params m_params;
@@ -546,20 +696,94 @@ namespace basisu
 
 		bool m_any_source_image_has_alpha;
 
+		// Size of the .KTX2 file written by process_uastc_streaming(), which isn't kept in m_output_ktx2_file.
+		uint64_t m_streamed_output_file_size;
+
+		encode_cache m_cache;
+		hash128 m_cache_key;
+		bool m_cache_hit;
+
+		basis_compressor_perf_stats m_perf_stats;
+
+		// One slice created from a source image by create_source_slices(), already enlarged to 4x4 block boundaries.
+		struct source_slice
+		{
+			image m_image;
+			uint32_t m_orig_width, m_orig_height;
+			uint32_t m_mip_index;
+			bool m_alpha;
+		};
+
+		error_code process_internal();
+		bool get_source_resample_size(uint32_t src_width, uint32_t src_height, int &new_width, int &new_height) const;
+		bool read_source_image(uint32_t source_file_index, image &file_image, imagef *pFile_image_hp, std::string &source_filename, bool &has_alpha, job_pool *pJob_pool);
+		bool create_source_slices(uint32_t source_file_index, const image &file_image, const imagef *pFile_image_hp, std::vector<source_slice> &out_slices, job_pool *pJob_pool);
 		bool read_source_images();
 		bool extract_source_blocks();
 		bool process_frontend();
 		bool extract_frontend_texture_data();
 		bool process_backend();
 		bool create_basis_file_and_transcode();
+		bool transcode_output_slices(const basist::basisu_transcoder &decoder, bool transcode_bc7, bool unpack);
+		bool validate_sampled_uastc_blocks();
 		bool write_output_files_and_compute_stats();
 		error_code encode_slices_to_uastc();
-		bool generate_mipmaps(const image &img, basisu::vector<image> &mips, bool has_alpha);
+		error_code process_uastc_streaming();
+		error_code encode_uastc_strips(const image& source_image, bool zstd_supercompression, FILE* pFile, uint64_t& level_byte_length);
+		size_t get_lz_compressed_size(const void* pData, size_t data_size) const;
+		float find_uastc_rdo_lambda(const uastc_rdo_params& rdo_params, uint32_t total_rdo_jobs, float target_bitrate);
+		// If pJob_pool is not nullptr the levels are resampled in parallel.
+		bool generate_mipmaps(const image &img, basisu::vector<image> &mips, bool has_alpha, job_pool *pJob_pool);
+		bool generate_mipmaps(const imagef &img, basisu::vector<imagef> &mips, bool has_alpha, job_pool *pJob_pool);
 		bool validate_texture_type_constraints();
 		bool validate_ktx2_constraints();
 		void get_dfd(uint8_vec& dfd, const basist::ktx2_header& hdr);
+		bool create_ktx2_file_prefix(basist::ktx2_header& header, uint32_t total_levels, const uint8_vec& etc1s_global_data, uint8_vec& out_file);
 		bool create_ktx2_file();
+		bool compute_cache_key(hash128& key);
+		bool read_from_cache();
+		void add_to_cache();
 	};
 
+	// Results of one of basis_parallel_compress()'s compressions.
+	struct parallel_results
+	{
+		parallel_results() { clear(); }
+
+		void clear()
+		{
+			m_total_time = 0.0f;
+			m_error_code = basis_compressor::cECFailedValidating;
+			m_basis_file.clear();
+			m_ktx2_file.clear();
+			m_stats.clear();
+			m_basis_bits_per_texel = 0.0f;
+			m_any_source_image_has_alpha = false;
+			m_perf_stats.clear();
+		}
+
+		double m_total_time;
+		basis_compressor::error_code m_error_code;
+		uint8_vec m_basis_file;
+		uint8_vec m_ktx2_file;
+		std::vector<image_stats> m_stats; // std::vector, so relocating the results doesn't instantiate a bitwise copy of image_stats (which has a std::string)
+		double m_basis_bits_per_texel;
+		bool m_any_source_image_has_alpha;
+
+		// Valid even if the compression failed.
+		basis_compressor_perf_stats m_perf_stats;
+	};
+
+	// Compresses every entry of params_vec with its own basis_compressor, running up to total_threads of them at once. Each compressor is single threaded
+	// (the params' m_pJob_pool is ignored), which scales much better than multithreading one compressor when there are many independent inputs.
+	// Returns false if any compression failed, check the m_error_code of each result.
+	bool basis_parallel_compress(uint32_t total_threads, const basisu::vector<basis_compressor_params>& params_vec, basisu::vector<parallel_results>& results_vec);
+
+	// Splits an ETC1S or UASTC video (m_tex_type must be cBASISTexTypeVideoFrames) into groups of pictures (GOPs) of up to gop_size consecutive frames, 
+	// to be compressed independently, for example with basis_parallel_compress(). Each group has its own codebooks and starts with an I-frame, so it can be 
+	// decoded (and seeked to) without the others: frame N of the video is frame N % gop_size of group N / gop_size.
+	// If params.m_out_filename is set, group i's output filename is that filename with "_gop" and i (as 4 digits) inserted before the extension.
+	bool basis_split_video_gops(const basis_compressor_params& params, uint32_t gop_size, basisu::vector<basis_compressor_params>& gop_params_vec);
+
 } // namespace basisu
 
@@ -23,10 +23,23 @@
 #include "jpgd.h"
 #include <vector>
 
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "basisu_miniz.h"
+
+#if BASISU_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #if defined(_WIN32)
 // For QueryPerformanceCounter/QueryPerformanceFrequency
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+// For GetProcessMemoryInfo
+#include <psapi.h>
+#else
+// For getrusage
+#include <sys/resource.h>
 #endif
 
 namespace basisu
@@ -282,6 +295,53 @@ namespace basisu
 			init();
 		return ticks * g_timer_freq;
 	}
+
+	double get_process_cpu_time_secs()
+	{
+#if defined(_WIN32)
+		FILETIME creation_time, exit_time, kernel_time, user_time;
+		if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+			return 0.0f;
+
+		// FILETIME's are in 100ns units
+		const uint64_t kernel_ticks = ((uint64_t)kernel_time.dwHighDateTime << 32U) | kernel_time.dwLowDateTime;
+		const uint64_t user_ticks = ((uint64_t)user_time.dwHighDateTime << 32U) | user_time.dwLowDateTime;
+		return (double)(kernel_ticks + user_ticks) * .0000001f;
+#elif defined(__EMSCRIPTEN__)
+		return 0.0f;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0.0f;
+
+		return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * .000001f;
+#endif
+	}
+
+	uint64_t get_peak_memory_usage()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return 0;
+
+		return counters.PeakWorkingSetSize;
+#elif defined(__EMSCRIPTEN__)
+		return 0;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return 0;
+
+#if defined(__APPLE__)
+		// Bytes on OSX
+		return (uint64_t)usage.ru_maxrss;
+#else
+		// Kilobytes on Linux/BSD
+		return (uint64_t)usage.ru_maxrss * 1024U;
+#endif
+#endif
+	}
 		
 	const uint32_t MAX_32BIT_ALLOC_SIZE = 250000000;
 
@@ -390,6 +450,54 @@ namespace basisu
 		return true;
 	}
 
+	// lodepng custom_zlib callback which inflates the PNG's IDAT data with miniz's tinfl, which is considerably faster than lodepng's inflater.
+	// custom_context points to the expected decompressed IDAT size, so the output buffer is only allocated once. lodepng also calls this for its other 
+	// zlib streams (iCCP, zTXt and iTXt chunks), which can be larger than the IDAT data, so if tinfl fails the stream is inflated again by lodepng.
+	static unsigned png_tinfl_decompress(unsigned char** out, size_t* outsize, const unsigned char* in, size_t insize, const LodePNGDecompressSettings* settings)
+	{
+		const size_t expected_size = *static_cast<const size_t*>(settings->custom_context);
+
+		// lodepng allocates and frees this buffer with realloc()/free().
+		unsigned char* pBuf = static_cast<unsigned char*>(realloc(*out, maximum<size_t>(expected_size, 1)));
+		if (!pBuf)
+			return 83;
+		*out = pBuf;
+
+		// tinfl always verifies the Adler-32 checksum when parsing the zlib header.
+		const size_t result = buminiz::tinfl_decompress_mem_to_mem(pBuf, expected_size, in, insize, buminiz::TINFL_FLAG_PARSE_ZLIB_HEADER);
+		if (result != TINFL_DECOMPRESS_MEM_TO_MEM_FAILED)
+		{
+			*outsize = result;
+			return 0;
+		}
+
+		// The output didn't fit (or the stream is invalid, which lodepng will report).
+		free(*out);
+		*out = nullptr;
+		*outsize = 0;
+
+		return lodepng_zlib_decompress(out, outsize, in, insize, settings);
+	}
+
+	// Size of a PNG's decompressed IDAT data (the filtered scanlines), including the interlaced sub-images.
+	static size_t get_png_idat_size(uint32_t w, uint32_t h, const LodePNGColorMode& color, bool interlaced)
+	{
+		const uint32_t bpp = lodepng_get_bpp(&color);
+		auto get_raw_size = [bpp](uint32_t pw, uint32_t ph) { return (size_t)ph * (1 + ((size_t)pw * bpp + 7) / 8); };
+		
+		if (!interlaced)
+			return get_raw_size(w, h);
+
+		size_t total = get_raw_size((w + 7) >> 3, (h + 7) >> 3);
+		if (w > 4) total += get_raw_size((w + 3) >> 3, (h + 7) >> 3);
+		total += get_raw_size((w + 3) >> 2, (h + 3) >> 3);
+		if (w > 2) total += get_raw_size((w + 1) >> 2, (h + 3) >> 2);
+		total += get_raw_size((w + 1) >> 1, (h + 1) >> 2);
+		if (w > 1) total += get_raw_size((w + 0) >> 1, (h + 1) >> 1);
+		total += get_raw_size(w, h >> 1);
+		return total;
+	}
+
 	bool load_png(const uint8_t *pBuf, size_t buf_size, image &img, const char *pFilename)
 	{
 		if (!buf_size)
@@ -397,14 +505,13 @@ namespace basisu
 
 		unsigned err = 0, w = 0, h = 0;
 
+		lodepng::State state;
+		err = lodepng_inspect(&w, &h, &state, pBuf, buf_size);
+		if ((err != 0) || (!w) || (!h))
+			return false;
+
 		if (sizeof(void*) == sizeof(uint32_t))
 		{
-			// Inspect the image first on 32-bit builds, to see if the image would require too much memory.
-			lodepng::State state;
-			err = lodepng_inspect(&w, &h, &state, pBuf, buf_size);
-			if ((err != 0) || (!w) || (!h))
-				return false;
-
 			const uint32_t exepected_alloc_size = w * h * sizeof(uint32_t);
 
 			// If the file is too large on 32-bit builds then just bail now, to prevent causing a memory exception.
@@ -413,46 +520,180 @@ namespace basisu
 				error_printf("Image \"%s\" is too large (%ux%u) to process in a 32-bit build!\n", (pFilename != nullptr) ? pFilename : "<memory>", w, h);
 				return false;
 			}
+		}
+
+		const size_t idat_size = get_png_idat_size(w, h, state.info_png.color, state.info_png.interlace_method != 0);
+		state.decoder.zlibsettings.custom_zlib = png_tinfl_decompress;
+		state.decoder.zlibsettings.custom_context = &idat_size;
+
+		// Decode to the PNG's own color type, then convert straight into the image's pixels.
+		state.decoder.color_convert = 0;
 
-			w = h = 0;
+		unsigned char* pRaw = nullptr;
+		err = lodepng_decode(&pRaw, &w, &h, &state, pBuf, buf_size);
+		if ((err != 0) || (!w) || (!h))
+		{
+			free(pRaw);
+			return false;
 		}
 
-		std::vector<uint8_t> out;
-		err = lodepng::decode(out, w, h, pBuf, buf_size);
+		img.resize(w, h);
+
+		const LodePNGColorMode& color = state.info_raw;
+		const uint32_t total_pixels = w * h;
+		color_rgba* pDst = img.get_ptr();
+		const uint8_t* pSrc = pRaw;
+
+		if ((color.bitdepth == 8) && (!color.key_defined) && (color.colortype != LCT_PALETTE))
+		{
+			switch (color.colortype)
+			{
+			case LCT_RGBA:
+				memcpy(pDst, pSrc, total_pixels * sizeof(color_rgba));
+				break;
+			case LCT_RGB:
+				for (uint32_t i = 0; i < total_pixels; i++, pSrc += 3)
+					pDst[i].set_noclamp_rgba(pSrc[0], pSrc[1], pSrc[2], 255);
+				break;
+			case LCT_GREY_ALPHA:
+				for (uint32_t i = 0; i < total_pixels; i++, pSrc += 2)
+					pDst[i].set_noclamp_rgba(pSrc[0], pSrc[0], pSrc[0], pSrc[1]);
+				break;
+			default:
+				for (uint32_t i = 0; i < total_pixels; i++)
+					pDst[i].set_noclamp_rgba(pSrc[i], pSrc[i], pSrc[i], 255);
+				break;
+			}
+		}
+		else
+		{
+			// Palettized, 16-bit, less than 8-bit, or color keyed images.
+			LodePNGColorMode rgba_mode;
+			lodepng_color_mode_init(&rgba_mode);
+			rgba_mode.colortype = LCT_RGBA;
+			rgba_mode.bitdepth = 8;
+
+			err = lodepng_convert((unsigned char*)pDst, pRaw, &rgba_mode, &color, w, h);
+		}
+
+		free(pRaw);
+
+		return err == 0;
+	}
+		
+	bool load_png(const char* pFilename, image& img)
+	{
+		std::vector<uint8_t> buffer;
+		unsigned err = lodepng::load_file(buffer, std::string(pFilename));
+		if (err)
+			return false;
+
+
+		return load_png(buffer.data(), buffer.size(), img, pFilename);
+	}
+
+	bool load_png(const uint8_t *pBuf, size_t buf_size, imagef &img, const char *pFilename)
+	{
+		if (!buf_size)
+			return false;
+
+		unsigned err = 0, w = 0, h = 0;
+
+		lodepng::State state;
+		err = lodepng_inspect(&w, &h, &state, pBuf, buf_size);
 		if ((err != 0) || (!w) || (!h))
 			return false;
 
-		if (out.size() != (w * h * 4))
+		if (sizeof(void*) == sizeof(uint32_t))
+		{
+			const uint64_t expected_alloc_size = (uint64_t)w * h * sizeof(vec4F);
+			if (expected_alloc_size >= MAX_32BIT_ALLOC_SIZE)
+			{
+				error_printf("Image \"%s\" is too large (%ux%u) to process in a 32-bit build!\n", (pFilename != nullptr) ? pFilename : "<memory>", w, h);
+				return false;
+			}
+		}
+
+		const size_t idat_size = get_png_idat_size(w, h, state.info_png.color, state.info_png.interlace_method != 0);
+		state.decoder.zlibsettings.custom_zlib = png_tinfl_decompress;
+		state.decoder.zlibsettings.custom_context = &idat_size;
+
+		// Always decode to 16-bit RGBA. Lower bit depths are scaled up exactly (8-bit values are multiplied by 257), so v/65535 is the same as before.
+		state.info_raw.colortype = LCT_RGBA;
+		state.info_raw.bitdepth = 16;
+
+		unsigned char* pRaw = nullptr;
+		err = lodepng_decode(&pRaw, &w, &h, &state, pBuf, buf_size);
+		if ((err != 0) || (!w) || (!h))
+		{
+			free(pRaw);
 			return false;
+		}
 
 		img.resize(w, h);
 
-		memcpy(img.get_ptr(), &out[0], out.size());
+		// 16-bit PNG samples are big endian.
+		const uint8_t* pSrc = pRaw;
+		for (uint32_t y = 0; y < h; y++)
+		{
+			vec4F* pDst = &img(0, y);
+			for (uint32_t x = 0; x < w; x++, pSrc += 8)
+				pDst[x].set(((pSrc[0] << 8) | pSrc[1]) * (1.0f / 65535.0f), ((pSrc[2] << 8) | pSrc[3]) * (1.0f / 65535.0f),
+					((pSrc[4] << 8) | pSrc[5]) * (1.0f / 65535.0f), ((pSrc[6] << 8) | pSrc[7]) * (1.0f / 65535.0f));
+		}
+
+		free(pRaw);
 
 		return true;
 	}
-		
-	bool load_png(const char* pFilename, image& img)
+
+	bool load_png(const char* pFilename, imagef& img)
 	{
 		std::vector<uint8_t> buffer;
 		unsigned err = lodepng::load_file(buffer, std::string(pFilename));
 		if (err)
 			return false;
 
-
 		return load_png(buffer.data(), buffer.size(), img, pFilename);
 	}
 
 	bool load_jpg(const char *pFilename, image& img)
 	{
-		int width = 0, height = 0, actual_comps = 0;
-		uint8_t *pImage_data = jpgd::decompress_jpeg_image_from_file(pFilename, &width, &height, &actual_comps, 4, jpgd::jpeg_decoder::cFlagLinearChromaFiltering);
-		if (!pImage_data)
+		jpgd::jpeg_decoder_file_stream file_stream;
+		if (!file_stream.open(pFilename))
 			return false;
-		
-		img.init(pImage_data, width, height, 4);
-		
-		free(pImage_data);
+
+		jpgd::jpeg_decoder decoder(&file_stream, jpgd::jpeg_decoder::cFlagLinearChromaFiltering);
+		if (decoder.get_error_code() != jpgd::JPGD_SUCCESS)
+			return false;
+
+		if (decoder.begin_decoding() != jpgd::JPGD_SUCCESS)
+			return false;
+
+		const uint32_t width = decoder.get_width(), height = decoder.get_height();
+		const bool grayscale = (decoder.get_num_components() == 1);
+
+		// Decode directly into the image's rows. The decoder's color scanlines are already RGBA, grayscale scanlines are 8bpp.
+		img.resize(width, height);
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			const void* pScan_line = nullptr;
+			jpgd::uint scan_line_len = 0;
+			if (decoder.decode(&pScan_line, &scan_line_len) != jpgd::JPGD_SUCCESS)
+				return false;
+
+			color_rgba* pDst = &img(0, y);
+
+			if (grayscale)
+			{
+				const uint8_t* pSrc = static_cast<const uint8_t*>(pScan_line);
+				for (uint32_t x = 0; x < width; x++)
+					pDst[x].set_noclamp_rgba(pSrc[x], pSrc[x], pSrc[x], 255);
+			}
+			else
+				memcpy(pDst, pScan_line, width * sizeof(color_rgba));
+		}
 
 		return true;
 	}
@@ -478,6 +719,22 @@ namespace basisu
 		return false;
 	}
 	
+	bool load_image(const char* pFilename, imagef& img)
+	{
+		std::string ext(string_get_extension(std::string(pFilename)));
+
+		if (strcasecmp(ext.c_str(), "png") == 0)
+			return load_png(pFilename, img);
+
+		// No other supported format has more than 8 bits per component.
+		image temp;
+		if (!load_image(pFilename, temp))
+			return false;
+
+		img.set(temp, vec4F(1.0f / 255.0f));
+		return true;
+	}
+
 	bool save_png(const char* pFilename, const image &img, uint32_t image_save_flags, uint32_t grayscale_comp)
 	{
 		if (!img.get_total_pixels())
@@ -633,149 +890,386 @@ namespace basisu
 			return saturate(powf((s + .055f) * (1.0f/1.055f), 2.4f));
 	}
 
-	bool image_resample(const image &src, image &dst, bool srgb,
-		const char *pFilter, float filter_scale, 
-		bool wrapping,
-		uint32_t first_comp, uint32_t num_comps)
+	bool image_resampler::init(const image &src, image &dst, bool srgb, const char *pFilter, float filter_scale, bool wrapping,
+		uint32_t first_comp, uint32_t num_comps, uint32_t total_bands)
+	{
+		m_pSrc = &src;
+		m_pDst = &dst;
+		m_pSrcf = nullptr;
+		m_pDstf = nullptr;
+
+		m_src_w = src.get_width();
+		m_src_h = src.get_height();
+		m_dst_w = dst.get_width();
+		m_dst_h = dst.get_height();
+
+		return init_filters(srgb, pFilter, filter_scale, wrapping, first_comp, num_comps, total_bands);
+	}
+
+	bool image_resampler::init(const imagef &src, imagef &dst, bool srgb, const char *pFilter, float filter_scale, bool wrapping,
+		uint32_t first_comp, uint32_t num_comps, uint32_t total_bands)
+	{
+		m_pSrc = nullptr;
+		m_pDst = nullptr;
+		m_pSrcf = &src;
+		m_pDstf = &dst;
+
+		m_src_w = src.get_width();
+		m_src_h = src.get_height();
+		m_dst_w = dst.get_width();
+		m_dst_h = dst.get_height();
+
+		return init_filters(srgb, pFilter, filter_scale, wrapping, first_comp, num_comps, total_bands);
+	}
+
+	bool image_resampler::init_filters(bool srgb, const char *pFilter, float filter_scale, bool wrapping, uint32_t first_comp, uint32_t num_comps, uint32_t total_bands)
 	{
 		assert((first_comp + num_comps) <= 4);
 
-		const int cMaxComps = 4;
-				
-		const uint32_t src_w = src.get_width(), src_h = src.get_height();
-		const uint32_t dst_w = dst.get_width(), dst_h = dst.get_height();
-				
-		if (maximum(src_w, src_h) > BASISU_RESAMPLER_MAX_DIMENSION)
-		{
-			printf("Image is too large!\n");
+		if (!m_src_w || !m_src_h || !m_dst_w || !m_dst_h)
 			return false;
-		}
 
-		if (!src_w || !src_h || !dst_w || !dst_h)
-			return false;
-				
-		if ((num_comps < 1) || (num_comps > cMaxComps))
+		if ((num_comps < 1) || ((first_comp + num_comps) > 4))
 			return false;
-				
-		if ((minimum(dst_w, dst_h) < 1) || (maximum(dst_w, dst_h) > BASISU_RESAMPLER_MAX_DIMENSION))
+
+		m_first_comp = first_comp;
+		m_num_comps = num_comps;
+		m_srgb = srgb;
+
+		// Don't bother splitting the image into bands much smaller than this many rows.
+		const uint32_t cMinRowsPerBand = 16;
+		m_total_bands = clamp<uint32_t>(total_bands, 1, maximum<uint32_t>(1, m_dst_h / cMinRowsPerBand));
+
+		if (!pFilter)
+			pFilter = BASISU_RESAMPLER_DEFAULT_FILTER;
+
+		int filter_index;
+		for (filter_index = 0; filter_index < g_num_resample_filters; filter_index++)
+			if (strcmp(pFilter, g_resample_filters[filter_index].name) == 0)
+				break;
+
+		if (filter_index == g_num_resample_filters)
 		{
-			printf("Image is too large!\n");
+			error_printf("image_resampler::init: Unknown filter \"%s\"\n", pFilter);
 			return false;
 		}
 
-		if ((src_w == dst_w) && (src_h == dst_h))
+		const Resampler::Boundary_Op boundary_op = wrapping ? Resampler::BOUNDARY_WRAP : Resampler::BOUNDARY_CLAMP;
+
+		for (uint32_t axis = 0; axis < 2; axis++)
 		{
-			dst = src;
-			return true;
+			Resampler::Contrib_List *pList = Resampler::make_clist(axis ? m_src_h : m_src_w, axis ? m_dst_h : m_dst_w, boundary_op,
+				g_resample_filters[filter_index].func, g_resample_filters[filter_index].support, filter_scale, 0.0f);
+			if (!pList)
+				return false;
+
+			const uint32_t n = axis ? m_dst_h : m_dst_w;
+
+			uint_vec &ofs = axis ? m_y_ofs : m_x_ofs;
+			basisu::vector<contrib> &contribs = axis ? m_y_contribs : m_x_contribs;
+
+			ofs.resize(n + 1);
+			contribs.resize(0);
+
+			for (uint32_t i = 0; i < n; i++)
+			{
+				ofs[i] = (uint32_t)contribs.size();
+
+				for (uint32_t j = 0; j < pList[i].n; j++)
+				{
+					contrib c;
+					c.m_weight = pList[i].p[j].weight;
+					c.m_pixel = pList[i].p[j].pixel;
+					contribs.push_back(c);
+				}
+			}
+			ofs[n] = (uint32_t)contribs.size();
+
+			free(pList->p);
+			free(pList);
 		}
 
-		float srgb_to_linear_table[256];
-		if (srgb)
+		// Determine which axis to resample first by comparing the number of multiplies required for each possibility, exactly like the
+		// Resampler class does (Y axis ops are weighted a little more), so both produce the same results.
+		const uint64_t x_ops = m_x_contribs.size(), y_ops = m_y_contribs.size();
+		const uint64_t xy_ops = x_ops * m_src_h + (4 * y_ops * m_dst_w) / 3;
+		const uint64_t yx_ops = (4 * y_ops * m_src_w) / 3 + x_ops * m_dst_h;
+
+		m_delay_x_resample = (xy_ops > yx_ops) || ((xy_ops == yx_ops) && (m_src_w < m_dst_w));
+
+		if ((srgb) && (m_pSrc))
 		{
 			for (int i = 0; i < 256; ++i)
-				srgb_to_linear_table[i] = srgb_to_linear((float)i * (1.0f/255.0f));
+				m_srgb_to_linear[i] = srgb_to_linear((float)i * (1.0f/255.0f));
+
+			for (int i = 0; i < cLinearToSRGBTableSize; ++i)
+				m_linear_to_srgb[i] = (uint8_t)clamp<int>((int)(255.0f * linear_to_srgb((float)i * (1.0f / (cLinearToSRGBTableSize - 1))) + .5f), 0, 255);
 		}
 
-		const int LINEAR_TO_SRGB_TABLE_SIZE = 8192;
-		uint8_t linear_to_srgb_table[LINEAR_TO_SRGB_TABLE_SIZE];
+		return true;
+	}
 
-		if (srgb)
+	// Converts a source row to interleaved linear RGBA samples.
+	void image_resampler::get_source_row(uint32_t y, float *pDst) const
+	{
+		if (m_pSrcf)
 		{
-			for (int i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; ++i)
-				linear_to_srgb_table[i] = (uint8_t)clamp<int>((int)(255.0f * linear_to_srgb((float)i * (1.0f / (LINEAR_TO_SRGB_TABLE_SIZE - 1))) + .5f), 0, 255);
+			const vec4F *pSrc = &(*m_pSrcf)(0, y);
+
+			for (uint32_t x = 0; x < m_src_w; x++, pSrc++, pDst += 4)
+			{
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					const float v = (*pSrc)[c];
+					pDst[c] = (!m_srgb || (c == 3)) ? v : srgb_to_linear(v);
+				}
+			}
+			return;
 		}
 
-		std::vector<float> samples[cMaxComps];
-		Resampler *resamplers[cMaxComps];
-		
-		resamplers[0] = new Resampler(src_w, src_h, dst_w, dst_h,
-			wrapping ? Resampler::BOUNDARY_WRAP : Resampler::BOUNDARY_CLAMP, 0.0f, 1.0f,
-			pFilter, nullptr, nullptr, filter_scale, filter_scale, 0, 0);
-		samples[0].resize(src_w);
+		const color_rgba *pSrc = &(*m_pSrc)(0, y);
 
-		for (uint32_t i = 1; i < num_comps; ++i)
+		for (uint32_t x = 0; x < m_src_w; x++, pSrc++, pDst += 4)
 		{
-			resamplers[i] = new Resampler(src_w, src_h, dst_w, dst_h,
-				wrapping ? Resampler::BOUNDARY_WRAP : Resampler::BOUNDARY_CLAMP, 0.0f, 1.0f,
-				pFilter, resamplers[0]->get_clist_x(), resamplers[0]->get_clist_y(), filter_scale, filter_scale, 0, 0);
-			samples[i].resize(src_w);
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const uint32_t v = (*pSrc)[c];
+
+				if (!m_srgb || (c == 3))
+					pDst[c] = v * (1.0f / 255.0f);
+				else
+					pDst[c] = m_srgb_to_linear[v];
+			}
 		}
+	}
 
-		uint32_t dst_y = 0;
+	void image_resampler::resample_x(float *pDst, const float *pSrc) const
+	{
+		const contrib *pContribs = m_x_contribs.data();
 
-		for (uint32_t src_y = 0; src_y < src_h; ++src_y)
+		for (uint32_t x = 0; x < m_dst_w; x++, pDst += 4)
 		{
-			const color_rgba *pSrc = &src(0, src_y);
+			float t0 = 0.0f, t1 = 0.0f, t2 = 0.0f, t3 = 0.0f;
 
-			// Put source lines into resampler(s)
-			for (uint32_t x = 0; x < src_w; ++x)
+			for (uint32_t i = m_x_ofs[x]; i < m_x_ofs[x + 1]; i++)
 			{
-				for (uint32_t c = 0; c < num_comps; ++c)
-				{
-					const uint32_t comp_index = first_comp + c;
-					const uint32_t v = (*pSrc)[comp_index];
+				const float w = pContribs[i].m_weight;
+				const float *s = pSrc + pContribs[i].m_pixel * 4;
 
-					if (!srgb || (comp_index == 3))
-						samples[c][x] = v * (1.0f / 255.0f);
-					else
-						samples[c][x] = srgb_to_linear_table[v];
-				}
-
-				pSrc++;
+				t0 += s[0] * w;
+				t1 += s[1] * w;
+				t2 += s[2] * w;
+				t3 += s[3] * w;
 			}
 
-			for (uint32_t c = 0; c < num_comps; ++c)
+			pDst[0] = t0;
+			pDst[1] = t1;
+			pDst[2] = t2;
+			pDst[3] = t3;
+		}
+	}
+
+	void image_resampler::write_row(uint32_t y, float *pSamples) const
+	{
+		if (m_pDstf)
+		{
+			vec4F *pDst = &(*m_pDstf)(0, y);
+
+			for (uint32_t x = 0; x < m_dst_w; x++, pDst++, pSamples += 4)
 			{
-				if (!resamplers[c]->put_line(&samples[c][0]))
+				for (uint32_t c = 0; c < m_num_comps; ++c)
 				{
-					for (uint32_t i = 0; i < num_comps; i++)
-						delete resamplers[i];
-					return false;
+					const uint32_t comp_index = m_first_comp + c;
+
+					const float v = saturate(pSamples[comp_index]);
+					(*pDst)[comp_index] = (!m_srgb || (comp_index == 3)) ? v : linear_to_srgb(v);
 				}
 			}
+			return;
+		}
+
+		color_rgba *pDst = &(*m_pDst)(0, y);
 
-			// Now retrieve any output lines
-			for (;;)
+		for (uint32_t x = 0; x < m_dst_w; x++, pDst++, pSamples += 4)
+		{
+			for (uint32_t c = 0; c < m_num_comps; ++c)
 			{
-				uint32_t c;
-				for (c = 0; c < num_comps; ++c)
+				const uint32_t comp_index = m_first_comp + c;
+
+				float v = pSamples[comp_index];
+				if (v < 0.0f)
+					v = 0.0f;
+				else if (v > 1.0f)
+					v = 1.0f;
+
+				// TODO: Add dithering
+				if (!m_srgb || (comp_index == 3))
 				{
-					const uint32_t comp_index = first_comp + c;
+					int j = (int)(255.0f * v + .5f);
+					(*pDst)[comp_index] = (uint8_t)clamp<int>(j, 0, 255);
+				}
+				else
+				{
+					int j = (int)((cLinearToSRGBTableSize - 1) * v + .5f);
+					(*pDst)[comp_index] = m_linear_to_srgb[clamp<int>(j, 0, cLinearToSRGBTableSize - 1)];
+				}
+			}
+		}
+	}
+
+	void image_resampler::resample_band(uint32_t band_index)
+	{
+		assert(band_index < m_total_bands);
+
+		const uint32_t rows_per_band = (m_dst_h + m_total_bands - 1) / m_total_bands;
+		const uint32_t first_dst_y = band_index * rows_per_band;
+		const uint32_t last_dst_y = minimum(m_dst_h, first_dst_y + rows_per_band);
+		if (first_dst_y >= last_dst_y)
+			return;
+
+		// Each cached row holds a source row, either converted to linear (Y-X order) or already resampled on the X axis (X-Y order).
+		// Rows are cached only while any of this band's output rows still need them.
+		const uint32_t row_size = (m_delay_x_resample ? m_src_w : m_dst_w) * 4;
+
+		uint_vec src_row_uses(m_src_h, 0);
+		for (uint32_t i = m_y_ofs[first_dst_y]; i < m_y_ofs[last_dst_y]; i++)
+			src_row_uses[m_y_contribs[i].m_pixel]++;
 
-					const float *pOutput_samples = resamplers[c]->get_line();
-					if (!pOutput_samples)
-						break;
+		int_vec src_row_slot(m_src_h, -1);
+		uint_vec free_slots;
+		uint32_t total_slots = 0;
 
-					const bool linear_flag = !srgb || (comp_index == 3);
-					
-					color_rgba *pDst = &dst(0, dst_y);
+		basisu::vector<float> slots;
+		basisu::vector<float> src_row(m_delay_x_resample ? 0 : (m_src_w * 4));
+		basisu::vector<float> accum(row_size);
+		basisu::vector<float> dst_row(m_dst_w * 4);
 
-					for (uint32_t x = 0; x < dst_w; x++)
+		for (uint32_t dst_y = first_dst_y; dst_y < last_dst_y; dst_y++)
+		{
+			for (uint32_t i = m_y_ofs[dst_y]; i < m_y_ofs[dst_y + 1]; i++)
+			{
+				const uint32_t src_y = m_y_contribs[i].m_pixel;
+				const float w = m_y_contribs[i].m_weight;
+
+				int slot = src_row_slot[src_y];
+				if (slot < 0)
+				{
+					if (free_slots.size())
 					{
-						// TODO: Add dithering
-						if (linear_flag)
-						{
-							int j = (int)(255.0f * pOutput_samples[x] + .5f);
-							(*pDst)[comp_index] = (uint8_t)clamp<int>(j, 0, 255);
-						}
-						else
-						{
-							int j = (int)((LINEAR_TO_SRGB_TABLE_SIZE - 1) * pOutput_samples[x] + .5f);
-							(*pDst)[comp_index] = linear_to_srgb_table[clamp<int>(j, 0, LINEAR_TO_SRGB_TABLE_SIZE - 1)];
-						}
+						slot = free_slots.back();
+						free_slots.pop_back();
+					}
+					else
+					{
+						slot = total_slots++;
+						slots.resize(total_slots * row_size);
+					}
+
+					src_row_slot[src_y] = slot;
 
-						pDst++;
+					if (m_delay_x_resample)
+						get_source_row(src_y, &slots[slot * row_size]);
+					else
+					{
+						get_source_row(src_y, src_row.data());
+						resample_x(&slots[slot * row_size], src_row.data());
 					}
 				}
-				if (c < num_comps)
-					break;
 
-				++dst_y;
+				const float *pRow = &slots[slot * row_size];
+				float *pAccum = accum.data();
+
+				if (i == m_y_ofs[dst_y])
+				{
+					for (uint32_t j = 0; j < row_size; j++)
+						pAccum[j] = pRow[j] * w;
+				}
+				else
+				{
+					for (uint32_t j = 0; j < row_size; j++)
+						pAccum[j] += pRow[j] * w;
+				}
+
+				if (--src_row_uses[src_y] == 0)
+				{
+					src_row_slot[src_y] = -1;
+					free_slots.push_back(slot);
+				}
+			}
+
+			if (m_delay_x_resample)
+			{
+				resample_x(dst_row.data(), accum.data());
+				write_row(dst_y, dst_row.data());
 			}
+			else
+				write_row(dst_y, accum.data());
+		}
+	}
+
+	void image_resampler::add_jobs(job_pool &jpool)
+	{
+		for (uint32_t band_index = 0; band_index < m_total_bands; band_index++)
+			jpool.add_job([this, band_index] { resample_band(band_index); });
+	}
+
+	void image_resampler::resample(job_pool *pJob_pool)
+	{
+		if ((pJob_pool) && (m_total_bands > 1))
+		{
+			add_jobs(*pJob_pool);
+			pJob_pool->wait_for_all();
+		}
+		else
+		{
+			for (uint32_t band_index = 0; band_index < m_total_bands; band_index++)
+				resample_band(band_index);
+		}
+	}
+
+	bool image_resample(const image &src, image &dst, bool srgb,
+		const char *pFilter, float filter_scale, 
+		bool wrapping,
+		uint32_t first_comp, uint32_t num_comps,
+		job_pool *pJob_pool)
+	{
+		if ((src.get_width() == dst.get_width()) && (src.get_height() == dst.get_height()))
+		{
+			dst = src;
+			return true;
+		}
+
+		// A few bands per thread, so threads that finish early can pick up more work.
+		const uint32_t total_bands = pJob_pool ? (uint32_t)pJob_pool->get_total_threads() * 4 : 1;
+
+		image_resampler resampler;
+		if (!resampler.init(src, dst, srgb, pFilter, filter_scale, wrapping, first_comp, num_comps, total_bands))
+			return false;
+
+		resampler.resample(pJob_pool);
+
+		return true;
+	}
+
+	bool image_resample(const imagef &src, imagef &dst, bool srgb,
+		const char *pFilter, float filter_scale,
+		bool wrapping,
+		uint32_t first_comp, uint32_t num_comps,
+		job_pool *pJob_pool)
+	{
+		if ((src.get_width() == dst.get_width()) && (src.get_height() == dst.get_height()))
+		{
+			dst = src;
+			return true;
 		}
 
-		for (uint32_t i = 0; i < num_comps; ++i)
-			delete resamplers[i];
+		const uint32_t total_bands = pJob_pool ? (uint32_t)pJob_pool->get_total_threads() * 4 : 1;
+
+		image_resampler resampler;
+		if (!resampler.init(src, dst, srgb, pFilter, filter_scale, wrapping, first_comp, num_comps, total_bands))
+			return false;
+
+		resampler.resample(pJob_pool);
 
 		return true;
 	}
@@ -1406,50 +1900,187 @@ namespace basisu
 		return which_side;
 	}
 
-	void image_metrics::calc(const image &a, const image &b, uint32_t first_chan, uint32_t total_chans, bool avg_comp_error, bool use_601_luma)
+	// The error totals of a band of rows. They're all integers, so adding up the bands doesn't depend on the order they finished in.
+	struct image_error_totals
 	{
-		assert((first_chan < 4U) && (first_chan + total_chans <= 4U));
+		uint64_t m_sum, m_sum_sq;
+		uint32_t m_max;
+	};
 
-		const uint32_t width = basisu::minimum(a.get_width(), b.get_width());
-		const uint32_t height = basisu::minimum(a.get_height(), b.get_height());
+#if BASISU_USE_SSE2
+	// Luma of the 4 pixels in v, in the low 16 bits of each 32-bit lane. The green weight is split in two because it doesn't fit in a signed 16-bit multiplier.
+	static inline __m128i calc_luma_sse2(__m128i v, __m128i rb_weights, __m128i g_weights, __m128i g_weights2)
+	{
+		const __m128i lo_mask = _mm_set1_epi32(0x00FF00FF);
+		const __m128i rb = _mm_and_si128(v, lo_mask), ga = _mm_and_si128(_mm_srli_epi32(v, 8), lo_mask);
+		const __m128i l = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(rb, rb_weights), _mm_madd_epi16(ga, g_weights)), _mm_madd_epi16(ga, g_weights2));
+		return _mm_srli_epi32(_mm_add_epi32(l, _mm_set1_epi32(32768)), 16);
+	}
+#endif
 
-		double hist[256];
-		clear_obj(hist);
+	// Sums the absolute errors (and their squares) of rows [first_y, last_y), and finds the largest error.
+	static void calc_error_totals(const image &a, const image &b, uint32_t width, uint32_t first_y, uint32_t last_y, uint32_t first_chan, uint32_t total_chans, bool use_601_luma, image_error_totals &totals)
+	{
+		uint64_t sum = 0, sum_sq = 0;
+		uint32_t max_err = 0;
+
+#if BASISU_USE_SSE2
+		// Selects the bytes of the channels being compared.
+		uint8_t chan_mask_bytes[16];
+		for (uint32_t i = 0; i < 16; i++)
+			chan_mask_bytes[i] = (((i & 3) >= first_chan) && ((i & 3) < (first_chan + total_chans))) ? 0xFF : 0;
+		const __m128i chan_mask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(chan_mask_bytes));
+
+		const __m128i rb_weights = use_601_luma ? _mm_set1_epi32(19595 | (7471 << 16)) : _mm_set1_epi32(13938 | (4729 << 16));
+		const __m128i g_weights = use_601_luma ? _mm_set1_epi32(19235) : _mm_set1_epi32(23435);
+		const __m128i g_weights2 = use_601_luma ? _mm_set1_epi32(19235) : _mm_set1_epi32(23434);
+		const __m128i zero = _mm_setzero_si128();
+
+		__m128i max_v = zero;
+#endif
 
-		for (uint32_t y = 0; y < height; y++)
+		for (uint32_t y = first_y; y < last_y; y++)
 		{
-			for (uint32_t x = 0; x < width; x++)
+			const color_rgba *pA = &a(0, y), *pB = &b(0, y);
+
+			uint32_t x = 0;
+
+#if BASISU_USE_SSE2
+			// The 32-bit lane sums can't overflow within a chunk of this many pixels.
+			const uint32_t cChunkSize = 1024;
+
+			while ((x + 4) <= width)
 			{
-				const color_rgba &ca = a(x, y), &cb = b(x, y);
+				const uint32_t chunk_end = minimum(width, x + cChunkSize);
+
+				__m128i sum_v = zero, sum_sq_v = zero;
+
+				for (; (x + 4) <= chunk_end; x += 4)
+				{
+					const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pA + x));
+					const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pB + x));
+
+					if (total_chans)
+					{
+						const __m128i d = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)), chan_mask);
+
+						max_v = _mm_max_epu8(max_v, d);
+						sum_v = _mm_add_epi64(sum_v, _mm_sad_epu8(d, zero));
+
+						const __m128i d_lo = _mm_unpacklo_epi8(d, zero), d_hi = _mm_unpackhi_epi8(d, zero);
+						sum_sq_v = _mm_add_epi32(sum_sq_v, _mm_add_epi32(_mm_madd_epi16(d_lo, d_lo), _mm_madd_epi16(d_hi, d_hi)));
+					}
+					else
+					{
+						const __m128i la = calc_luma_sse2(va, rb_weights, g_weights, g_weights2);
+						const __m128i lb = calc_luma_sse2(vb, rb_weights, g_weights, g_weights2);
+						
+						// Both lumas are in [0,255], so the absolute difference fits in the low 16 bits of each lane.
+						const __m128i diff = _mm_sub_epi32(la, lb);
+						const __m128i sign = _mm_srai_epi32(diff, 31);
+						const __m128i d = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+						
+						max_v = _mm_max_epi16(max_v, d);
+						sum_v = _mm_add_epi32(sum_v, d);
+						sum_sq_v = _mm_add_epi32(sum_sq_v, _mm_madd_epi16(d, d));
+					}
+				}
+
+				uint32_t lanes[4];
+				if (total_chans)
+				{
+					uint64_t sums[2];
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(sums), sum_v);
+					sum += sums[0] + sums[1];
+				}
+				else
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sum_v);
+					sum += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sum_sq_v);
+				sum_sq += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+			}
+#endif
 
+			for (; x < width; x++)
+			{
 				if (total_chans)
 				{
 					for (uint32_t c = 0; c < total_chans; c++)
-						hist[iabs(ca[first_chan + c] - cb[first_chan + c])]++;
+					{
+						const uint32_t d = iabs(pA[x][first_chan + c] - pB[x][first_chan + c]);
+						sum += d;
+						sum_sq += d * d;
+						max_err = maximum(max_err, d);
+					}
 				}
 				else
 				{
-					if (use_601_luma)
-						hist[iabs(ca.get_601_luma() - cb.get_601_luma())]++;
-					else
-						hist[iabs(ca.get_709_luma() - cb.get_709_luma())]++;
+					const uint32_t d = use_601_luma ? iabs(pA[x].get_601_luma() - pB[x].get_601_luma()) : iabs(pA[x].get_709_luma() - pB[x].get_709_luma());
+					sum += d;
+					sum_sq += d * d;
+					max_err = maximum(max_err, d);
 				}
 			}
 		}
 
-		m_max = 0;
-		double sum = 0.0f, sum2 = 0.0f;
-		for (uint32_t i = 0; i < 256; i++)
+#if BASISU_USE_SSE2
+		uint8_t max_bytes[16];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(max_bytes), max_v);
+		for (uint32_t i = 0; i < 16; i++)
+			max_err = maximum<uint32_t>(max_err, max_bytes[i]);
+#endif
+
+		totals.m_sum = sum;
+		totals.m_sum_sq = sum_sq;
+		totals.m_max = max_err;
+	}
+
+	void image_metrics::calc(const image &a, const image &b, uint32_t first_chan, uint32_t total_chans, bool avg_comp_error, bool use_601_luma, job_pool *pJob_pool)
+	{
+		assert((first_chan < 4U) && (first_chan + total_chans <= 4U));
+
+		const uint32_t width = basisu::minimum(a.get_width(), b.get_width());
+		const uint32_t height = basisu::minimum(a.get_height(), b.get_height());
+
+		// A few bands per thread, but not so small that queuing them costs more than it saves.
+		const uint32_t cMinRowsPerBand = 16;
+		const uint32_t total_bands = pJob_pool ? clamp<uint32_t>((uint32_t)pJob_pool->get_total_threads() * 4, 1, maximum<uint32_t>(1, height / cMinRowsPerBand)) : 1;
+		const uint32_t rows_per_band = (height + total_bands - 1) / total_bands;
+
+		basisu::vector<image_error_totals> band_totals(total_bands);
+
+		if (total_bands > 1)
 		{
-			if (hist[i])
+			for (uint32_t band_index = 0; band_index < total_bands; band_index++)
 			{
-				m_max = basisu::maximum<float>(m_max, (float)i);
-				double v = i * hist[i];
-				sum += v;
-				sum2 += i * v;
+				pJob_pool->add_job([&, band_index] {
+					calc_error_totals(a, b, width, minimum(height, band_index * rows_per_band), minimum(height, (band_index + 1) * rows_per_band), 
+						first_chan, total_chans, use_601_luma, band_totals[band_index]);
+				});
 			}
+
+			pJob_pool->wait_for_all();
+		}
+		else
+		{
+			calc_error_totals(a, b, width, 0, height, first_chan, total_chans, use_601_luma, band_totals[0]);
+		}
+
+		uint64_t total_sum = 0, total_sum_sq = 0;
+		uint32_t max_err = 0;
+		for (uint32_t band_index = 0; band_index < total_bands; band_index++)
+		{
+			total_sum += band_totals[band_index].m_sum;
+			total_sum_sq += band_totals[band_index].m_sum_sq;
+			max_err = maximum(max_err, band_totals[band_index].m_max);
 		}
 
+		m_max = (float)max_err;
+		const double sum = (double)total_sum, sum2 = (double)total_sum_sq;
+
 		double total_values = (double)width * (double)height;
 		if (avg_comp_error)
 			total_values *= (double)clamp<uint32_t>(total_chans, 1, 4);
@@ -1538,7 +2169,8 @@ namespace basisu
 
 	job_pool::job_pool(uint32_t num_threads) : 
 		m_num_active_jobs(0),
-		m_kill_flag(false)
+		m_kill_flag(false),
+		m_total_job_ticks(0)
 	{
 		assert(num_threads >= 1U);
 
@@ -1579,6 +2211,9 @@ namespace basisu
 
 		if (queue_size > 1)
 			m_has_work.notify_one();
+
+		// Wake up any thread blocked in wait_for_all() so it can help with jobs added by other jobs.
+		m_no_more_jobs.notify_all();
 	}
 
 	void job_pool::add_job(std::function<void()>&& job)
@@ -1595,32 +2230,62 @@ namespace basisu
 		{
 			m_has_work.notify_one();
 		}
+
+		m_no_more_jobs.notify_all();
 	}
 
 	void job_pool::wait_for_all()
 	{
+		BASISU_TRACE_SCOPE("job_pool::wait_for_all", "job_pool");
+
 		std::unique_lock<std::mutex> lock(m_mutex);
 
-		// Drain the job queue on the calling thread.
-		while (!m_queue.empty())
+		// Jobs may add more jobs, so keep going until the queue is empty and no jobs are active.
+		while (true)
 		{
-			std::function<void()> job(m_queue.back());
-			m_queue.pop_back();
+			// Drain the job queue on the calling thread.
+			while (!m_queue.empty())
+			{
+				std::function<void()> job(m_queue.back());
+				m_queue.pop_back();
 
-			lock.unlock();
+				lock.unlock();
 
-			job();
+				execute_job(job);
 
-			lock.lock();
+				lock.lock();
+			}
+
+			if (!m_num_active_jobs)
+				break;
+
+			// The queue is empty, now wait for all active jobs to finish up (or for them to add more work we can help with).
+			BASISU_TRACE_SCOPE("job_pool::wait_for_active_jobs", "job_pool");
+			m_no_more_jobs.wait(lock, [this]{ return !m_num_active_jobs || !m_queue.empty(); } );
 		}
+	}
 
-		// The queue is empty, now wait for all active jobs to finish up.
-		m_no_more_jobs.wait(lock, [this]{ return !m_num_active_jobs; } );
+	double job_pool::get_total_job_time_secs() const
+	{
+		return interval_timer::ticks_to_secs(m_total_job_ticks);
+	}
+
+	void job_pool::execute_job(const std::function<void()>& job)
+	{
+		BASISU_TRACE_SCOPE("job", "job_pool");
+
+		const timer_ticks start_ticks = interval_timer::get_ticks();
+
+		job();
+
+		m_total_job_ticks += interval_timer::get_ticks() - start_ticks;
 	}
 
 	void job_pool::job_thread(uint32_t index)
 	{
 		debug_printf("job_pool::job_thread: starting %u\n", index);
+
+		BASISU_TRACE_SET_THREAD_NAME(string_format("job_pool worker %u", index));
 		
 		while (true)
 		{
@@ -1641,7 +2306,7 @@ namespace basisu
 
 			lock.unlock();
 
-			job();
+			execute_job(job);
 
 			lock.lock();
 
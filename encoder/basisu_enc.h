@@ -15,6 +15,7 @@
 #pragma once
 #include "../transcoder/basisu.h"
 #include "../transcoder/basisu_transcoder_internal.h"
+#include "../transcoder/basisu_trace.h"
 
 #include <mutex>
 #include <atomic>
@@ -33,6 +34,15 @@
 // If BASISU_USE_HIGH_PRECISION_COLOR_DISTANCE is 1, quality in perceptual mode will be slightly greater, but at a large increase in encoding CPU time.
 #define BASISU_USE_HIGH_PRECISION_COLOR_DISTANCE (0)
 
+// A few simple kernels (image metrics, SSIM) use SSE2 directly. It's always available on x64, so unlike BASISU_SUPPORT_SSE no runtime check is needed.
+#ifndef BASISU_USE_SSE2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define BASISU_USE_SSE2 (1)
+#else
+#define BASISU_USE_SSE2 (0)
+#endif
+#endif
+
 namespace basisu
 {
 	extern uint8_t g_hamming_dist[256];
@@ -518,9 +528,14 @@ namespace basisu
 		void add_job(const std::function<void()>& job);
 		void add_job(std::function<void()>&& job);
 
+		// Runs queued jobs on the calling thread until the queue is empty and no jobs are active. Jobs may add more jobs.
+		// Must not be called from inside a job.
 		void wait_for_all();
 
 		size_t get_total_threads() const { return 1 + m_threads.size(); }
+
+		// Total time spent executing jobs, summed across all threads (including jobs run by wait_for_all() on the calling thread).
+		double get_total_job_time_secs() const;
 		
 	private:
 		std::vector<std::thread> m_threads;
@@ -534,6 +549,10 @@ namespace basisu
 		
 		std::atomic<bool> m_kill_flag;
 
+		std::atomic<uint64_t> m_total_job_ticks;
+
+		void execute_job(const std::function<void()>& job);
+
 		void job_thread(uint32_t index);
 	};
 
@@ -2912,6 +2931,70 @@ namespace basisu
 
 		inline const vec4F *get_ptr() const { return &m_pixels[0]; }
 		inline vec4F *get_ptr() { return &m_pixels[0]; }
+
+		imagef &set_alpha(float a)
+		{
+			for (uint32_t y = 0; y < m_height; ++y)
+				for (uint32_t x = 0; x < m_width; ++x)
+					(*this)(x, y)[3] = a;
+			return *this;
+		}
+
+		imagef &flip_y()
+		{
+			for (uint32_t y = 0; y < m_height / 2; ++y)
+				for (uint32_t x = 0; x < m_width; ++x)
+					std::swap((*this)(x, y), (*this)(x, m_height - 1 - y));
+			return *this;
+		}
+
+		// Same as image::renormalize_normal_map(), but on [0,1] components so nothing is quantized.
+		imagef &renormalize_normal_map()
+		{
+			for (uint32_t y = 0; y < m_height; y++)
+			{
+				for (uint32_t x = 0; x < m_width; x++)
+				{
+					vec4F &c = (*this)(x, y);
+
+					vec3F v(c[0], c[1], c[2]);
+					v = (v * 2.0f) - vec3F(1.0f);
+					v.clamp(-1.0f, 1.0f);
+
+					float length = v.length();
+					const float cValidThresh = .077f;
+					if (length < cValidThresh)
+					{
+						c.set(.5f, .5f, .5f, c[3]);
+					}
+					else if (fabs(length - 1.0f) > cValidThresh)
+					{
+						v /= length;
+
+						for (uint32_t i = 0; i < 3; i++)
+							c[i] = clamp<float>((v[i] + 1.0f) * .5f, 0.0f, 1.0f);
+					}
+				}
+			}
+			return *this;
+		}
+
+		// Converts to 8-bit, rounding each [0,1] component to the nearest of 0-255.
+		void quantize(image &dst) const
+		{
+			dst.resize(m_width, m_height);
+
+			for (uint32_t y = 0; y < m_height; y++)
+			{
+				for (uint32_t x = 0; x < m_width; x++)
+				{
+					const vec4F &c = (*this)(x, y);
+					color_rgba &d = dst(x, y);
+					for (uint32_t i = 0; i < 4; i++)
+						d[i] = (uint8_t)clamp<int>((int)(c[i] * 255.0f + .5f), 0, 255);
+				}
+			}
+		}
 						
 	private:
 		uint32_t m_width, m_height, m_pitch;  // all in pixels
@@ -2943,7 +3026,9 @@ namespace basisu
 
 		void print(const char *pPrefix = nullptr)	{ printf("%sMax: %3.0f Mean: %3.3f RMS: %3.3f PSNR: %2.3f dB\n", pPrefix ? pPrefix : "", m_max, m_mean, m_rms, m_psnr);	}
 
-		void calc(const image &a, const image &b, uint32_t first_chan = 0, uint32_t total_chans = 0, bool avg_comp_error = true, bool use_601_luma = false);
+		// If pJob_pool isn't nullptr the image is split into bands of rows, which are processed in parallel. The result doesn't depend on the number of threads.
+		// Must not be called from inside a job of pJob_pool.
+		void calc(const image &a, const image &b, uint32_t first_chan = 0, uint32_t total_chans = 0, bool avg_comp_error = true, bool use_601_luma = false, job_pool *pJob_pool = nullptr);
 	};
 
 	// Image saving/loading/resampling
@@ -2965,6 +3050,13 @@ namespace basisu
 	bool load_image(const char* pFilename, image& img);
 	inline bool load_image(const std::string &filename, image &img) { return load_image(filename.c_str(), img); }
 
+	// High precision loading, components are normalized to [0,1]. 16-bit PNG's keep all 16 bits, everything else is loaded as 8-bit and converted.
+	bool load_png(const uint8_t* pBuf, size_t buf_size, imagef& img, const char* pFilename = nullptr);
+	bool load_png(const char* pFilename, imagef& img);
+
+	bool load_image(const char* pFilename, imagef& img);
+	inline bool load_image(const std::string &filename, imagef &img) { return load_image(filename.c_str(), img); }
+
 	uint8_t *read_tga(const uint8_t *pBuf, uint32_t buf_size, int &width, int &height, int &n_chans);
 	uint8_t *read_tga(const char *pFilename, int &width, int &height, int &n_chans);
 		
@@ -2986,10 +3078,82 @@ namespace basisu
 	float linear_to_srgb(float l);
 	float srgb_to_linear(float s);
 
+	// Separable image resampler. The output rows are split into bands, which can be resampled independently and at the same time from
+	// different threads. The contributor lists (filter weights) are computed once in init() and shared by all bands. All 4 components are
+	// filtered together, interleaved, so the inner loops operate on 4-wide vectors. The results are identical to the Resampler class.
+	// There's no limit on the image dimensions: each band streams through the source rows, only keeping the (linear or X resampled) 
+	// float rows it still needs, so memory use is bounded by the filter's support and the row width, not the image height.
+	class image_resampler
+	{
+	public:
+		image_resampler() : m_pSrc(nullptr), m_pDst(nullptr), m_pSrcf(nullptr), m_pDstf(nullptr) { }
+
+		// dst must already be resized to the desired output dimensions. src and dst must stay alive until resampling completes.
+		bool init(const image &src, image &dst, bool srgb, const char *pFilter, float filter_scale, bool wrapping,
+			uint32_t first_comp, uint32_t num_comps, uint32_t total_bands = 1);
+
+		// Float images, with [0,1] components. Output components are clamped to [0,1] too.
+		bool init(const imagef &src, imagef &dst, bool srgb, const char *pFilter, float filter_scale, bool wrapping,
+			uint32_t first_comp, uint32_t num_comps, uint32_t total_bands = 1);
+
+		uint32_t get_total_bands() const { return m_total_bands; }
+
+		// Thread safe, as long as each band is only resampled once.
+		void resample_band(uint32_t band_index);
+
+		// Adds one job per band to pJob_pool, without waiting for them to complete.
+		void add_jobs(job_pool &jpool);
+
+		// Resamples all bands, in parallel if pJob_pool is not nullptr.
+		void resample(job_pool *pJob_pool = nullptr);
+
+	private:
+		struct contrib
+		{
+			float m_weight;
+			uint32_t m_pixel;
+		};
+
+		// Contributor lists for each output column/row: m_x_ofs[i]..m_x_ofs[i+1] indexes into m_x_contribs.
+		uint_vec m_x_ofs, m_y_ofs;
+		basisu::vector<contrib> m_x_contribs, m_y_contribs;
+
+		// Only one of m_pSrc/m_pSrcf and m_pDst/m_pDstf are set.
+		const image *m_pSrc;
+		image *m_pDst;
+		const imagef *m_pSrcf;
+		imagef *m_pDstf;
+
+		uint32_t m_src_w, m_src_h, m_dst_w, m_dst_h;
+		uint32_t m_first_comp, m_num_comps, m_total_bands;
+		bool m_srgb;
+
+		// true to resample Y then X, false for X then Y.
+		bool m_delay_x_resample;
+
+		float m_srgb_to_linear[256];
+
+		enum { cLinearToSRGBTableSize = 8192 };
+		uint8_t m_linear_to_srgb[cLinearToSRGBTableSize];
+
+		bool init_filters(bool srgb, const char *pFilter, float filter_scale, bool wrapping, uint32_t first_comp, uint32_t num_comps, uint32_t total_bands);
+		void get_source_row(uint32_t y, float *pDst) const;
+		void resample_x(float *pDst, const float *pSrc) const;
+		void write_row(uint32_t y, float *pSamples) const;
+	};
+
+	// If pJob_pool is not nullptr the output rows are resampled in parallel. Must not be called with a job pool from inside a job running on that pool.
 	bool image_resample(const image &src, image &dst, bool srgb = false,
-		const char *pFilter = "lanczos4", float filter_scale = 1.0f, 
+		const char *pFilter = "lanczos4", float filter_scale = 1.0f,
 		bool wrapping = false,
-		uint32_t first_comp = 0, uint32_t num_comps = 4);
+		uint32_t first_comp = 0, uint32_t num_comps = 4,
+		job_pool *pJob_pool = nullptr);
+
+	bool image_resample(const imagef &src, imagef &dst, bool srgb = false,
+		const char *pFilter = "lanczos4", float filter_scale = 1.0f,
+		bool wrapping = false,
+		uint32_t first_comp = 0, uint32_t num_comps = 4,
+		job_pool *pJob_pool = nullptr);
 
 	// Timing
 			
@@ -3021,6 +3185,76 @@ namespace basisu
 		bool m_started, m_stopped;
 	};
 
+	// Returns the total user+kernel CPU time used so far by all of the process's threads, or 0 if unavailable.
+	double get_process_cpu_time_secs();
+
+	// Returns the process's peak resident memory usage in bytes, or 0 if unavailable.
+	uint64_t get_peak_memory_usage();
+
+	// Wall clock time, process CPU time, and job pool time accumulated over one or more runs of a processing phase.
+	struct phase_timing
+	{
+		double m_wall_time;
+		double m_cpu_time;
+		double m_job_time;
+		uint32_t m_num_runs;
+
+		phase_timing() { clear(); }
+
+		void clear()
+		{
+			m_wall_time = 0;
+			m_cpu_time = 0;
+			m_job_time = 0;
+			m_num_runs = 0;
+		}
+
+		// Fraction of the available threads which were busy executing jobs during this phase.
+		double get_thread_utilization(uint32_t total_threads) const
+		{
+			return ((m_wall_time > 0.0f) && (total_threads)) ? (m_job_time / (m_wall_time * total_threads)) : 0.0f;
+		}
+	};
+
+	// Adds the time elapsed between construction and stop() (or destruction) to a phase_timing.
+	class scoped_phase_timer
+	{
+		BASISU_NO_EQUALS_OR_COPY_CONSTRUCT(scoped_phase_timer);
+
+	public:
+		scoped_phase_timer(phase_timing& timing, const job_pool* pJob_pool = nullptr) :
+			m_timing(timing),
+			m_pJob_pool(pJob_pool),
+			m_start_cpu_time(get_process_cpu_time_secs()),
+			m_start_job_time(pJob_pool ? pJob_pool->get_total_job_time_secs() : 0.0f),
+			m_stopped(false)
+		{
+			m_tm.start();
+		}
+
+		~scoped_phase_timer() { stop(); }
+
+		void stop()
+		{
+			if (m_stopped)
+				return;
+			m_stopped = true;
+
+			m_timing.m_wall_time += m_tm.get_elapsed_secs();
+			m_timing.m_cpu_time += maximum<double>(0.0f, get_process_cpu_time_secs() - m_start_cpu_time);
+			if (m_pJob_pool)
+				m_timing.m_job_time += m_pJob_pool->get_total_job_time_secs() - m_start_job_time;
+			m_timing.m_num_runs++;
+		}
+
+	private:
+		phase_timing& m_timing;
+		const job_pool* m_pJob_pool;
+		interval_timer m_tm;
+		double m_start_cpu_time, m_start_job_time;
+		bool m_stopped;
+	};
+
 	// 2D array
 
 	template<typename T>
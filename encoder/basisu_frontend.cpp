@@ -104,9 +104,6 @@ namespace basisu
 		if ((p.m_max_selector_clusters < 1) || (p.m_max_selector_clusters > cMaxSelectorClusters))
 			return false;
 
-		m_source_blocks.resize(0);
-		append_vector(m_source_blocks, p.m_pSource_blocks, p.m_num_source_blocks);
-
 		m_params = p;
 
 		m_encoded_blocks.resize(m_params.m_num_source_blocks);
@@ -189,8 +186,12 @@ namespace basisu
 
 	bool basisu_frontend::compress()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::compress", "frontend");
+
 		debug_printf("basisu_frontend::compress\n");
 
+		m_timings.clear();
+
 		m_total_blocks = m_params.m_num_source_blocks;
 		m_total_pixels = m_total_blocks * cPixelBlockTotalPixels;
 
@@ -202,9 +203,15 @@ namespace basisu
 		}
 		else
 		{
-			init_endpoint_training_vectors();
+			{
+				scoped_phase_timer t(m_timings.m_init_endpoint_training_vectors, m_params.m_pJob_pool);
+				init_endpoint_training_vectors();
+			}
 
-			generate_endpoint_clusters();
+			{
+				scoped_phase_timer t(m_timings.m_generate_endpoint_clusters, m_params.m_pJob_pool);
+				generate_endpoint_clusters();
+			}
 				
 			for (uint32_t refine_endpoint_step = 0; refine_endpoint_step < m_num_endpoint_codebook_iterations; refine_endpoint_step++)
 			{
@@ -215,7 +222,10 @@ namespace basisu
 					introduce_new_endpoint_clusters();
 				}
 
-				generate_endpoint_codebook(refine_endpoint_step);
+				{
+					scoped_phase_timer t(m_timings.m_generate_endpoint_codebook, m_params.m_pJob_pool);
+					generate_endpoint_codebook(refine_endpoint_step);
+				}
 
 				if ((m_params.m_debug_images) && (m_params.m_dump_endpoint_clusterization))
 				{
@@ -230,9 +240,13 @@ namespace basisu
 				{
 					//dump_endpoint_clusterization_visualization("endpoint_clusters_before_refinement.png");
 
+					scoped_phase_timer t(m_timings.m_refine_endpoint_clusterization, m_params.m_pJob_pool);
+
 					if (!refine_endpoint_clusterization())
 						early_out = true;
 
+					t.stop();
+
 					if ((m_params.m_tex_type == basist::cBASISTexTypeVideoFrames) && (!refine_endpoint_step) && (m_num_endpoint_codebook_iterations == 1))
 					{
 						eliminate_redundant_or_empty_endpoint_clusters();
@@ -266,16 +280,26 @@ namespace basisu
 
 			create_initial_packed_texture();
 
-			generate_selector_clusters();
+			{
+				scoped_phase_timer t(m_timings.m_generate_selector_clusters, m_params.m_pJob_pool);
+
+				generate_selector_clusters();
 
-			if (m_use_hierarchical_selector_codebooks)
-				compute_selector_clusters_within_each_parent_cluster();
+				if (m_use_hierarchical_selector_codebooks)
+					compute_selector_clusters_within_each_parent_cluster();
+			}
 				
 			if (m_params.m_compression_level == 0)
 			{
-				create_optimized_selector_codebook(0);
+				{
+					scoped_phase_timer t(m_timings.m_create_optimized_selector_codebook, m_params.m_pJob_pool);
+					create_optimized_selector_codebook(0);
+				}
 
-				find_optimal_selector_clusters_for_each_block();
+				{
+					scoped_phase_timer t(m_timings.m_find_optimal_selector_clusters_for_each_block, m_params.m_pJob_pool);
+					find_optimal_selector_clusters_for_each_block();
+				}
 			
 				introduce_special_selector_clusters();
 			}
@@ -284,30 +308,46 @@ namespace basisu
 				const uint32_t num_refine_selector_steps = m_params.m_pGlobal_sel_codebook ? 1 : m_num_selector_codebook_iterations;
 				for (uint32_t refine_selector_steps = 0; refine_selector_steps < num_refine_selector_steps; refine_selector_steps++)
 				{
-					create_optimized_selector_codebook(refine_selector_steps);
+					{
+						scoped_phase_timer t(m_timings.m_create_optimized_selector_codebook, m_params.m_pJob_pool);
+						create_optimized_selector_codebook(refine_selector_steps);
+					}
 
-					find_optimal_selector_clusters_for_each_block();
+					{
+						scoped_phase_timer t(m_timings.m_find_optimal_selector_clusters_for_each_block, m_params.m_pJob_pool);
+						find_optimal_selector_clusters_for_each_block();
+					}
 
 					introduce_special_selector_clusters();
 				
 					if ((m_params.m_compression_level >= 4) || (m_params.m_tex_type == basist::cBASISTexTypeVideoFrames))
 					{
+						scoped_phase_timer t(m_timings.m_refine_block_endpoints_given_selectors, m_params.m_pJob_pool);
+
 						if (!refine_block_endpoints_given_selectors())
 							break;
 					}
 				}
 			}
 						
-			optimize_selector_codebook();
+			{
+				scoped_phase_timer t(m_timings.m_optimize_selector_codebook, m_params.m_pJob_pool);
+				optimize_selector_codebook();
+			}
 
 			if (m_params.m_debug_stats)
 				debug_printf("Total selector clusters: %u\n", (uint32_t)m_selector_cluster_block_indices.size());
 		}
 
-		finalize();
+		{
+			scoped_phase_timer t(m_timings.m_finalize, m_params.m_pJob_pool);
+			finalize();
+		}
 
 		if (m_params.m_validate)
 		{
+			scoped_phase_timer t(m_timings.m_validate, m_params.m_pJob_pool);
+
 			if (!validate_output())
 				return false;
 		}
@@ -678,6 +718,8 @@ namespace basisu
 	// This method will change the number and ordering of the selector codebook clusters.
 	void basisu_frontend::optimize_selector_codebook()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::optimize_selector_codebook", "frontend");
+
 		debug_printf("optimize_selector_codebook\n");
 
 		const uint32_t orig_total_selector_clusters = (uint32_t)m_optimized_cluster_selectors.size();
@@ -835,6 +877,8 @@ namespace basisu
 
 	void basisu_frontend::init_endpoint_training_vectors()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::init_endpoint_training_vectors", "frontend");
+
 		debug_printf("init_endpoint_training_vectors\n");
 								
 		vec6F_quantizer::array_of_weighted_training_vecs &training_vecs = m_endpoint_clusterizer.get_training_vecs();
@@ -884,6 +928,8 @@ namespace basisu
 
 	void basisu_frontend::generate_endpoint_clusters()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::generate_endpoint_clusters", "frontend");
+
 		debug_printf("Begin endpoint quantization\n");
 
 		const uint32_t parent_codebook_size = (m_params.m_max_endpoint_clusters >= 256) ? BASISU_ENDPOINT_PARENT_CODEBOOK_SIZE : 0;
@@ -1204,6 +1250,8 @@ namespace basisu
 	// TODO: Don't optimize endpoint clusters which haven't changed.
 	void basisu_frontend::generate_endpoint_codebook(uint32_t step)
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::generate_endpoint_codebook", "frontend");
+
 		debug_printf("generate_endpoint_codebook\n");
 
 		m_endpoint_cluster_etc_params.resize(m_endpoint_clusters.size());
@@ -1375,6 +1423,8 @@ namespace basisu
 
 	uint32_t basisu_frontend::refine_endpoint_clusterization()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::refine_endpoint_clusterization", "frontend");
+
 		debug_printf("refine_endpoint_clusterization\n");
 		
 		if (m_use_hierarchical_endpoint_codebooks)
@@ -1738,6 +1788,8 @@ namespace basisu
 
 	void basisu_frontend::generate_selector_clusters()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::generate_selector_clusters", "frontend");
+
 		debug_printf("generate_selector_clusters\n");
 
 		typedef vec<16, float> vec16F;
@@ -1862,6 +1914,8 @@ namespace basisu
 
 	void basisu_frontend::create_optimized_selector_codebook(uint32_t iter)
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::create_optimized_selector_codebook", "frontend");
+
 		debug_printf("create_optimized_selector_codebook\n");
 
 		const uint32_t total_selector_clusters = (uint32_t)m_selector_cluster_block_indices.size();
@@ -2135,6 +2189,8 @@ namespace basisu
 
 	void basisu_frontend::find_optimal_selector_clusters_for_each_block()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::find_optimal_selector_clusters_for_each_block", "frontend");
+
 		debug_printf("find_optimal_selector_clusters_for_each_block\n");
 
 		// Sanity checks
@@ -2344,6 +2400,8 @@ namespace basisu
 	// TODO: Remove old ETC1 specific stuff, and thread this.
 	uint32_t basisu_frontend::refine_block_endpoints_given_selectors()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::refine_block_endpoints_given_selectors", "frontend");
+
 		debug_printf("refine_block_endpoints_given_selectors\n");
 				
 		for (int block_index = 0; block_index < static_cast<int>(m_total_blocks); block_index++)
@@ -2606,6 +2664,8 @@ namespace basisu
 
 	void basisu_frontend::finalize()
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::finalize", "frontend");
+
 		for (uint32_t block_index = 0; block_index < m_total_blocks; block_index++)
 		{
 			for (uint32_t subblock_index = 0; subblock_index < 2; subblock_index++)
@@ -2840,6 +2900,8 @@ namespace basisu
 	
 	bool basisu_frontend::validate_output() const
 	{
+		BASISU_TRACE_SCOPE("basisu_frontend::validate_output", "frontend");
+
 		debug_printf("validate_output\n");
 
 		if (!check_etc1s_constraints())
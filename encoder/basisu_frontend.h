@@ -90,8 +90,9 @@ namespace basisu
 			{
 			}
 
+			// The source blocks aren't copied, they must remain valid until the frontend (and any backend using it) is finished.
 			uint32_t m_num_source_blocks;
-			pixel_block *m_pSource_blocks;
+			const pixel_block *m_pSource_blocks;
 
 			uint32_t m_max_endpoint_clusters;
 			uint32_t m_max_selector_clusters;
@@ -117,13 +118,33 @@ namespace basisu
 			job_pool *m_pJob_pool;
 		};
 
+		// Time spent in the main steps of compress(). Steps that run more than once accumulate.
+		struct timings
+		{
+			phase_timing m_init_endpoint_training_vectors;
+			phase_timing m_generate_endpoint_clusters;
+			phase_timing m_generate_endpoint_codebook;
+			phase_timing m_refine_endpoint_clusterization;
+			phase_timing m_generate_selector_clusters;
+			phase_timing m_create_optimized_selector_codebook;
+			phase_timing m_find_optimal_selector_clusters_for_each_block;
+			phase_timing m_refine_block_endpoints_given_selectors;
+			phase_timing m_optimize_selector_codebook;
+			phase_timing m_finalize;
+			phase_timing m_validate;
+
+			void clear() { *this = timings(); }
+		};
+
 		bool init(const params &p);
 
 		bool compress();
 
 		const params &get_params() const { return m_params; }
 
-		const pixel_block &get_source_pixel_block(uint32_t i) const { return m_source_blocks[i]; }
+		const timings &get_timings() const { return m_timings; }
+
+		const pixel_block &get_source_pixel_block(uint32_t i) const { assert(i < m_params.m_num_source_blocks); return m_params.m_pSource_blocks[i]; }
 
 		// RDO output blocks
 		uint32_t get_total_output_blocks() const { return static_cast<uint32_t>(m_encoded_blocks.size()); }
@@ -163,6 +184,7 @@ namespace basisu
 
 	private:
 		params m_params;
+		timings m_timings;
 		uint32_t m_total_blocks;
 		uint32_t m_total_pixels;
 
@@ -173,9 +195,6 @@ namespace basisu
 		uint32_t m_num_endpoint_codebook_iterations;
 		uint32_t m_num_selector_codebook_iterations;
 
-		// Source pixels for each blocks
-		pixel_block_vec m_source_blocks;
-
 		// The quantized ETC1S texture.
 		etc_block_vec m_encoded_blocks;
 		
@@ -22,4 +22,7 @@ void CPPSPMD_NAME(find_selectors_linear_rgb_4_N)(int64_t* pDistance, uint8_t* pS
 
 void CPPSPMD_NAME(find_lowest_error_perceptual_rgb_4_N)(int64_t* pDistance, const basisu::color_rgba* pBlock_colors, const basisu::color_rgba* pSrc_pixels, uint32_t n, int64_t early_out_error);
 void CPPSPMD_NAME(find_lowest_error_linear_rgb_4_N)(int64_t* pDistance, const basisu::color_rgba* pBlock_colors, const basisu::color_rgba* pSrc_pixels, uint32_t n, int64_t early_out_error);
+
+void CPPSPMD_NAME(linear_distance_rgba_16)(int64_t* pComp_errors, const basisu::color_rgba* pPixels0, const basisu::color_rgba* pPixels1);
+void CPPSPMD_NAME(find_selectors_linear_projected_N)(uint64_t* pTotal_err, uint8_t* pSelectors, const basisu::color_rgba* pWeighted_colors, uint32_t num_weighted_colors, const basisu::color_rgba* pSrc_pixels, uint32_t n, const uint32_t* pComp_weights, bool has_alpha);
 #endif
@@ -548,6 +548,150 @@ namespace CPPSPMD_NAME(basisu_kernels_namespace)
       }
    };
 
+   struct linear_distance_rgba_16 : spmd_kernel
+   {
+      void _call(int64_t* pComp_errors,
+         const color_rgba* pPixels0,
+         const color_rgba* pPixels1)
+      {
+         vint total_r = 0, total_g = 0, total_b = 0, total_a = 0;
+
+         for (uint32_t i = 0; i < 16; i += 4)
+         {
+            vint r0, g0, b0, a0;
+            transpose4x4(r0.m_value, g0.m_value, b0.m_value, a0.m_value, 
+               load_rgba32(&pPixels0[i + 0]), load_rgba32(&pPixels0[i + 1]), load_rgba32(&pPixels0[i + 2]), load_rgba32(&pPixels0[i + 3]));
+
+            vint r1, g1, b1, a1;
+            transpose4x4(r1.m_value, g1.m_value, b1.m_value, a1.m_value, 
+               load_rgba32(&pPixels1[i + 0]), load_rgba32(&pPixels1[i + 1]), load_rgba32(&pPixels1[i + 2]), load_rgba32(&pPixels1[i + 3]));
+
+            vint dr = r0 - r1;
+            vint dg = g0 - g1;
+            vint db = b0 - b1;
+            vint da = a0 - a1;
+
+            store_all(total_r, total_r + dr * dr);
+            store_all(total_g, total_g + dg * dg);
+            store_all(total_b, total_b + db * db);
+            store_all(total_a, total_a + da * da);
+         }
+
+         pComp_errors[0] = reduce_add(total_r);
+         pComp_errors[1] = reduce_add(total_g);
+         pComp_errors[2] = reduce_add(total_b);
+         pComp_errors[3] = reduce_add(total_a);
+      }
+   };
+
+   // Selector search used by bc7enc's evaluate_solution(): each pixel is projected onto the line between the first and last weighted colors, then 
+   // the two nearest weighted colors are compared. Each component weight must be < 8192 so the per-pixel error fits into 31 bits.
+   struct find_selectors_linear_projected_N : spmd_kernel
+   {
+      inline vint compute_dist(
+         const vint& base_r, const vint& base_g, const vint& base_b, const vint& base_a,
+         const vint& r, const vint& g, const vint& b, const vint& a,
+         const vint& wr, const vint& wg, const vint& wb, const vint& wa)
+      {
+         vint dr = base_r - r;
+         vint dg = base_g - g;
+         vint db = base_b - b;
+         vint da = base_a - a;
+
+         return wr * (dr * dr) + wg * (dg * dg) + wb * (db * db) + wa * (da * da);
+      }
+
+      void _call(uint64_t* pTotal_err,
+         uint8_t* pSelectors,
+         const color_rgba* pWeighted_colors, uint32_t num_weighted_colors,
+         const color_rgba* pSrc_pixels, uint32_t n,
+         const uint32_t* pComp_weights, bool has_alpha)
+      {
+         const uint32_t N = num_weighted_colors;
+         assert((N >= 2) && (N <= 32));
+
+         const int lr = pWeighted_colors[0].r, lg = pWeighted_colors[0].g, lb = pWeighted_colors[0].b, la = has_alpha ? pWeighted_colors[0].a : 0;
+         const int dr = pWeighted_colors[N - 1].r - lr, dg = pWeighted_colors[N - 1].g - lg, db = pWeighted_colors[N - 1].b - lb;
+         const int da = has_alpha ? (pWeighted_colors[N - 1].a - la) : 0;
+
+         // Must exactly match the scalar code in evaluate_solution().
+         const float f = has_alpha ? (N / (float)(squarei(dr) + squarei(dg) + squarei(db) + squarei(da) + .00000125f)) : (N / (float)(squarei(dr) + squarei(dg) + squarei(db) + .00000125f));
+
+         const vint vlr = lr, vlg = lg, vlb = lb, vla = la;
+         const vint vdr = dr, vdg = dg, vdb = db, vda = da;
+         const vint wr = (int)pComp_weights[0], wg = (int)pComp_weights[1], wb = (int)pComp_weights[2], wa = has_alpha ? (int)pComp_weights[3] : 0;
+
+         uint64_t total_err = 0;
+
+         uint32_t i;
+         for (i = 0; (i + 4) <= n; i += 4)
+         {
+            vint r, g, b, a;
+            transpose4x4(r.m_value, g.m_value, b.m_value, a.m_value, 
+               load_rgba32(&pSrc_pixels[i + 0]), load_rgba32(&pSrc_pixels[i + 1]), load_rgba32(&pSrc_pixels[i + 2]), load_rgba32(&pSrc_pixels[i + 3]));
+
+            vint dot = (r - vlr) * vdr + (g - vlg) * vdg + (b - vlb) * vdb + (a - vla) * vda;
+
+            vint sel = clamp(vint{ _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(dot.m_value), _mm_set1_ps(f)), _mm_set1_ps(.5f))) }, vint(1), vint((int)N - 1));
+
+            CPPSPMD_ALIGN(16) int s[4];
+            _mm_store_si128((__m128i*)s, sel.m_value);
+
+            vint r0, g0, b0, a0;
+            transpose4x4(r0.m_value, g0.m_value, b0.m_value, a0.m_value, 
+               load_rgba32(&pWeighted_colors[s[0] - 1]), load_rgba32(&pWeighted_colors[s[1] - 1]), load_rgba32(&pWeighted_colors[s[2] - 1]), load_rgba32(&pWeighted_colors[s[3] - 1]));
+
+            vint r1, g1, b1, a1;
+            transpose4x4(r1.m_value, g1.m_value, b1.m_value, a1.m_value, 
+               load_rgba32(&pWeighted_colors[s[0]]), load_rgba32(&pWeighted_colors[s[1]]), load_rgba32(&pWeighted_colors[s[2]]), load_rgba32(&pWeighted_colors[s[3]]));
+
+            vint err0 = compute_dist(r0, g0, b0, a0, r, g, b, a, wr, wg, wb, wa);
+            vint err1 = compute_dist(r1, g1, b1, a1, r, g, b, a, wr, wg, wb, wa);
+
+            // Take the lower selector if it's closer, or if it's equally close and it's the first (non-interpolated) color.
+            vbool use_lower = (err0 < err1) || ((err0 == err1) && (sel == 1));
+
+            vint best_sel = spmd_ternaryi(use_lower, sel - 1, sel);
+            vint best_err = min(err0, err1);
+
+            CPPSPMD_ALIGN(16) int e[4];
+            _mm_store_si128((__m128i*)e, best_err.m_value);
+            _mm_store_si128((__m128i*)s, best_sel.m_value);
+
+            for (uint32_t j = 0; j < 4; j++)
+            {
+               total_err += (uint32_t)e[j];
+               pSelectors[i + j] = (uint8_t)s[j];
+            }
+         }
+
+         for (; i < n; i++)
+         {
+            const color_rgba& c = pSrc_pixels[i];
+
+            int sel = (int)((float)((c.r - lr) * dr + (c.g - lg) * dg + (c.b - lb) * db + (has_alpha ? ((c.a - la) * da) : 0)) * f + .5f);
+            sel = clampi(sel, 1, N - 1);
+
+            uint32_t errs[2];
+            for (uint32_t j = 0; j < 2; j++)
+            {
+               const color_rgba& w = pWeighted_colors[sel - 1 + j];
+               errs[j] = pComp_weights[0] * squarei(w.r - c.r) + pComp_weights[1] * squarei(w.g - c.g) + pComp_weights[2] * squarei(w.b - c.b);
+               if (has_alpha)
+                  errs[j] += pComp_weights[3] * squarei(w.a - c.a);
+            }
+
+            if ((errs[0] < errs[1]) || ((errs[0] == errs[1]) && (sel == 1)))
+               sel--;
+
+            total_err += minimum(errs[0], errs[1]);
+            pSelectors[i] = (uint8_t)sel;
+         }
+
+         *pTotal_err = total_err;
+      }
+   };
+
 } // namespace
 
 using namespace CPPSPMD_NAME(basisu_kernels_namespace);
@@ -582,3 +726,13 @@ void CPPSPMD_NAME(find_lowest_error_linear_rgb_4_N)(int64_t* pDistance, const co
    spmd_call< find_lowest_error_linear_rgb_4_N >(pDistance, pBlock_colors, pSrc_pixels, n, early_out_error);
 }
 
+
+void CPPSPMD_NAME(linear_distance_rgba_16)(int64_t* pComp_errors, const color_rgba* pPixels0, const color_rgba* pPixels1)
+{
+   spmd_call< linear_distance_rgba_16 >(pComp_errors, pPixels0, pPixels1);
+}
+
+void CPPSPMD_NAME(find_selectors_linear_projected_N)(uint64_t* pTotal_err, uint8_t* pSelectors, const color_rgba* pWeighted_colors, uint32_t num_weighted_colors, const color_rgba* pSrc_pixels, uint32_t n, const uint32_t* pComp_weights, bool has_alpha)
+{
+   spmd_call< find_selectors_linear_projected_N >(pTotal_err, pSelectors, pWeighted_colors, num_weighted_colors, pSrc_pixels, n, pComp_weights, has_alpha);
+}
@@ -195,7 +195,7 @@ namespace basisu
 
 					k = Pcontrib[i].n++;
 
-					Pcontrib[i].p[k].pixel = (unsigned short)n; /* store src sample number */
+					Pcontrib[i].p[k].pixel = (uint32_t)n; /* store src sample number */
 					Pcontrib[i].p[k].weight = weight;           /* store src sample weight */
 
 					total_weight += weight; /* total weight of all contributors */
@@ -306,7 +306,7 @@ namespace basisu
 
 					k = Pcontrib[i].n++;
 
-					Pcontrib[i].p[k].pixel = (unsigned short)n; /* store src sample number */
+					Pcontrib[i].p[k].pixel = (uint32_t)n; /* store src sample number */
 					Pcontrib[i].p[k].weight = weight;           /* store src sample weight */
 
 					total_weight += weight; /* total weight of all contributors */
@@ -417,11 +417,11 @@ namespace basisu
 		for (i = 0; i < Pclist->n; i++)
 		{
 			// locate the contributor's location in the scan buffer -- the contributor must always be found!
-			for (j = 0; j < MAX_SCAN_BUF_SIZE; j++)
-				if (m_Pscan_buf->scan_buf_y[j] == Pclist->p[i].pixel)
+			for (j = 0; j < m_scan_buf_size; j++)
+				if (m_Pscan_buf->scan_buf_y[j] == (int)Pclist->p[i].pixel)
 					break;
 
-			assert(j < MAX_SCAN_BUF_SIZE);
+			assert(j < m_scan_buf_size);
 
 			Psrc = m_Pscan_buf->scan_buf_l[j];
 
@@ -480,13 +480,13 @@ namespace basisu
 
 		/* Find an empty slot in the scanline buffer. (FIXME: Perf. is terrible here with extreme scaling ratios.) */
 
-		for (i = 0; i < MAX_SCAN_BUF_SIZE; i++)
+		for (i = 0; i < m_scan_buf_size; i++)
 			if (m_Pscan_buf->scan_buf_y[i] == -1)
 				break;
 
 		/* If the buffer is full, exit with an error. */
 
-		if (i == MAX_SCAN_BUF_SIZE)
+		if (i == m_scan_buf_size)
 		{
 			m_status = STATUS_SCAN_BUFFER_FULL;
 			return false;
@@ -597,9 +597,14 @@ namespace basisu
 
 		if (m_Pscan_buf)
 		{
-			for (i = 0; i < MAX_SCAN_BUF_SIZE; i++)
-				free(m_Pscan_buf->scan_buf_l[i]);
+			if (m_Pscan_buf->scan_buf_l)
+			{
+				for (i = 0; i < m_scan_buf_size; i++)
+					free(m_Pscan_buf->scan_buf_l[i]);
+			}
 
+			free(m_Pscan_buf->scan_buf_l);
+			free(m_Pscan_buf->scan_buf_y);
 			free(m_Pscan_buf);
 			m_Pscan_buf = NULL;
 		}
@@ -625,7 +630,7 @@ namespace basisu
 				m_Psrc_y_count[resampler_range_check(m_Pclist_y[i].p[j].pixel, m_resample_src_y)]++;
 		}
 
-		for (i = 0; i < MAX_SCAN_BUF_SIZE; i++)
+		for (i = 0; i < m_scan_buf_size; i++)
 		{
 			m_Pscan_buf->scan_buf_y[i] = -1;
 
@@ -672,6 +677,7 @@ namespace basisu
 		m_Psrc_y_count = NULL;
 		m_Psrc_y_flag = NULL;
 		m_Pscan_buf = NULL;
+		m_scan_buf_size = src_y;
 		m_status = STATUS_OKAY;
 
 		m_resample_src_x = src_x;
@@ -755,13 +761,20 @@ namespace basisu
 			for (j = 0; j < m_Pclist_y[i].n; j++)
 				m_Psrc_y_count[resampler_range_check(m_Pclist_y[i].p[j].pixel, m_resample_src_y)]++;
 
-		if ((m_Pscan_buf = (Scan_Buf*)malloc(sizeof(Scan_Buf))) == NULL)
+		if ((m_Pscan_buf = (Scan_Buf*)calloc(1, sizeof(Scan_Buf))) == NULL)
+		{
+			m_status = STATUS_OUT_OF_MEMORY;
+			return;
+		}
+
+		if (((m_Pscan_buf->scan_buf_y = (int*)malloc(m_scan_buf_size * sizeof(int))) == NULL) ||
+			((m_Pscan_buf->scan_buf_l = (Sample**)malloc(m_scan_buf_size * sizeof(Sample*))) == NULL))
 		{
 			m_status = STATUS_OUT_OF_MEMORY;
 			return;
 		}
 
-		for (i = 0; i < MAX_SCAN_BUF_SIZE; i++)
+		for (i = 0; i < m_scan_buf_size; i++)
 		{
 			m_Pscan_buf->scan_buf_y[i] = -1;
 			m_Pscan_buf->scan_buf_l[i] = NULL;
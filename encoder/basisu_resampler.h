@@ -17,7 +17,6 @@
 
 #define BASISU_RESAMPLER_DEBUG_OPS (0)
 #define BASISU_RESAMPLER_DEFAULT_FILTER "lanczos4"
-#define BASISU_RESAMPLER_MAX_DIMENSION (16384)
 
 namespace basisu
 {
@@ -32,7 +31,7 @@ namespace basisu
 		struct Contrib
 		{
 			Resample_Real weight;
-			uint16_t pixel;
+			uint32_t pixel;
 		};
 
 		struct Contrib_List
@@ -145,16 +144,13 @@ namespace basisu
 		int *m_Psrc_y_count;
 		uint8_t *m_Psrc_y_flag;
 
-		// The maximum number of scanlines that can be buffered at one time.
-		enum
-		{
-			MAX_SCAN_BUF_SIZE = BASISU_RESAMPLER_MAX_DIMENSION
-		};
+		// The maximum number of scanlines that can be buffered at one time. Never more than the number of source lines.
+		int m_scan_buf_size;
 
 		struct Scan_Buf
 		{
-			int scan_buf_y[MAX_SCAN_BUF_SIZE];
-			Sample *scan_buf_l[MAX_SCAN_BUF_SIZE];
+			int *scan_buf_y;
+			Sample **scan_buf_l;
 		};
 
 		Scan_Buf *m_Pscan_buf;
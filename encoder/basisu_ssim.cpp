@@ -14,6 +14,10 @@
 // limitations under the License.
 #include "basisu_ssim.h"
 
+#if BASISU_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -317,55 +321,214 @@ namespace basisu
 		return avg;
 	}
 		
-	// Reference: https://ece.uwaterloo.ca/~z70wang/research/ssim/index.html
-	vec4F compute_ssim(const imagef &a, const imagef &b)
+	const int cSSIMFilterSize = 11, cSSIMFilterHalfSize = cSSIMFilterSize / 2;
+	const float cSSIMFilterSigmaSqr = 1.5f * 1.5f;
+
+	// The 5 Gaussian filtered quantities SSIM needs, per pixel: a, b, a*a, b*b and a*b.
+	enum { cSSIMSumA, cSSIMSumB, cSSIMSumAA, cSSIMSumBB, cSSIMSumAB, cSSIMTotalSums };
+
+	// Horizontally filters row y of a and b (clamped to the image), writing each of the 5 sums for every pixel to pDst.
+	static void ssim_filter_row(const imagef &a, const imagef &b, int y, const float *pKernel, vec4F *pDst)
 	{
-		imagef axb, a_sq, b_sq, mu1, mu2, mu1_sq, mu2_sq, mu1_mu2, s1_sq, s2_sq, s12, smap, t1, t2, t3;
+		const int width = a.get_width();
+		y = clamp<int>(y, 0, a.get_height() - 1);
 
-		const float C1 = 6.50250f, C2 = 58.52250f;
+		const vec4F *pA = &a(0, y), *pB = &b(0, y);
+
+		for (int x = 0; x < width; x++, pDst += cSSIMTotalSums)
+		{
+#if BASISU_USE_SSE2
+			__m128 sa = _mm_setzero_ps(), sb = _mm_setzero_ps(), saa = _mm_setzero_ps(), sbb = _mm_setzero_ps(), sab = _mm_setzero_ps();
+
+			for (int k = 0; k < cSSIMFilterSize; k++)
+			{
+				const int sx = clamp<int>(x + k - cSSIMFilterHalfSize, 0, width - 1);
 				
-		pow_image(a, a_sq, vec4F(2));
-		pow_image(b, b_sq, vec4F(2));
-		mul_image(a, b, axb, vec4F(1.0f));
+				const __m128 va = _mm_loadu_ps(reinterpret_cast<const float *>(&pA[sx])), vb = _mm_loadu_ps(reinterpret_cast<const float *>(&pB[sx]));
+				const __m128 w = _mm_set1_ps(pKernel[k]);
+				const __m128 wa = _mm_mul_ps(va, w), wb = _mm_mul_ps(vb, w);
+
+				sa = _mm_add_ps(sa, wa);
+				sb = _mm_add_ps(sb, wb);
+				saa = _mm_add_ps(saa, _mm_mul_ps(wa, va));
+				sbb = _mm_add_ps(sbb, _mm_mul_ps(wb, vb));
+				sab = _mm_add_ps(sab, _mm_mul_ps(wa, vb));
+			}
+
+			_mm_storeu_ps(&pDst[cSSIMSumA][0], sa);
+			_mm_storeu_ps(&pDst[cSSIMSumB][0], sb);
+			_mm_storeu_ps(&pDst[cSSIMSumAA][0], saa);
+			_mm_storeu_ps(&pDst[cSSIMSumBB][0], sbb);
+			_mm_storeu_ps(&pDst[cSSIMSumAB][0], sab);
+#else
+			for (uint32_t i = 0; i < cSSIMTotalSums; i++)
+				pDst[i].set(0.0f);
+
+			for (int k = 0; k < cSSIMFilterSize; k++)
+			{
+				const int sx = clamp<int>(x + k - cSSIMFilterHalfSize, 0, width - 1);
+
+				const vec4F &va = pA[sx], &vb = pB[sx];
+				const float w = pKernel[k];
+
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					const float wa = va[c] * w, wb = vb[c] * w;
+					pDst[cSSIMSumA][c] += wa;
+					pDst[cSSIMSumB][c] += wb;
+					pDst[cSSIMSumAA][c] += wa * va[c];
+					pDst[cSSIMSumBB][c] += wb * vb[c];
+					pDst[cSSIMSumAB][c] += wa * vb[c];
+				}
+			}
+#endif
+		}
+	}
+
+	// Sums the SSIM map of output rows [first_y, last_y). The horizontally filtered rows are kept in a ring buffer, so each is only computed once per band.
+	static vec4D ssim_sum_band(const imagef &a, const imagef &b, int first_y, int last_y, const float *pKernel)
+	{
+		const float C1 = 6.50250f, C2 = 58.52250f;
+
+		const int width = a.get_width();
+		
+		basisu::vector<vec4F> rows(cSSIMFilterSize * width * cSSIMTotalSums);
+		
+		// Slot (y - first_y + cSSIMFilterHalfSize) % cSSIMFilterSize holds filtered row y.
+		for (int y = first_y - cSSIMFilterHalfSize; y < first_y + cSSIMFilterHalfSize; y++)
+			ssim_filter_row(a, b, y, pKernel, &rows[((y - first_y + cSSIMFilterHalfSize) % cSSIMFilterSize) * width * cSSIMTotalSums]);
+
+		vec4D total(0.0f);
+
+		for (int y = first_y; y < last_y; y++)
+		{
+			ssim_filter_row(a, b, y + cSSIMFilterHalfSize, pKernel, &rows[((y - first_y + cSSIMFilterSize - 1) % cSSIMFilterSize) * width * cSSIMTotalSums]);
+
+			const vec4F *pRows[cSSIMFilterSize];
+			for (int k = 0; k < cSSIMFilterSize; k++)
+				pRows[k] = &rows[((y - first_y + k) % cSSIMFilterSize) * width * cSSIMTotalSums];
+
+#if BASISU_USE_SSE2
+			__m128 row_total = _mm_setzero_ps();
 
-		gaussian_filter(mu1, a, 11, 1.5f * 1.5f);
-		gaussian_filter(mu2, b, 11, 1.5f * 1.5f);
+			const __m128 c1 = _mm_set1_ps(C1), c2 = _mm_set1_ps(C2), two = _mm_set1_ps(2.0f);
 
-		pow_image(mu1, mu1_sq, vec4F(2));
-		pow_image(mu2, mu2_sq, vec4F(2));
-		mul_image(mu1, mu2, mu1_mu2, vec4F(1.0f));
+			for (int x = 0; x < width; x++)
+			{
+				const uint32_t ofs = x * cSSIMTotalSums;
+
+				__m128 mu1 = _mm_setzero_ps(), mu2 = _mm_setzero_ps(), saa = _mm_setzero_ps(), sbb = _mm_setzero_ps(), sab = _mm_setzero_ps();
+
+				for (int k = 0; k < cSSIMFilterSize; k++)
+				{
+					const vec4F *p = pRows[k] + ofs;
+					const __m128 w = _mm_set1_ps(pKernel[k]);
+
+					mu1 = _mm_add_ps(mu1, _mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float *>(&p[cSSIMSumA])), w));
+					mu2 = _mm_add_ps(mu2, _mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float *>(&p[cSSIMSumB])), w));
+					saa = _mm_add_ps(saa, _mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float *>(&p[cSSIMSumAA])), w));
+					sbb = _mm_add_ps(sbb, _mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float *>(&p[cSSIMSumBB])), w));
+					sab = _mm_add_ps(sab, _mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float *>(&p[cSSIMSumAB])), w));
+				}
+
+				const __m128 mu1_sq = _mm_mul_ps(mu1, mu1), mu2_sq = _mm_mul_ps(mu2, mu2), mu1_mu2 = _mm_mul_ps(mu1, mu2);
+				const __m128 s1_sq = _mm_sub_ps(saa, mu1_sq), s2_sq = _mm_sub_ps(sbb, mu2_sq), s12 = _mm_sub_ps(sab, mu1_mu2);
+
+				const __m128 n = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(two, mu1_mu2), c1), _mm_add_ps(_mm_mul_ps(two, s12), c2));
+				const __m128 d = _mm_mul_ps(_mm_add_ps(_mm_add_ps(mu1_sq, mu2_sq), c1), _mm_add_ps(_mm_add_ps(s1_sq, s2_sq), c2));
+
+				// A zero denominator contributes 0, like div_image().
+				const __m128 nonzero = _mm_cmpneq_ps(d, _mm_setzero_ps());
+				row_total = _mm_add_ps(row_total, _mm_and_ps(_mm_div_ps(n, _mm_or_ps(d, _mm_andnot_ps(nonzero, two))), nonzero));
+			}
+
+			vec4F row_sum;
+			_mm_storeu_ps(&row_sum[0], row_total);
+#else
+			vec4F row_sum(0.0f);
+
+			for (int x = 0; x < width; x++)
+			{
+				const uint32_t ofs = x * cSSIMTotalSums;
+
+				vec4F sums[cSSIMTotalSums];
+				for (uint32_t i = 0; i < cSSIMTotalSums; i++)
+					sums[i].set(0.0f);
+
+				for (int k = 0; k < cSSIMFilterSize; k++)
+					for (uint32_t i = 0; i < cSSIMTotalSums; i++)
+						sums[i] += pRows[k][ofs + i] * pKernel[k];
+
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					const float mu1 = sums[cSSIMSumA][c], mu2 = sums[cSSIMSumB][c];
+					const float mu1_sq = mu1 * mu1, mu2_sq = mu2 * mu2, mu1_mu2 = mu1 * mu2;
+					const float s1_sq = sums[cSSIMSumAA][c] - mu1_sq, s2_sq = sums[cSSIMSumBB][c] - mu2_sq, s12 = sums[cSSIMSumAB][c] - mu1_mu2;
 
-		gaussian_filter(s1_sq, a_sq, 11, 1.5f * 1.5f);
-		add_weighted_image(s1_sq, vec4F(1), mu1_sq, vec4F(-1), vec4F(0), s1_sq);
+					const float n = (2.0f * mu1_mu2 + C1) * (2.0f * s12 + C2);
+					const float d = (mu1_sq + mu2_sq + C1) * (s1_sq + s2_sq + C2);
 
-		gaussian_filter(s2_sq, b_sq, 11, 1.5f * 1.5f);
-		add_weighted_image(s2_sq, vec4F(1), mu2_sq, vec4F(-1), vec4F(0), s2_sq);
+					if (d != 0.0f)
+						row_sum[c] += n / d;
+				}
+			}
+#endif
 
-		gaussian_filter(s12, axb, 11, 1.5f * 1.5f);
-		add_weighted_image(s12, vec4F(1), mu1_mu2, vec4F(-1), vec4F(0), s12);
+			for (uint32_t c = 0; c < 4; c++)
+				total[c] += row_sum[c];
+		}
 
-		scale_image(mu1_mu2, t1, vec4F(2), vec4F(0));
-		adds_image(t1, vec4F(C1), t1);
+		return total;
+	}
 
-		scale_image(s12, t2, vec4F(2), vec4F(0));
-		adds_image(t2, vec4F(C2), t2);
+	// Reference: https://ece.uwaterloo.ca/~z70wang/research/ssim/index.html
+	// The 11x11 Gaussian window is applied as two separable passes, and all the filtered images and the SSIM map are computed together one band of rows 
+	// at a time, so no full size temporary images are needed. Each band's sum is kept separately and they're added up in band order, so the result 
+	// doesn't depend on the number of threads.
+	vec4F compute_ssim(const imagef &a, const imagef &b, job_pool *pJob_pool)
+	{
+		assert((a.get_width() == b.get_width()) && (a.get_height() == b.get_height()));
+
+		const int width = a.get_width(), height = a.get_height();
+		if ((!width) || (!height))
+			return vec4F(0);
 
-		mul_image(t1, t2, t3, vec4F(1));
+		float kernel[cSSIMFilterSize];
+		compute_gaussian_kernel(kernel, cSSIMFilterSize, 1, cSSIMFilterSigmaSqr, cComputeGaussianFlagNormalize);
 
-		add_image(mu1_sq, mu2_sq, t1);
-		adds_image(t1, vec4F(C1), t1);
+		// Each band recomputes the filtered rows just above and below it, so don't make them too small.
+		const uint32_t cMinRowsPerBand = 32;
+		const uint32_t total_bands = pJob_pool ? clamp<uint32_t>((uint32_t)pJob_pool->get_total_threads() * 4, 1, maximum<uint32_t>(1, height / cMinRowsPerBand)) : 1;
+		const int rows_per_band = (height + total_bands - 1) / total_bands;
 
-		add_image(s1_sq, s2_sq, t2);
-		adds_image(t2, vec4F(C2), t2);
+		basisu::vector<vec4D> band_sums(total_bands);
+
+		if (total_bands > 1)
+		{
+			for (uint32_t band_index = 0; band_index < total_bands; band_index++)
+			{
+				pJob_pool->add_job([&, band_index] {
+					band_sums[band_index] = ssim_sum_band(a, b, minimum<int>(height, band_index * rows_per_band), minimum<int>(height, (band_index + 1) * rows_per_band), kernel);
+				});
+			}
+
+			pJob_pool->wait_for_all();
+		}
+		else
+		{
+			band_sums[0] = ssim_sum_band(a, b, 0, height, kernel);
+		}
 
-		mul_image(t1, t2, t1, vec4F(1));
+		vec4D total(0.0f);
+		for (uint32_t band_index = 0; band_index < total_bands; band_index++)
+			total += band_sums[band_index];
 
-		div_image(t3, t1, smap, vec4F(1));
+		total /= (double)a.get_total_pixels();
 
-		return avg_image(smap);
+		return vec4F((float)total[0], (float)total[1], (float)total[2], (float)total[3]);
 	}
 
-	vec4F compute_ssim(const image &a, const image &b, bool luma, bool luma_601)
+	vec4F compute_ssim(const image &a, const image &b, bool luma, bool luma_601, job_pool *pJob_pool)
 	{
 		image ta(a), tb(b);
 
@@ -402,7 +565,7 @@ namespace basisu
 		fta.set(ta);
 		ftb.set(tb);
 
-		return compute_ssim(fta, ftb);
+		return compute_ssim(fta, ftb, pJob_pool);
 	}
 
 } // namespace basisu
@@ -16,6 +16,12 @@
 #include "basisu_astc_decomp.h"
 #include "basisu_gpu_texture.h"
 #include "basisu_bc7enc.h"
+#include <memory>
+
+#if BASISU_SUPPORT_SSE
+#define CPPSPMD_NAME(a) a##_sse41
+#include "basisu_kernels_declares.h"
+#endif
 
 #ifdef _DEBUG
 // When BASISU_VALIDATE_UASTC_ENC is 1, we pack and unpack to/from UASTC and ASTC, then validate that each codec returns the exact same results. This is slower.
@@ -2501,6 +2507,19 @@ namespace basisu
 	{
 		uint64_t total_err_r = 0, total_err_g = 0, total_err_b = 0, total_err_a = 0;
 
+#if BASISU_SUPPORT_SSE
+		if (g_cpu_supports_sse41)
+		{
+			int64_t comp_errors[4];
+			linear_distance_rgba_16_sse41(comp_errors, &block[0][0], &decoded_block[0][0]);
+
+			total_err_r = comp_errors[0];
+			total_err_g = comp_errors[1];
+			total_err_b = comp_errors[2];
+			total_err_a = comp_errors[3];
+		}
+		else
+#endif
 		for (uint32_t y = 0; y < 4; y++)
 		{
 			for (uint32_t x = 0; x < 4; x++)
@@ -2655,7 +2674,9 @@ namespace basisu
 		return (dist_to_gray_point_r * dist_to_gray_point_r) + (dist_to_gray_point_g * dist_to_gray_point_g) + (dist_to_gray_point_b * dist_to_gray_point_b);
 	}
 
-	static bool pack_etc1_estimate_flipped(const color_rgba* pSrc_pixels)
+	// Returns true if the block is probably better packed with flipped (4x2) subblocks. If pClear_winner is not nullptr, it's set to true when 
+	// one orientation's error estimate is at least 20% lower than the other's.
+	static bool pack_etc1_estimate_flipped(const color_rgba* pSrc_pixels, bool* pClear_winner = nullptr)
 	{
 		int sums[3][2][2];
 
@@ -2698,9 +2719,131 @@ namespace basisu
 		int upper_lower_sum = upper_gray_dist + lower_gray_dist;
 		int left_right_sum = left_gray_dist + right_gray_dist;
 
+		if (pClear_winner)
+			*pClear_winner = (minimum(upper_lower_sum, left_right_sum) * 5) < (maximum(upper_lower_sum, left_right_sum) * 4);
+
 		return upper_lower_sum < left_right_sum;
 	}
 
+	struct etc1_hint_subset_result
+	{
+		color_rgba m_base_color;
+		uint32_t m_inten_table;
+		uint64_t m_err;
+	};
+
+	// Finds the best intensity table for one ETC1 subblock of trial_block (its base color must already be set), and returns the error of that
+	// subblock against the original block. The result only depends on the subblock's base color, which lets the caller reuse it across biases.
+	static uint64_t compute_etc1_hint_subset(etc_block& trial_block, uint32_t subset, uint32_t flip, int level, 
+		const int min_r[2], const int min_g[2], const int min_b[2], const int max_r[2], const int max_g[2], const int max_b[2],
+		const ycbcr block_ycbcr[4][4], const ycbcr decoded_uastc_block_ycbcr[4][4], uint32_t& best_inten_table)
+	{
+		const color_rgba base_c(trial_block.get_block_color(subset, true));
+
+		const int pos_r = iabs(max_r[subset] - base_c.r);
+		const int neg_r = iabs(base_c.r - min_r[subset]);
+
+		const int pos_g = iabs(max_g[subset] - base_c.g);
+		const int neg_g = iabs(base_c.g - min_g[subset]);
+
+		const int pos_b = iabs(max_b[subset] - base_c.b);
+		const int neg_b = iabs(base_c.b - min_b[subset]);
+
+		const uint32_t range = maximum(maximum(pos_r, neg_r, pos_g, neg_g), pos_b, neg_b);
+
+		best_inten_table = 0;
+		uint64_t best_subset_err = UINT64_MAX;
+
+		const uint32_t inten_table_limit = (level == cPackUASTCLevelVerySlow) ? 8 : ((range > 51) ? 8 : (range >= 7 ? 4 : 2));
+						
+		for (uint32_t inten_table = 0; inten_table < inten_table_limit; inten_table++)
+		{
+			trial_block.set_inten_table(subset, inten_table);
+
+			color_rgba color_table[4];
+			trial_block.get_block_colors(color_table, subset);
+
+			ycbcr color_table_ycbcr[4];
+			for (uint32_t i = 0; i < 4; i++)
+				rgb_to_y_cb_cr(color_table[i], color_table_ycbcr[i]);
+
+			uint64_t total_error = 0;
+			if (flip)
+			{
+				for (uint32_t y = 0; y < 2; y++)
+				{
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][0];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][1];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][2];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][3];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+					if (total_error >= best_subset_err)
+						break;
+				}
+			}
+			else
+			{
+				for (uint32_t y = 0; y < 4; y++)
+				{
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[y][subset * 2 + 0];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+					{
+						const ycbcr& c = decoded_uastc_block_ycbcr[y][subset * 2 + 1];
+						total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
+					}
+				}
+				if (total_error >= best_subset_err)
+					break;
+			}
+
+			if (total_error < best_subset_err)
+			{
+				best_subset_err = total_error;
+				best_inten_table = inten_table;
+			}
+
+		} // inten_table
+
+		trial_block.set_inten_table(subset, best_inten_table);
+
+		// Compute error against the ORIGINAL block.
+		color_rgba color_table[4];
+		trial_block.get_block_colors(color_table, subset);
+
+		ycbcr color_table_ycbcr[4];
+		for (uint32_t i = 0; i < 4; i++)
+			rgb_to_y_cb_cr(color_table[i], color_table_ycbcr[i]);
+
+		uint64_t err = 0;
+
+		for (uint32_t i = 0; i < 8; i++)
+		{
+			const uint32_t x = flip ? (i & 3) : (subset * 2 + (i & 1));
+			const uint32_t y = flip ? (subset * 2 + (i >> 2)) : (i >> 1);
+
+			const ycbcr& c = decoded_uastc_block_ycbcr[y][x];
+			const uint64_t best_index_err = minimum(color_diff(color_table_ycbcr[0], c) << 2, (color_diff(color_table_ycbcr[1], c) << 2) + 1, (color_diff(color_table_ycbcr[2], c) << 2) + 2, (color_diff(color_table_ycbcr[3], c) << 2) + 3);
+
+			const uint32_t best_index = (uint32_t)best_index_err & 3;
+			err += color_diff(block_ycbcr[y][x], color_table_ycbcr[best_index]);
+		}
+
+		return err;
+	}
+
 	static void compute_etc1_hints(etc_block& best_etc1_blk, uint32_t& best_etc1_bias, const uastc_encode_results& best_results, const color_rgba block[4][4], const color_rgba decoded_uastc_block[4][4], int level, uint32_t flags)
 	{
 		best_etc1_bias = 0;
@@ -2788,19 +2931,39 @@ namespace basisu
 				first_flip = 1;
 			last_flip = first_flip + 1;
 		}
+		else if (level == cPackUASTCLevelDefault)
+		{
+			// Only search both orientations when the estimate is uncertain.
+			bool clear_winner = false;
+			const bool flipped = pack_etc1_estimate_flipped(&decoded_uastc_block[0][0], &clear_winner);
+			if (clear_winner)
+			{
+				first_flip = flipped ? 1 : 0;
+				last_flip = first_flip + 1;
+			}
+		}
 										
 		for (uint32_t flip = first_flip; flip < last_flip; flip++)
 		{
 			trial_block.set_flip_bit(flip != 0);
 
+			bool differential_fits = false;
+
 			for (uint32_t individ = first_individ; individ < last_individ; individ++)
 			{
+				// If both unbiased subblock colors fit into differential mode without clamping, its 5-bit colors will almost always beat 4-bit individual mode.
+				if ((individ) && (differential_fits) && (level <= cPackUASTCLevelDefault))
+					continue;
+
 				const uint32_t mul = individ ? 15 : 31;
 				
 				trial_block.set_diff_bit(individ == 0);
 
 				color_rgba unbiased_block_colors[2];
 
+				etc1_hint_subset_result cached_subsets[2][32];
+				uint32_t num_cached_subsets[2] = { 0, 0 };
+
 				int min_r[2] = { 255, 255 }, min_g[2] = { 255, 255 }, min_b[2] = { 255, 255 }, max_r[2] = { 0, 0 }, max_g[2] = { 0, 0 }, max_b[2] = { 0, 0 };
 
 				for (uint32_t subset = 0; subset < 2; subset++)
@@ -2832,6 +2995,15 @@ namespace basisu
 					unbiased_block_colors[subset][3] = 0;
 										
 				} // subset
+
+				if (!individ)
+				{
+					const int dr = unbiased_block_colors[1].r - unbiased_block_colors[0].r;
+					const int dg = unbiased_block_colors[1].g - unbiased_block_colors[0].g;
+					const int db = unbiased_block_colors[1].b - unbiased_block_colors[0].b;
+
+					differential_fits = (minimum(dr, dg, db) >= cETC1ColorDeltaMin) && (maximum(dr, dg, db) <= cETC1ColorDeltaMax);
+				}
 												
 				for (uint32_t bias_iter = 0; bias_iter < last_bias; bias_iter++)
 				{
@@ -2846,143 +3018,30 @@ namespace basisu
 					else
 						trial_block.set_block_color5_clamp(block_colors[0], block_colors[1]);
 
-					uint32_t range[2];
-					for (uint32_t subset = 0; subset < 2; subset++)
-					{
-						const color_rgba base_c(trial_block.get_block_color(subset, true));
-
-						const int pos_r = iabs(max_r[subset] - base_c.r);
-						const int neg_r = iabs(base_c.r - min_r[subset]);
-
-						const int pos_g = iabs(max_g[subset] - base_c.g);
-						const int neg_g = iabs(base_c.g - min_g[subset]);
-
-						const int pos_b = iabs(max_b[subset] - base_c.b);
-						const int neg_b = iabs(base_c.b - min_b[subset]);
-
-						range[subset] = maximum(maximum(pos_r, neg_r, pos_g, neg_g), pos_b, neg_b);
-					}
-
-					uint32_t best_inten_table[2] = { 0, 0 };
-
-					for (uint32_t subset = 0; subset < 2; subset++)
-					{
-						uint64_t best_subset_err = UINT64_MAX;
-
-						const uint32_t inten_table_limit = (level == cPackUASTCLevelVerySlow) ? 8 : ((range[subset] > 51) ? 8 : (range[subset] >= 7 ? 4 : 2));
-						
-						for (uint32_t inten_table = 0; inten_table < inten_table_limit; inten_table++)
-						{
-							trial_block.set_inten_table(subset, inten_table);
-
-							color_rgba color_table[4];
-							trial_block.get_block_colors(color_table, subset);
-
-							ycbcr color_table_ycbcr[4];
-							for (uint32_t i = 0; i < 4; i++)
-								rgb_to_y_cb_cr(color_table[i], color_table_ycbcr[i]);
-
-							uint64_t total_error = 0;
-							if (flip)
-							{
-								for (uint32_t y = 0; y < 2; y++)
-								{
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][0];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][1];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][2];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][3];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-									if (total_error >= best_subset_err)
-										break;
-								}
-							}
-							else
-							{
-								for (uint32_t y = 0; y < 4; y++)
-								{
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[y][subset * 2 + 0];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-									{
-										const ycbcr& c = decoded_uastc_block_ycbcr[y][subset * 2 + 1];
-										total_error += minimum(color_diff(color_table_ycbcr[0], c), color_diff(color_table_ycbcr[1], c), color_diff(color_table_ycbcr[2], c), color_diff(color_table_ycbcr[3], c));
-									}
-								}
-								if (total_error >= best_subset_err)
-									break;
-							}
-
-							if (total_error < best_subset_err)
-							{
-								best_subset_err = total_error;
-								best_inten_table[subset] = inten_table;
-							}
-
-						} // inten_table
-
-					} // subset
-
-					trial_block.set_inten_table(0, best_inten_table[0]);
-					trial_block.set_inten_table(1, best_inten_table[1]);
-
-					// Compute error against the ORIGINAL block.
+					// Each subblock's best intensity table and error only depend on its quantized base color, and many biases leave one of the 
+					// subblocks unchanged, so evaluate every distinct subblock color once.
 					uint64_t err = 0;
-
 					for (uint32_t subset = 0; subset < 2; subset++)
 					{
-						color_rgba color_table[4];
-						trial_block.get_block_colors(color_table, subset);
+						const color_rgba base_c(trial_block.get_block_color(subset, true));
 
-						ycbcr color_table_ycbcr[4];
-						for (uint32_t i = 0; i < 4; i++)
-							rgb_to_y_cb_cr(color_table[i], color_table_ycbcr[i]);
+						uint32_t cache_index;
+						for (cache_index = 0; cache_index < num_cached_subsets[subset]; cache_index++)
+							if (cached_subsets[subset][cache_index].m_base_color == base_c)
+								break;
 
-						if (flip)
+						etc1_hint_subset_result& r = cached_subsets[subset][cache_index];
+						if (cache_index == num_cached_subsets[subset])
 						{
-							for (uint32_t y = 0; y < 2; y++)
-							{
-								for (uint32_t x = 0; x < 4; x++)
-								{
-									const ycbcr& c = decoded_uastc_block_ycbcr[subset * 2 + y][x];
-									const uint64_t best_index_err = minimum(color_diff(color_table_ycbcr[0], c) << 2, (color_diff(color_table_ycbcr[1], c) << 2) + 1, (color_diff(color_table_ycbcr[2], c) << 2) + 2, (color_diff(color_table_ycbcr[3], c) << 2) + 3);
-
-									const uint32_t best_index = (uint32_t)best_index_err & 3;
-									err += color_diff(block_ycbcr[subset * 2 + y][x], color_table_ycbcr[best_index]);
-								}
-								if (err >= best_err)
-									break;
-							}
+							r.m_base_color = base_c;
+							r.m_err = compute_etc1_hint_subset(trial_block, subset, flip, level, min_r, min_g, min_b, max_r, max_g, max_b, block_ycbcr, decoded_uastc_block_ycbcr, r.m_inten_table);
+							num_cached_subsets[subset]++;
 						}
 						else
-						{
-							for (uint32_t y = 0; y < 4; y++)
-							{
-								for (uint32_t x = 0; x < 2; x++)
-								{
-									const ycbcr& c = decoded_uastc_block_ycbcr[y][subset * 2 + x];
-									const uint64_t best_index_err = minimum(color_diff(color_table_ycbcr[0], c) << 2, (color_diff(color_table_ycbcr[1], c) << 2) + 1, (color_diff(color_table_ycbcr[2], c) << 2) + 2, (color_diff(color_table_ycbcr[3], c) << 2) + 3);
-
-									const uint32_t best_index = (uint32_t)best_index_err & 3;
-									err += color_diff(block_ycbcr[y][subset * 2 + x], color_table_ycbcr[best_index]);
-								}
-								if (err >= best_err)
-									break;
-							}
-						}
+							trial_block.set_inten_table(subset, r.m_inten_table);
 
-					} // subset
+						err += r.m_err;
+					}
 
 					if (err < best_err)
 					{
@@ -3095,6 +3154,10 @@ namespace basisu
 
 	const int32_t DEFAULT_BC7_ERROR_WEIGHT = 50;
 	const float UASTC_ERROR_THRESH = 1.3f;
+	
+	// Line fit error below which the multiple subset and dual plane modes aren't tried at the faster levels. Measured as the squared distance of each 
+	// texel from the block's best fit color line, summed over the block's 16 texels.
+	const float UASTC_LINE_FIT_PRUNE_THRESH = 16.0f;
 
 	// TODO: This is a quick hack to favor certain modes when we know we'll be followed up with an RDO postprocess.
 	static inline float get_uastc_mode_weight(uint32_t mode)
@@ -3113,33 +3176,157 @@ namespace basisu
 		return 1.0f;
 	}
 
-	void encode_uastc(const uint8_t* pRGBAPixels, uastc_block& output_block, uint32_t flags)
+	// Per-block classification computed by analyze_uastc_blocks().
+	struct uastc_block_analysis
 	{
-//		printf("encode_uastc: \n");
-//		for (int i = 0; i < 16; i++)
-//			printf("[%u %u %u %u] ", pRGBAPixels[i * 4 + 0], pRGBAPixels[i * 4 + 1], pRGBAPixels[i * 4 + 2], pRGBAPixels[i * 4 + 3]);
-//		printf("\n");
+		bool m_solid_color;
+		bool m_has_alpha;
+		bool m_is_la;
 
-		const color_rgba(*block)[4] = reinterpret_cast<const color_rgba(*)[4]>(pRGBAPixels);
+		// Total squared distance of the block's pixels from their best fit line (the principal axis through their mean). Only L and A are 
+		// considered for LA blocks, and A only for blocks with alpha. Blocks with a low error are well served by the single subset, single plane modes.
+		float m_line_fit_err;
+	};
 
-		bool solid_color = true, has_alpha = false, is_la = true;
+	// Analyzes up to UASTC_ENCODE_BATCH_SIZE blocks at once. The pixels are transposed to a structure of arrays layout, so the inner loops run 
+	// across blocks and can be vectorized. Each block's result doesn't depend on the other blocks in the batch.
+	static void analyze_uastc_blocks(uint32_t num_blocks, const color_rgba* pBlock_pixels, uastc_block_analysis* pAnalysis)
+	{
+		assert((num_blocks >= 1) && (num_blocks <= UASTC_ENCODE_BATCH_SIZE));
 
-		const color_rgba first_color(block[0][0]);
-		for (uint32_t y = 0; y < 4; y++)
+		const uint32_t B = UASTC_ENCODE_BATCH_SIZE;
+
+		uint8_t pixels[4][16][B];
+		for (uint32_t b = 0; b < num_blocks; b++)
+			for (uint32_t i = 0; i < 16; i++)
+				for (uint32_t c = 0; c < 4; c++)
+					pixels[c][i][b] = pBlock_pixels[b * 16 + i][c];
+
+		uint8_t solid_color[B], has_alpha[B], is_la[B];
+		for (uint32_t b = 0; b < num_blocks; b++)
 		{
-			for (uint32_t x = 0; x < 4; x++)
+			solid_color[b] = 1;
+			has_alpha[b] = 0;
+			is_la[b] = 1;
+		}
+
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t b = 0; b < num_blocks; b++)
+			{
+				has_alpha[b] |= (pixels[3][i][b] < 255);
+				solid_color[b] &= (pixels[0][i][b] == pixels[0][0][b]) & (pixels[1][i][b] == pixels[1][0][b]) & (pixels[2][i][b] == pixels[2][0][b]) & (pixels[3][i][b] == pixels[3][0][b]);
+				is_la[b] &= (pixels[0][i][b] == pixels[1][i][b]) & (pixels[0][i][b] == pixels[2][i][b]);
+			}
+		}
+
+		// Line fit components: LA blocks use (L, A), all others (R, G, B) plus A if the block has alpha. Unused components are left at 0, which
+		// doesn't change any of the sums below.
+		float v[4][16][B];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t b = 0; b < num_blocks; b++)
+			{
+				v[0][i][b] = pixels[0][i][b];
+				v[1][i][b] = is_la[b] ? pixels[3][i][b] : pixels[1][i][b];
+				v[2][i][b] = is_la[b] ? 0.0f : pixels[2][i][b];
+				v[3][i][b] = (is_la[b] || !has_alpha[b]) ? 0.0f : pixels[3][i][b];
+			}
+		}
+
+		float mean[4][B];
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			for (uint32_t b = 0; b < num_blocks; b++)
+				mean[c][b] = 0.0f;
+
+			for (uint32_t i = 0; i < 16; i++)
+				for (uint32_t b = 0; b < num_blocks; b++)
+					mean[c][b] += v[c][i][b];
+
+			for (uint32_t b = 0; b < num_blocks; b++)
+				mean[c][b] *= (1.0f / 16.0f);
+		}
+
+		float cov[4][4][B];
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			for (uint32_t c2 = c; c2 < 4; c2++)
 			{
-				if (block[y][x].a < 255)
-					has_alpha = true;
+				for (uint32_t b = 0; b < num_blocks; b++)
+					cov[c][c2][b] = 0.0f;
+
+				for (uint32_t i = 0; i < 16; i++)
+					for (uint32_t b = 0; b < num_blocks; b++)
+						cov[c][c2][b] += (v[c][i][b] - mean[c][b]) * (v[c2][i][b] - mean[c2][b]);
+			}
+
+			for (uint32_t c2 = 0; c2 < c; c2++)
+				for (uint32_t b = 0; b < num_blocks; b++)
+					cov[c][c2][b] = cov[c2][c][b];
+		}
 
-				if (block[y][x] != first_color)
-					solid_color = false;
+		float total_var[B], axis[4][B];
+		for (uint32_t b = 0; b < num_blocks; b++)
+		{
+			total_var[b] = ((cov[0][0][b] + cov[1][1][b]) + cov[2][2][b]) + cov[3][3][b];
+
+			// Power iteration starts at the component with the most variance.
+			uint32_t max_comp = 0;
+			for (uint32_t c = 1; c < 4; c++)
+				if (cov[c][c][b] > cov[max_comp][max_comp][b])
+					max_comp = c;
 
-				if ((block[y][x].r != block[y][x].g) || (block[y][x].r != block[y][x].b))
-					is_la = false;
+			for (uint32_t c = 0; c < 4; c++)
+				axis[c][b] = (c == max_comp) ? 1.0f : 0.0f;
+		}
+
+		for (uint32_t iter = 0; iter < 4; iter++)
+		{
+			float t[4][B], max_t[B];
+			for (uint32_t b = 0; b < num_blocks; b++)
+				max_t[b] = 0.0f;
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				for (uint32_t b = 0; b < num_blocks; b++)
+				{
+					t[c][b] = ((cov[c][0][b] * axis[0][b] + cov[c][1][b] * axis[1][b]) + cov[c][2][b] * axis[2][b]) + cov[c][3][b] * axis[3][b];
+					max_t[b] = maximum(max_t[b], fabsf(t[c][b]));
+				}
 			}
+
+			// A block with no variance keeps its starting axis.
+			for (uint32_t c = 0; c < 4; c++)
+				for (uint32_t b = 0; b < num_blocks; b++)
+					axis[c][b] = (max_t[b] > 0.0f) ? (t[c][b] / max_t[b]) : axis[c][b];
 		}
 
+		for (uint32_t b = 0; b < num_blocks; b++)
+		{
+			const float len = ((axis[0][b] * axis[0][b] + axis[1][b] * axis[1][b]) + axis[2][b] * axis[2][b]) + axis[3][b] * axis[3][b];
+
+			// Variance along the axis (Rayleigh quotient)
+			float axis_var = 0.0f;
+			for (uint32_t c = 0; c < 4; c++)
+				for (uint32_t c2 = 0; c2 < 4; c2++)
+					axis_var += axis[c][b] * cov[c][c2][b] * axis[c2][b];
+
+			uastc_block_analysis& a = pAnalysis[b];
+			a.m_solid_color = solid_color[b] != 0;
+			a.m_has_alpha = has_alpha[b] != 0;
+			a.m_is_la = is_la[b] != 0;
+			a.m_line_fit_err = (total_var[b] == 0.0f) ? 0.0f : maximum(0.0f, total_var[b] - axis_var / len);
+		}
+	}
+
+	static void encode_uastc_block(const color_rgba block[4][4], const uastc_block_analysis& analysis, uastc_block& output_block, uint32_t flags)
+	{
+		const bool solid_color = analysis.m_solid_color, has_alpha = analysis.m_has_alpha;
+		bool is_la = analysis.m_is_la;
+
+		const color_rgba first_color(block[0][0]);
+
 		if (solid_color)
 		{
 			// Solid color blocks are so common that we handle them specially and as quickly as we can.
@@ -3263,6 +3450,18 @@ namespace basisu
 				is_la = false;
 		}
 
+		// At the faster levels, skip the multiple subset and dual plane modes on blocks whose pixels lie close to a single line through color space. 
+		// These modes are the most expensive to evaluate and they rarely win on such blocks.
+		if ((level == cPackUASTCLevelFaster) || (level == cPackUASTCLevelDefault))
+		{
+			if (analysis.m_line_fit_err < UASTC_LINE_FIT_PRUNE_THRESH)
+			{
+				mode_mask &= ~((1 << 2) | (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | 
+					(1 << 9) | (1 << 11) | (1 << 13) | 
+					(1 << 16) | (1 << 17));
+			}
+		}
+
 		const bool try_alpha_modes = has_alpha || always_try_alpha_modes;
 		
 		bc7enc_compress_block_params comp_params;
@@ -3633,6 +3832,47 @@ namespace basisu
 //		printf("\n");
 	}
 
+	void encode_uastc(const uint8_t* pRGBAPixels, uastc_block& output_block, uint32_t flags)
+	{
+//		printf("encode_uastc: \n");
+//		for (int i = 0; i < 16; i++)
+//			printf("[%u %u %u %u] ", pRGBAPixels[i * 4 + 0], pRGBAPixels[i * 4 + 1], pRGBAPixels[i * 4 + 2], pRGBAPixels[i * 4 + 3]);
+//		printf("\n");
+
+		const color_rgba* pPixels = reinterpret_cast<const color_rgba*>(pRGBAPixels);
+
+		uastc_block_analysis analysis;
+		analyze_uastc_blocks(1, pPixels, &analysis);
+
+		encode_uastc_block(reinterpret_cast<const color_rgba(*)[4]>(pPixels), analysis, output_block, flags);
+	}
+
+	void encode_uastc_blocks(uint32_t num_blocks, const color_rgba* pBlock_pixels, uastc_block* pOutput_blocks, uint32_t flags)
+	{
+		for (uint32_t first_block = 0; first_block < num_blocks; first_block += UASTC_ENCODE_BATCH_SIZE)
+		{
+			const uint32_t n = minimum<uint32_t>(num_blocks - first_block, UASTC_ENCODE_BATCH_SIZE);
+
+			uastc_block_analysis analysis[UASTC_ENCODE_BATCH_SIZE];
+			analyze_uastc_blocks(n, pBlock_pixels + first_block * 16, analysis);
+
+			for (uint32_t i = 0; i < n; i++)
+			{
+				const uint32_t block_index = first_block + i;
+				const color_rgba* pPixels = pBlock_pixels + block_index * 16;
+
+				// Encoding is deterministic, so runs of identical blocks (common in UI textures and atlases) only need to be encoded once.
+				if ((block_index) && (memcmp(pPixels, pPixels - 16, sizeof(color_rgba) * 16) == 0))
+				{
+					pOutput_blocks[block_index] = pOutput_blocks[block_index - 1];
+					continue;
+				}
+
+				encode_uastc_block(reinterpret_cast<const color_rgba(*)[4]>(pPixels), analysis[i], pOutput_blocks[block_index], flags);
+			}
+		}
+	}
+
 	static bool uastc_recompute_hints(basist::uastc_block* pBlock, const color_rgba* pBlock_pixels, uint32_t flags, const unpacked_uastc_block *pUnpacked_blk)
 	{
 		unpacked_uastc_block unpacked_blk;
@@ -3779,6 +4019,61 @@ namespace basisu
 		return len_cost + dist_cost;
 	}
 
+	// Zstd's repeat offsets: the 3 most recently used match distances in bytes.
+	struct zstd_rep_offsets
+	{
+		uint32_t m_dist[3];
+
+		zstd_rep_offsets() { m_dist[0] = 1; m_dist[1] = 4; m_dist[2] = 8; }
+
+		int find(uint32_t dist) const
+		{
+			for (uint32_t i = 0; i < 3; i++)
+				if (m_dist[i] == dist)
+					return i;
+			return -1;
+		}
+
+		void update(uint32_t dist)
+		{
+			const int i = find(dist);
+			if (i == 0)
+				return;
+
+			for (int j = (i < 0) ? 2 : i; j > 0; j--)
+				m_dist[j] = m_dist[j - 1];
+			m_dist[0] = dist;
+		}
+	};
+
+	// Zstd codes a match at one of the repeat offsets with just an offset code, so it's estimated to cost the same as a Deflate match with no distance 
+	// extra bits. Matches at other distances are estimated to cost the same as with Deflate.
+	static inline uint32_t compute_zstd_match_cost_estimate(uint32_t dist, const zstd_rep_offsets& reps)
+	{
+		const int rep_index = reps.find(dist);
+		if (rep_index >= 0)
+			return 7 + 5 + rep_index;
+		
+		return compute_match_cost_estimate(dist);
+	}
+
+	static inline uint32_t compute_match_cost_estimate(uint32_t dist, const zstd_rep_offsets* pReps)
+	{
+		return pReps ? compute_zstd_match_cost_estimate(dist, *pReps) : compute_match_cost_estimate(dist);
+	}
+
+	static bool selectors_equal(const basist::uastc_block& a, const basist::uastc_block& b, uint32_t first_sel_bit, uint32_t total_sel_bits)
+	{
+		for (uint32_t ofs = 0; ofs < total_sel_bits; ofs += 64)
+		{
+			const uint32_t n = basisu::minimum(64U, total_sel_bits - ofs);
+			uint32_t a_ofs = first_sel_bit + ofs, b_ofs = first_sel_bit + ofs;
+			if (read_bits((const uint8_t*)&a, a_ofs, n) != read_bits((const uint8_t*)&b, b_ofs, n))
+				return false;
+		}
+		return true;
+	}
+
 	struct selector_bitsequence
 	{
 		uint64_t m_sel;
@@ -3801,11 +4096,83 @@ namespace basisu
 		}
 	};
 
-	struct selector_bitsequence_hash
+	// Maps selector bit sequences to the index of the most recent block using them. Open addressing with linear probing, so unlike std::unordered_map
+	// lookups and inserts don't allocate or chase pointers. This is queried once for every candidate block in the LZ window, so it's hot with large dictionaries.
+	class selector_history_table
 	{
-		std::size_t operator()(selector_bitsequence const& s) const noexcept
+	public:
+		selector_history_table() : m_size(0) { m_entries.resize(1024); }
+
+		// Returns -1 if the sequence hasn't been seen.
+		int find(const selector_bitsequence& s) const
+		{
+			const uint32_t mask = (uint32_t)m_entries.size() - 1;
+			for (uint32_t i = hash(s) & mask; ; i = (i + 1) & mask)
+			{
+				const entry& e = m_entries[i];
+				if (!e.m_used)
+					return -1;
+				if (e.m_seq == s)
+					return e.m_block_index;
+			}
+		}
+
+		void set(const selector_bitsequence& s, uint32_t block_index)
+		{
+			if ((m_size + 1) * 2 > m_entries.size())
+				grow();
+
+			entry& e = find_slot(s);
+			if (!e.m_used)
+			{
+				e.m_used = true;
+				e.m_seq = s;
+				m_size++;
+			}
+			e.m_block_index = block_index;
+		}
+
+	private:
+		struct entry
+		{
+			entry() : m_block_index(0), m_used(false) { }
+
+			selector_bitsequence m_seq;
+			uint32_t m_block_index;
+			bool m_used;
+		};
+
+		std::vector<entry> m_entries;
+		uint32_t m_size;
+
+		static inline uint32_t hash(const selector_bitsequence& s)
+		{
+			const uint64_t h = (s.m_sel ^ ((uint64_t)s.m_ofs << 57) ^ s.m_ofs) * 0x9E3779B97F4A7C15ULL;
+			return (uint32_t)(h >> 32);
+		}
+
+		entry& find_slot(const selector_bitsequence& s)
 		{
-			return static_cast<std::size_t>(hash_hsieh((uint8_t *)&s, sizeof(s)) ^ s.m_sel);
+			const uint32_t mask = (uint32_t)m_entries.size() - 1;
+			for (uint32_t i = hash(s) & mask; ; i = (i + 1) & mask)
+			{
+				entry& e = m_entries[i];
+				if ((!e.m_used) || (e.m_seq == s))
+					return e;
+			}
+		}
+
+		void grow()
+		{
+			std::vector<entry> old_entries;
+			old_entries.swap(m_entries);
+			m_entries.resize(old_entries.size() * 2);
+
+			for (size_t i = 0; i < old_entries.size(); i++)
+			{
+				if (old_entries[i].m_used)
+					find_slot(old_entries[i].m_seq) = old_entries[i];
+			}
 		}
 	};
 
@@ -3834,15 +4201,46 @@ namespace basisu
 		uint64_t m_total2;
 	};
 		
+	// pSeed_blocks/num_seed_blocks: Optional copy of the blocks immediately preceding first_index. They're only used to prime the simulated LZ window, and are never modified.
 	static bool uastc_rdo_blocks(uint32_t first_index, uint32_t last_index, basist::uastc_block* pBlocks, const color_rgba* pBlock_pixels, const uastc_rdo_params& params, uint32_t flags, 
-		uint32_t &total_skipped, uint32_t &total_refined, uint32_t &total_modified, uint32_t &total_smooth)
+		uint32_t &total_skipped, uint32_t &total_refined, uint32_t &total_modified, uint32_t &total_smooth,
+		const basist::uastc_block* pSeed_blocks = nullptr, uint32_t num_seed_blocks = 0)
 	{
+		BASISU_TRACE_SCOPE_ARG("uastc_rdo_blocks", "uastc_rdo", first_index);
+
 		debug_printf("uastc_rdo_blocks: Processing blocks %u to %u\n", first_index, last_index);
 
+		assert(num_seed_blocks <= first_index);
+
 		const int total_blocks_to_check = basisu::maximum<uint32_t>(1U, params.m_lz_dict_size / sizeof(basist::uastc_block));
 		const bool perceptual = false;
 
-		std::unordered_map<selector_bitsequence, uint32_t, selector_bitsequence_hash> selector_history;
+		const int first_seed_index = first_index - num_seed_blocks;
+
+		selector_history_table selector_history;
+
+		for (uint32_t i = 0; i < num_seed_blocks; i++)
+		{
+			unpacked_uastc_block unpacked_seed_blk;
+			if (!unpack_uastc(pSeed_blocks[i], unpacked_seed_blk, false, true))
+				continue;
+
+			if (unpacked_seed_blk.m_mode == UASTC_MODE_INDEX_SOLID_COLOR)
+				continue;
+
+			const uint32_t first_sel_bit = g_uastc_mode_selector_bits[unpacked_seed_blk.m_mode][0];
+			const uint32_t total_sel_bits = g_uastc_mode_selector_bits[unpacked_seed_blk.m_mode][1];
+
+			uint32_t bit_offset = first_sel_bit;
+			uint64_t sel_bits = read_bits((const uint8_t*)&pSeed_blocks[i], bit_offset, basisu::minimum(64U, total_sel_bits));
+
+			selector_history.set(selector_bitsequence(first_sel_bit, sel_bits), first_seed_index + i);
+		}
+
+		auto get_block = [&](int i) -> const basist::uastc_block& { return (i < (int)first_index) ? pSeed_blocks[i - first_seed_index] : pBlocks[i]; };
+
+		zstd_rep_offsets reps;
+		const zstd_rep_offsets* pReps = params.m_zstd_cost_model ? &reps : nullptr;
 						
 		for (uint32_t block_index = first_index; block_index < last_index; block_index++)
 		{
@@ -3914,19 +4312,34 @@ namespace basisu
 
 			if (cur_rms_err >= params.m_skip_block_rms_thresh)
 			{
-				auto cur_search_res = selector_history.insert(std::make_pair(selector_bitsequence(first_sel_bit, cur_sel_bits), block_index));
-
 				// Block already has too much error, so don't mess with it.
-				if (!cur_search_res.second)
-					(*cur_search_res.first).second = block_index;
+				selector_history.set(selector_bitsequence(first_sel_bit, cur_sel_bits), block_index);
 
 				total_skipped++;
 				continue;
 			}
 
+			int first_block_to_check = basisu::maximum<int>(first_seed_index, block_index - total_blocks_to_check);
+			int last_block_to_check = block_index - 1;
+
+			// With the Zstd cost model, the blocks at repeat offset distances are tried before the others. Matches against them are cheap, so the scan 
+			// of the remaining blocks can stop earlier.
+			int rep_candidates[3];
+			uint32_t num_rep_candidates = 0;
+			if (pReps)
+			{
+				for (uint32_t i = 0; i < 3; i++)
+				{
+					const int prev_block_index = block_index - (int)(reps.m_dist[i] / 16);
+					if (((reps.m_dist[i] & 15) == 0) && (prev_block_index >= first_block_to_check) && (prev_block_index <= last_block_to_check))
+						rep_candidates[num_rep_candidates++] = prev_block_index;
+				}
+			}
+
 			int cur_bits;
-			auto cur_find_res = selector_history.find(selector_bitsequence(first_sel_bit, cur_sel_bits));
-			if (cur_find_res == selector_history.end())
+			uint32_t cur_match_dist = 0;
+			const int cur_match_block_index = selector_history.find(selector_bitsequence(first_sel_bit, cur_sel_bits));
+			if (cur_match_block_index < 0)
 			{
 				// Wasn't found - wildly estimate literal cost
 				//cur_bits = (total_sel_bits * 5) / 4;
@@ -3935,35 +4348,72 @@ namespace basisu
 			else
 			{
 				// Was found - wildly estimate match cost
-				uint32_t match_block_index = cur_find_res->second;
+				uint32_t match_block_index = cur_match_block_index;
 				const int block_dist_in_bytes = (block_index - match_block_index) * 16;
-				cur_bits = compute_match_cost_estimate(block_dist_in_bytes);
+				cur_bits = compute_match_cost_estimate(block_dist_in_bytes, pReps);
+				cur_match_dist = block_dist_in_bytes;
 			}
 
-			int first_block_to_check = basisu::maximum<int>(first_index, block_index - total_blocks_to_check);
-			int last_block_to_check = block_index - 1;
+			for (uint32_t i = 0; i < num_rep_candidates; i++)
+			{
+				const uint32_t dist = (block_index - rep_candidates[i]) * 16;
+				const int rep_bits = compute_match_cost_estimate(dist, pReps);
+				if ((rep_bits < cur_bits) && (selectors_equal(blk, get_block(rep_candidates[i]), first_sel_bit, total_sel_bits)))
+				{
+					cur_bits = rep_bits;
+					cur_match_dist = dist;
+				}
+			}
 
 			basist::uastc_block best_block(blk);
 			uint32_t best_block_index = block_index;
+			uint32_t best_match_dist = 0;
 
 			float best_t = cur_ms_err * smooth_block_error_scale + cur_bits * params.m_lambda;
 
 			// Now scan through previous blocks, insert their selector bit patterns into the current block, and find 
 			// selector bit patterns which don't increase the overall block error too much.
-			for (int prev_block_index = last_block_to_check; prev_block_index >= first_block_to_check; --prev_block_index)
+			for (int cand_index = -(int)num_rep_candidates; ; cand_index++)
 			{
-				const basist::uastc_block& prev_blk = pBlocks[prev_block_index];
+				int prev_block_index, min_match_bits;
+				if (cand_index < 0)
+				{
+					prev_block_index = rep_candidates[cand_index + (int)num_rep_candidates];
+					min_match_bits = compute_match_cost_estimate((block_index - prev_block_index) * 16, pReps);
+					if (min_match_bits * params.m_lambda >= best_t)
+						continue;
+				}
+				else
+				{
+					prev_block_index = last_block_to_check - cand_index;
+					if (prev_block_index < first_block_to_check)
+						break;
+
+					if ((num_rep_candidates) && (std::find(rep_candidates, rep_candidates + num_rep_candidates, prev_block_index) != rep_candidates + num_rep_candidates))
+						continue;
+
+					// Any (non repeat offset) match against this or an earlier block is at least this far away, and the match cost estimate only grows with distance. 
+					// So once the rate term alone can't beat the best trial, no earlier block can either.
+					min_match_bits = compute_match_cost_estimate((block_index - prev_block_index) * 16, pReps);
+					if (min_match_bits * params.m_lambda >= best_t)
+						break;
+				}
+
+				const basist::uastc_block& prev_blk = get_block(prev_block_index);
 
 				uint32_t bit_offset = first_sel_bit;
 				uint64_t sel_bits = read_bits((const uint8_t*)&prev_blk, bit_offset, basisu::minimum(64U, total_sel_bits));
 
 				int match_block_index = prev_block_index;
-				auto res = selector_history.find(selector_bitsequence(first_sel_bit, sel_bits));
-				if (res != selector_history.end())
-					match_block_index = res->second;
-				// Have we already checked this bit pattern? If so then skip this block.
-				if (match_block_index > prev_block_index)
-					continue;
+				if (cand_index >= 0)
+				{
+					const int history_block_index = selector_history.find(selector_bitsequence(first_sel_bit, sel_bits));
+					if (history_block_index >= 0)
+						match_block_index = history_block_index;
+					// Have we already checked this bit pattern? If so then skip this block.
+					if (match_block_index > prev_block_index)
+						continue;
+				}
 
 				unpacked_uastc_block unpacked_prev_blk;
 				if (!unpack_uastc(prev_blk, unpacked_prev_blk, false, true))
@@ -3992,6 +4442,13 @@ namespace basisu
 				for (uint32_t i = 0; i < 16; i++)
 					trial_uastc_err += color_distance(perceptual, pPixels[i], ((color_rgba*)decoded_trial_uastc_block)[i], true);
 
+				// The trial's error below is at least half its UASTC error, so skip the BC7 transcode when that alone rules the trial out.
+				const float min_trial_ms_err = (float)(trial_uastc_err / 2) * (1.0f / 64.0f);
+				if (sqrtf(min_trial_ms_err) > cur_rms_err * params.m_max_allowed_rms_increase_ratio)
+					continue;
+				if ((min_trial_ms_err * smooth_block_error_scale + min_match_bits * params.m_lambda) >= best_t)
+					continue;
+
 				// Transcode trial to BC7, compute error
 				bc7_optimization_results trial_b7_results;
 				if (!transcode_uastc_to_bc7(unpacked_trial_blk, trial_b7_results))
@@ -4016,13 +4473,14 @@ namespace basisu
 					continue;
 
 				const int block_dist_in_bytes = (block_index - match_block_index) * 16;
-				const int match_bits = compute_match_cost_estimate(block_dist_in_bytes);
+				const int match_bits = compute_match_cost_estimate(block_dist_in_bytes, pReps);
 
 				float t = trial_ms_err * smooth_block_error_scale + match_bits * params.m_lambda;
 				if (t < best_t)
 				{
 					best_t = t;
 					best_block_index = prev_block_index;
+					best_match_dist = block_dist_in_bytes;
 
 					best_block = trial_blk;
 				}
@@ -4104,9 +4562,14 @@ namespace basisu
 				uint32_t bit_offset = first_sel_bit;
 				uint64_t sel_bits = read_bits((const uint8_t*)&best_block, bit_offset, basisu::minimum(64U, total_sel_bits));
 
-				auto res = selector_history.insert(std::make_pair(selector_bitsequence(first_sel_bit, sel_bits), block_index));
-				if (!res.second)
-					(*res.first).second = block_index;
+				selector_history.set(selector_bitsequence(first_sel_bit, sel_bits), block_index);
+			}
+
+			if (pReps)
+			{
+				const uint32_t match_dist = (best_block_index != block_index) ? best_match_dist : cur_match_dist;
+				if (match_dist)
+					reps.update(match_dist);
 			}
 
 		} // block_index
@@ -4120,66 +4583,133 @@ namespace basisu
 	// One nice advantage of the method used here is that it works for any input, no matter which or how many modes it uses.
 	bool uastc_rdo(uint32_t num_blocks, basist::uastc_block* pBlocks, const color_rgba* pBlock_pixels, const uastc_rdo_params& params, uint32_t flags, job_pool* pJob_pool, uint32_t total_jobs)
 	{
+		BASISU_TRACE_SCOPE("uastc_rdo", "uastc_rdo");
+
+		if (!pJob_pool)
+			total_jobs = 0;
+
+		if (total_jobs > 1)
+		{
+			bool status = false;
+			uastc_rdo_async(num_blocks, pBlocks, pBlock_pixels, params, flags, *pJob_pool, total_jobs, [&status](bool s) { status = s; });
+#ifndef __EMSCRIPTEN__
+			pJob_pool->wait_for_all();
+#endif
+			return status;
+		}
+
 		assert(params.m_max_allowed_rms_increase_ratio > 1.0f);
 		assert(params.m_lz_dict_size > 0);
 		assert(params.m_lambda > 0.0f);
 
 		uint32_t total_skipped = 0, total_modified = 0, total_refined = 0, total_smooth = 0;
 
-		uint32_t blocks_per_job = total_jobs ? (num_blocks / total_jobs) : 0;
+		bool status = uastc_rdo_blocks(0, num_blocks, pBlocks, pBlock_pixels, params, flags, total_skipped, total_refined, total_modified, total_smooth);
+
+		debug_printf("uastc_rdo: Total modified: %3.2f%%, total skipped: %3.2f%%, total refined: %3.2f%%, total smooth: %3.2f%%\n", total_modified * 100.0f / num_blocks, total_skipped * 100.0f / num_blocks, total_refined * 100.0f / num_blocks, total_smooth * 100.0f / num_blocks);
+				
+		return status;
+	}
+
+	// Shared by the jobs issued by uastc_rdo_async(). Owned by a shared_ptr, so it lives until the last job finishes.
+	struct uastc_rdo_async_state
+	{
+		uastc_rdo_params m_params;
+		std::function<void(bool)> m_on_complete;
+
+		uint32_t m_num_blocks;
+		std::atomic<uint32_t> m_jobs_remaining;
+
+		// Copies of the blocks preceding each job's range
+		std::vector<std::vector<basist::uastc_block> > m_seed_blocks;
 
-		std::mutex stat_mutex;
+		std::mutex m_stat_mutex;
+		bool m_all_succeeded;
+		uint32_t m_total_skipped, m_total_modified, m_total_refined, m_total_smooth;
+	};
 
-		bool status = false;
+	void uastc_rdo_async(uint32_t num_blocks, basist::uastc_block* pBlocks, const color_rgba* pBlock_pixels, const uastc_rdo_params& params, uint32_t flags, job_pool& jpool, uint32_t total_jobs, 
+		const std::function<void(bool)>& on_complete)
+	{
+		BASISU_TRACE_SCOPE("uastc_rdo_async", "uastc_rdo");
 
-		if ((!pJob_pool) || (total_jobs <= 1) || (blocks_per_job <= 8))
+		assert(params.m_max_allowed_rms_increase_ratio > 1.0f);
+		assert(params.m_lz_dict_size > 0);
+		assert(params.m_lambda > 0.0f);
+
+		// Don't split the blocks into ranges too small to be worth a job.
+		total_jobs = minimum<uint32_t>(total_jobs, num_blocks / UASTC_RDO_MIN_BLOCKS_PER_JOB);
+
+		if (total_jobs <= 1)
 		{
-			status = uastc_rdo_blocks(0, num_blocks, pBlocks, pBlock_pixels, params, flags, total_skipped, total_refined, total_modified, total_smooth);
+			on_complete(uastc_rdo(num_blocks, pBlocks, pBlock_pixels, params, flags));
+			return;
 		}
-		else
+
+		const uint32_t blocks_per_job = (num_blocks + total_jobs - 1) / total_jobs;
+		const uint32_t total_window_blocks = basisu::maximum<uint32_t>(1U, params.m_lz_dict_size / sizeof(basist::uastc_block));
+
+		std::shared_ptr<uastc_rdo_async_state> pState(std::make_shared<uastc_rdo_async_state>());
+		pState->m_params = params;
+		pState->m_on_complete = on_complete;
+		pState->m_num_blocks = num_blocks;
+		pState->m_jobs_remaining = (num_blocks + blocks_per_job - 1) / blocks_per_job;
+		pState->m_seed_blocks.resize(pState->m_jobs_remaining);
+		pState->m_all_succeeded = true;
+		pState->m_total_skipped = 0;
+		pState->m_total_modified = 0;
+		pState->m_total_refined = 0;
+		pState->m_total_smooth = 0;
+
+		// Each range's LZ window is primed with a copy of the blocks preceding it (as they were before RDO), instead of starting out empty.
+		// The copies must all be made before any job starts modifying blocks.
+		for (uint32_t job_index = 1; job_index < pState->m_seed_blocks.size(); job_index++)
 		{
-			bool all_succeeded = true;
+			const uint32_t first_index = job_index * blocks_per_job;
+			const uint32_t num_seed_blocks = minimum(first_index, total_window_blocks);
 
-			for (uint32_t block_index_iter = 0; block_index_iter < num_blocks; block_index_iter += blocks_per_job)
-			{
-				const uint32_t first_index = block_index_iter;
-				const uint32_t last_index = minimum<uint32_t>(num_blocks, block_index_iter + blocks_per_job);
+			pState->m_seed_blocks[job_index].assign(pBlocks + first_index - num_seed_blocks, pBlocks + first_index);
+		}
+
+		for (uint32_t block_index_iter = 0; block_index_iter < num_blocks; block_index_iter += blocks_per_job)
+		{
+			const uint32_t first_index = block_index_iter;
+			const uint32_t last_index = minimum<uint32_t>(num_blocks, block_index_iter + blocks_per_job);
+			const uint32_t job_index = block_index_iter / blocks_per_job;
 
+			// FIXME: This sucks, but we're having a stack size related problem with std::function with emscripten.
 #ifndef __EMSCRIPTEN__
-				pJob_pool->add_job([first_index, last_index, pBlocks, pBlock_pixels, &params, flags, &total_skipped, &total_modified, &total_refined, &total_smooth, &all_succeeded, &stat_mutex] {
+			jpool.add_job([first_index, last_index, job_index, pBlocks, pBlock_pixels, flags, pState] {
 #endif
+				uastc_rdo_async_state& state = *pState;
+				const std::vector<basist::uastc_block>& seed_blocks = state.m_seed_blocks[job_index];
 
-					uint32_t job_skipped = 0, job_modified = 0, job_refined = 0, job_smooth = 0;
+				uint32_t job_skipped = 0, job_modified = 0, job_refined = 0, job_smooth = 0;
 
-					bool status = uastc_rdo_blocks(first_index, last_index, pBlocks, pBlock_pixels, params, flags, job_skipped, job_refined, job_modified, job_smooth);
+				bool status = uastc_rdo_blocks(first_index, last_index, pBlocks, pBlock_pixels, state.m_params, flags, job_skipped, job_refined, job_modified, job_smooth,
+					seed_blocks.data(), (uint32_t)seed_blocks.size());
 
-					{
-						std::lock_guard<std::mutex> lck(stat_mutex);
-						
-						all_succeeded = all_succeeded && status;
-						total_skipped += job_skipped;
-						total_modified += job_modified;
-						total_refined += job_refined;
-						total_smooth += job_smooth;
-					}
+				{
+					std::lock_guard<std::mutex> lck(state.m_stat_mutex);
 
-#ifndef __EMSCRIPTEN__
-					}
-				);
-#endif
+					state.m_all_succeeded = state.m_all_succeeded && status;
+					state.m_total_skipped += job_skipped;
+					state.m_total_modified += job_modified;
+					state.m_total_refined += job_refined;
+					state.m_total_smooth += job_smooth;
+				}
 
-			} // block_index_iter
+				if (state.m_jobs_remaining.fetch_sub(1) == 1)
+				{
+					const uint32_t n = state.m_num_blocks;
+					debug_printf("uastc_rdo: Total modified: %3.2f%%, total skipped: %3.2f%%, total refined: %3.2f%%, total smooth: %3.2f%%\n", state.m_total_modified * 100.0f / n, state.m_total_skipped * 100.0f / n, state.m_total_refined * 100.0f / n, state.m_total_smooth * 100.0f / n);
 
+					state.m_on_complete(state.m_all_succeeded);
+				}
 #ifndef __EMSCRIPTEN__
-			pJob_pool->wait_for_all();
+			});
 #endif
-
-			status = all_succeeded;
 		}
-
-		debug_printf("uastc_rdo: Total modified: %3.2f%%, total skipped: %3.2f%%, total refined: %3.2f%%, total smooth: %3.2f%%\n", total_modified * 100.0f / num_blocks, total_skipped * 100.0f / num_blocks, total_refined * 100.0f / num_blocks, total_smooth * 100.0f / num_blocks);
-				
-		return status;
 	}
 } // namespace basisu
 
@@ -67,6 +67,16 @@ namespace basisu
 	// level: Controls compression speed vs. performance tradeoff.
 	void encode_uastc(const uint8_t* pRGBAPixels, basist::uastc_block& output_block, uint32_t flags = cPackUASTCLevelDefault);
 
+	// Number of blocks encode_uastc_blocks() classifies at once.
+	const uint32_t UASTC_ENCODE_BATCH_SIZE = 16;
+
+	// Encodes num_blocks 4x4 blocks, with the same results as calling encode_uastc() on each block. 
+	// pBlock_pixels: num_blocks * 16 RGBA pixels, each block's pixels are contiguous and in raster order.
+	// pOutput_blocks: num_blocks destination UASTC blocks.
+	// Blocks are processed in batches of UASTC_ENCODE_BATCH_SIZE: each batch is first classified in a structure of arrays layout 
+	// (solid/alpha/LA detection and color line fitting, vectorized across blocks), then every block's mode search uses that classification.
+	void encode_uastc_blocks(uint32_t num_blocks, const color_rgba* pBlock_pixels, basist::uastc_block* pOutput_blocks, uint32_t flags = cPackUASTCLevelDefault);
+
 	struct uastc_encode_results
 	{
 		uint32_t m_uastc_mode;
@@ -80,6 +90,9 @@ namespace basisu
 
 	const uint32_t UASCT_RDO_DEFAULT_LZ_DICT_SIZE = 4096;
 
+	// Multithreaded RDO never splits the blocks into ranges smaller than this.
+	const uint32_t UASTC_RDO_MIN_BLOCKS_PER_JOB = 64;
+
 	const float UASTC_RDO_DEFAULT_MAX_ALLOWED_RMS_INCREASE_RATIO = 10.0f;
 	const float UASTC_RDO_DEFAULT_SKIP_BLOCK_RMS_THRESH = 8.0f;
 	
@@ -106,6 +119,7 @@ namespace basisu
 			m_skip_block_rms_thresh = UASTC_RDO_DEFAULT_SKIP_BLOCK_RMS_THRESH;
 			m_endpoint_refinement = true;
 			m_lz_literal_cost = 100;
+			m_zstd_cost_model = false;
 						
 			m_max_smooth_block_std_dev = UASTC_RDO_DEFAULT_MAX_SMOOTH_BLOCK_STD_DEV;
 			m_smooth_block_max_error_scale = UASTC_RDO_DEFAULT_SMOOTH_BLOCK_MAX_ERROR_SCALE;
@@ -131,10 +145,22 @@ namespace basisu
 		float m_smooth_block_max_error_scale;
 		
 		uint32_t m_lz_literal_cost;
+
+		// m_zstd_cost_model: If true, match costs are estimated for Zstd instead of Deflate. Zstd codes matches at one of the 3 most recently used offsets
+		// very cheaply, so this favors reusing the selectors of blocks at the same distance as earlier matches (typically the block above, or to the left).
+		bool m_zstd_cost_model;
 	};
 
 	// num_blocks, pBlocks: Number of blocks and pointer to UASTC blocks to process.
 	// pBlock_pixels: Pointer to an array of 4x4 blocks containing the original texture pixels. This is NOT a raster image, but a pointer to individual 4x4 blocks.
 	// flags: Pass in the same flags used to encode the UASTC blocks. The flags are used to reencode the transcode hints in the same way.
+	// pJob_pool, total_jobs: Optionally split the blocks into up to total_jobs contiguous ranges processed in parallel. Each range's simulated LZ window is
+	// primed with the (pre-RDO) blocks preceding it, so the output is close to, but not identical to, the single threaded output.
 	bool uastc_rdo(uint32_t num_blocks, basist::uastc_block* pBlocks, const color_rgba* pBlock_pixels, const uastc_rdo_params &params, uint32_t flags = cPackUASTCLevelDefault, job_pool* pJob_pool = nullptr, uint32_t total_jobs = 0);
+
+	// Same as uastc_rdo(), except the RDO jobs are only queued on the job pool, so this may be called from inside a job and overlap other work.
+	// on_complete(status) is called from whichever job finishes last (or from the calling thread, if the blocks weren't split into multiple jobs).
+	// pBlocks and pBlock_pixels must remain valid until then.
+	void uastc_rdo_async(uint32_t num_blocks, basist::uastc_block* pBlocks, const color_rgba* pBlock_pixels, const uastc_rdo_params& params, uint32_t flags, job_pool& jpool, uint32_t total_jobs, 
+		const std::function<void(bool)>& on_complete);
 } // namespace basisu
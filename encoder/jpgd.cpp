@@ -40,6 +40,17 @@
 #include <algorithm>
 #include <assert.h>
 
+// SSE2 IDCT and color conversion. Both are bit exact with the scalar code.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define JPGD_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Blocks with fewer coefficients than this (in zigzag order) are faster with the scalar IDCT's fast paths.
+#ifndef JPGD_SSE2_IDCT_MIN_ZAG
+#define JPGD_SSE2_IDCT_MIN_ZAG 3
+#endif
+
 #ifdef _MSC_VER
 #pragma warning (disable : 4611) // warning C4611: interaction between '_setjmp' and C++ object destruction is non-portable
 #endif
@@ -270,6 +281,125 @@ namespace jpgd {
 		7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8 
 	};
 
+#if JPGD_USE_SSE2
+	// Packs two 16-bit multipliers for _mm_madd_epi16(): the result is x * a + y * b for each interleaved (x, y) pair.
+	static inline __m128i idct_mul_pair(int a, int b)
+	{
+		return _mm_set1_epi32((int)(((uint)(uint16)b << 16) | (uint16)a));
+	}
+
+	// The same 1D IDCT as Row<8>/Col<8>, on 8 rows or columns at once. pIn[k] holds input k of each of the 8 lanes.
+	// The odd part's multiplies are regrouped so each output is a sum of products of the original inputs, which lets _mm_madd_epi16() do
+	// them while staying bit exact with the 32-bit scalar math. Outputs aren't descaled: pOut_lo/pOut_hi get lanes 0-3 and 4-7 as 32-bit ints.
+	static inline void idct_1d_sse2(const __m128i* pIn, __m128i* pOut_lo, __m128i* pOut_hi)
+	{
+		const __m128i p04_lo = _mm_unpacklo_epi16(pIn[0], pIn[4]), p04_hi = _mm_unpackhi_epi16(pIn[0], pIn[4]);
+		const __m128i p26_lo = _mm_unpacklo_epi16(pIn[2], pIn[6]), p26_hi = _mm_unpackhi_epi16(pIn[2], pIn[6]);
+		const __m128i p75_lo = _mm_unpacklo_epi16(pIn[7], pIn[5]), p75_hi = _mm_unpackhi_epi16(pIn[7], pIn[5]);
+		const __m128i p31_lo = _mm_unpacklo_epi16(pIn[3], pIn[1]), p31_hi = _mm_unpackhi_epi16(pIn[3], pIn[1]);
+
+		const __m128i k_tmp0 = idct_mul_pair(1 << CONST_BITS, 1 << CONST_BITS);
+		const __m128i k_tmp1 = idct_mul_pair(1 << CONST_BITS, -(1 << CONST_BITS));
+		const __m128i k_tmp2 = idct_mul_pair(FIX_0_541196100, FIX_0_541196100 - FIX_1_847759065);
+		const __m128i k_tmp3 = idct_mul_pair(FIX_0_541196100 + FIX_0_765366865, FIX_0_541196100);
+
+		// Inputs (7,5) and (3,1), see btmp0-btmp3 in Row<>.
+		const __m128i k_b0_75 = idct_mul_pair(FIX_0_298631336 - FIX_0_899976223 - FIX_1_961570560 + FIX_1_175875602, FIX_1_175875602);
+		const __m128i k_b0_31 = idct_mul_pair(FIX_1_175875602 - FIX_1_961570560, FIX_1_175875602 - FIX_0_899976223);
+		const __m128i k_b1_75 = idct_mul_pair(FIX_1_175875602, FIX_2_053119869 - FIX_2_562915447 - FIX_0_390180644 + FIX_1_175875602);
+		const __m128i k_b1_31 = idct_mul_pair(FIX_1_175875602 - FIX_2_562915447, FIX_1_175875602 - FIX_0_390180644);
+		const __m128i k_b2_75 = idct_mul_pair(FIX_1_175875602 - FIX_1_961570560, FIX_1_175875602 - FIX_2_562915447);
+		const __m128i k_b2_31 = idct_mul_pair(FIX_3_072711026 - FIX_2_562915447 - FIX_1_961570560 + FIX_1_175875602, FIX_1_175875602);
+		const __m128i k_b3_75 = idct_mul_pair(FIX_1_175875602 - FIX_0_899976223, FIX_1_175875602 - FIX_0_390180644);
+		const __m128i k_b3_31 = idct_mul_pair(FIX_1_175875602, FIX_1_501321110 - FIX_0_899976223 - FIX_0_390180644 + FIX_1_175875602);
+
+		for (int h = 0; h < 2; h++)
+		{
+			const __m128i p04 = h ? p04_hi : p04_lo, p26 = h ? p26_hi : p26_lo, p75 = h ? p75_hi : p75_lo, p31 = h ? p31_hi : p31_lo;
+			__m128i* pOut = h ? pOut_hi : pOut_lo;
+
+			const __m128i tmp0 = _mm_madd_epi16(p04, k_tmp0), tmp1 = _mm_madd_epi16(p04, k_tmp1);
+			const __m128i tmp2 = _mm_madd_epi16(p26, k_tmp2), tmp3 = _mm_madd_epi16(p26, k_tmp3);
+
+			const __m128i tmp10 = _mm_add_epi32(tmp0, tmp3), tmp13 = _mm_sub_epi32(tmp0, tmp3), tmp11 = _mm_add_epi32(tmp1, tmp2), tmp12 = _mm_sub_epi32(tmp1, tmp2);
+
+			const __m128i btmp0 = _mm_add_epi32(_mm_madd_epi16(p75, k_b0_75), _mm_madd_epi16(p31, k_b0_31));
+			const __m128i btmp1 = _mm_add_epi32(_mm_madd_epi16(p75, k_b1_75), _mm_madd_epi16(p31, k_b1_31));
+			const __m128i btmp2 = _mm_add_epi32(_mm_madd_epi16(p75, k_b2_75), _mm_madd_epi16(p31, k_b2_31));
+			const __m128i btmp3 = _mm_add_epi32(_mm_madd_epi16(p75, k_b3_75), _mm_madd_epi16(p31, k_b3_31));
+
+			pOut[0] = _mm_add_epi32(tmp10, btmp3);
+			pOut[7] = _mm_sub_epi32(tmp10, btmp3);
+			pOut[1] = _mm_add_epi32(tmp11, btmp2);
+			pOut[6] = _mm_sub_epi32(tmp11, btmp2);
+			pOut[2] = _mm_add_epi32(tmp12, btmp1);
+			pOut[5] = _mm_sub_epi32(tmp12, btmp1);
+			pOut[3] = _mm_add_epi32(tmp13, btmp0);
+			pOut[4] = _mm_sub_epi32(tmp13, btmp0);
+		}
+	}
+
+	static inline void transpose_8x8_sse2(__m128i* v)
+	{
+		const __m128i a0 = _mm_unpacklo_epi16(v[0], v[1]), a1 = _mm_unpackhi_epi16(v[0], v[1]);
+		const __m128i a2 = _mm_unpacklo_epi16(v[2], v[3]), a3 = _mm_unpackhi_epi16(v[2], v[3]);
+		const __m128i a4 = _mm_unpacklo_epi16(v[4], v[5]), a5 = _mm_unpackhi_epi16(v[4], v[5]);
+		const __m128i a6 = _mm_unpacklo_epi16(v[6], v[7]), a7 = _mm_unpackhi_epi16(v[6], v[7]);
+
+		const __m128i b0 = _mm_unpacklo_epi32(a0, a2), b1 = _mm_unpackhi_epi32(a0, a2);
+		const __m128i b2 = _mm_unpacklo_epi32(a1, a3), b3 = _mm_unpackhi_epi32(a1, a3);
+		const __m128i b4 = _mm_unpacklo_epi32(a4, a6), b5 = _mm_unpackhi_epi32(a4, a6);
+		const __m128i b6 = _mm_unpacklo_epi32(a5, a7), b7 = _mm_unpackhi_epi32(a5, a7);
+
+		v[0] = _mm_unpacklo_epi64(b0, b4); v[1] = _mm_unpackhi_epi64(b0, b4);
+		v[2] = _mm_unpacklo_epi64(b1, b5); v[3] = _mm_unpackhi_epi64(b1, b5);
+		v[4] = _mm_unpacklo_epi64(b2, b6); v[5] = _mm_unpackhi_epi64(b2, b6);
+		v[6] = _mm_unpacklo_epi64(b3, b7); v[7] = _mm_unpackhi_epi64(b3, b7);
+	}
+
+	// Full 8x8 IDCT. The column pass needs the row pass's results in 16 bits, which always holds for sane coefficients. If it doesn't, returns
+	// false without writing anything so the caller can fall back to the scalar IDCT.
+	static bool idct_sse2(const jpgd_block_t* pSrc_ptr, uint8* pDst_ptr)
+	{
+		__m128i v[8], lo[8], hi[8];
+		for (int r = 0; r < 8; r++)
+			v[r] = _mm_loadu_si128((const __m128i*)(pSrc_ptr + r * 8));
+
+		// Rows pass, each lane is a different row.
+		transpose_8x8_sse2(v);
+		idct_1d_sse2(v, lo, hi);
+
+		const __m128i round1 = _mm_set1_epi32(SCALEDONE << (CONST_BITS - PASS1_BITS - 1));
+		const __m128i bias16 = _mm_set1_epi32(32768);
+		__m128i range = _mm_setzero_si128();
+		for (int k = 0; k < 8; k++)
+		{
+			lo[k] = _mm_srai_epi32(_mm_add_epi32(lo[k], round1), CONST_BITS - PASS1_BITS);
+			hi[k] = _mm_srai_epi32(_mm_add_epi32(hi[k], round1), CONST_BITS - PASS1_BITS);
+			range = _mm_or_si128(range, _mm_or_si128(_mm_add_epi32(lo[k], bias16), _mm_add_epi32(hi[k], bias16)));
+			v[k] = _mm_packs_epi32(lo[k], hi[k]);
+		}
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(range, 16), _mm_setzero_si128())) != 0xFFFF)
+			return false;
+
+		// Columns pass, each lane is a different column.
+		transpose_8x8_sse2(v);
+		idct_1d_sse2(v, lo, hi);
+
+		// The saturating packs clamp to [0,255] like CLAMP() does.
+		const __m128i round2 = _mm_set1_epi32((128 << (CONST_BITS + PASS1_BITS + 3)) + (SCALEDONE << (CONST_BITS + PASS1_BITS + 3 - 1)));
+		for (int r = 0; r < 8; r += 2)
+		{
+			const __m128i r0 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(lo[r], round2), CONST_BITS + PASS1_BITS + 3), _mm_srai_epi32(_mm_add_epi32(hi[r], round2), CONST_BITS + PASS1_BITS + 3));
+			const __m128i r1 = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(lo[r + 1], round2), CONST_BITS + PASS1_BITS + 3), _mm_srai_epi32(_mm_add_epi32(hi[r + 1], round2), CONST_BITS + PASS1_BITS + 3));
+			_mm_storeu_si128((__m128i*)(pDst_ptr + r * 8), _mm_packus_epi16(r0, r1));
+		}
+
+		return true;
+	}
+#endif
+
 	// Scalar "fast pathing" IDCT.
 	static void idct(const jpgd_block_t* pSrc_ptr, uint8* pDst_ptr, int block_max_zag)
 	{
@@ -292,6 +422,11 @@ namespace jpgd {
 			return;
 		}
 
+#if JPGD_USE_SSE2
+		if ((block_max_zag >= JPGD_SSE2_IDCT_MIN_ZAG) && (idct_sse2(pSrc_ptr, pDst_ptr)))
+			return;
+#endif
+
 		int temp[64];
 
 		const jpgd_block_t* pSrc = pSrc_ptr;
@@ -1239,6 +1374,11 @@ namespace jpgd {
 		m_pScan_line_0 = nullptr;
 		m_pScan_line_1 = nullptr;
 
+		m_pY_row = nullptr;
+		m_pCb_row = nullptr;
+		m_pCr_row = nullptr;
+		m_pChroma_row_work = nullptr;
+
 		// Ready the input buffer.
 		prep_in_buffer();
 
@@ -1549,6 +1689,142 @@ namespace jpgd {
 	}
 
 	// YCbCr H1V1 (1x1:1:1, 3 m_blocks per MCU) to RGB
+#if JPGD_USE_SSE2
+	// Converts 8 YCbCr pixels to RGBA, bit exact with the m_crr/m_cbb/m_crg/m_cbg tables. The 16.16 fixed point multipliers are split so they
+	// fit _mm_madd_epi16(): Cr->R is 65536 + 26345, Cb->B is 131072 - 14942, and the two G multipliers are even so G is computed at 15 bits.
+	static inline void ycc_to_rgba_8_sse2(const uint8* pY, const uint8* pCb, const uint8* pCr, uint8* pDst)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bias = _mm_set1_epi16(128);
+		const __m128i two = _mm_set1_epi16(2);
+
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)pY), zero);
+		const __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)pCb), zero), bias);
+		const __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)pCr), zero), bias);
+
+		// (k, 2) pairs, so the madd adds the 32768 rounding bias.
+		const __m128i k_r = _mm_set1_epi32((16384 << 16) | 26345);
+		const __m128i k_b = _mm_set1_epi32((16384 << 16) | (65536 - 14942));
+		const __m128i k_g = _mm_set1_epi32((int)((uint)(65536 - 11277) << 16) | (65536 - 23401));
+		const __m128i g_round = _mm_set1_epi32(16384);
+
+		const __m128i rc = _mm_add_epi16(cr, _mm_packs_epi32(
+			_mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(cr, two), k_r), 16),
+			_mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(cr, two), k_r), 16)));
+
+		const __m128i bc = _mm_add_epi16(_mm_add_epi16(cb, cb), _mm_packs_epi32(
+			_mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(cb, two), k_b), 16),
+			_mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(cb, two), k_b), 16)));
+
+		const __m128i gc = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(cr, cb), k_g), g_round), 15),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(cr, cb), k_g), g_round), 15));
+
+		// The saturating packs clamp like clamp() does.
+		const __m128i rb = _mm_packus_epi16(_mm_add_epi16(y, rc), _mm_add_epi16(y, bc));
+		const __m128i ga = _mm_packus_epi16(_mm_add_epi16(y, gc), _mm_set1_epi16(255));
+
+		const __m128i rg = _mm_unpacklo_epi8(rb, ga), ba = _mm_unpackhi_epi8(rb, ga);
+		_mm_storeu_si128((__m128i*)pDst, _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128((__m128i*)(pDst + 16), _mm_unpackhi_epi16(rg, ba));
+	}
+#endif
+
+	// Converts n (a multiple of 8) YCbCr pixels to RGBA.
+	void jpeg_decoder::convert_ycc_row(const uint8* pY, const uint8* pCb, const uint8* pCr, uint8* pDst, int n)
+	{
+		assert((n & 7) == 0);
+
+#if JPGD_USE_SSE2
+		for (int x = 0; x < n; x += 8)
+			ycc_to_rgba_8_sse2(pY + x, pCb + x, pCr + x, pDst + x * 4);
+#else
+		for (int x = 0; x < n; x++)
+		{
+			int y = pY[x];
+			int cb = pCb[x];
+			int cr = pCr[x];
+
+			pDst[0] = clamp(y + m_crr[cr]);
+			pDst[1] = clamp(y + ((m_crg[cr] + m_cbg[cb]) >> 16));
+			pDst[2] = clamp(y + m_cbb[cb]);
+			pDst[3] = 255;
+
+			pDst += 4;
+		}
+#endif
+	}
+
+	// Copies one row of luma samples from an MCU row with 2 horizontal luma blocks per MCU (H2V1 and H2V2) into a linear row.
+	void jpeg_decoder::gather_h2_luma_row(const uint8* pSrc, uint8* pDst)
+	{
+		const int mcu_stride = m_max_blocks_per_mcu * 64;
+		for (int i = m_max_mcus_per_row; i > 0; i--)
+		{
+			memcpy(pDst, pSrc, 8);
+			memcpy(pDst + 8, pSrc + 64, 8);
+			pSrc += mcu_stride;
+			pDst += 16;
+		}
+	}
+
+	// Linear chroma upsampling for H2V1 and H2V2. Blends two rows of chroma samples vertically (w0 + w1 must be 4), then upsamples 2x
+	// horizontally with 3:1 weights. pC0/pC1 point at the sample rows in the first MCU. The math and edge clamping are the same as the
+	// per-pixel filtered conversions used, just done a row at a time.
+	void jpeg_decoder::upsample_h2_chroma_row(const uint8* pC0, const uint8* pC1, int w0, int w1, uint8* pDst)
+	{
+		const int mcu_stride = m_max_blocks_per_mcu * 64;
+		const int total_samples = m_max_mcus_per_row * 8;
+		const int last_sample = (m_image_x_size >> 1) - 1;
+		assert((w0 + w1) == 4);
+		assert((last_sample >= 0) && (last_sample < total_samples));
+
+		// pV[i + 1] is vertically blended sample i, with the row's edge samples repeated on either side.
+		int16* pV = m_pChroma_row_work;
+
+		for (int i = 0; i < m_max_mcus_per_row; i++)
+		{
+			const uint8* p0 = pC0 + i * mcu_stride;
+			const uint8* p1 = pC1 + i * mcu_stride;
+			int16* pD = pV + 1 + i * 8;
+#if JPGD_USE_SSE2
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i c0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p0), zero);
+			const __m128i c1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p1), zero);
+			_mm_storeu_si128((__m128i*)pD, _mm_add_epi16(_mm_mullo_epi16(c0, _mm_set1_epi16((int16)w0)), _mm_mullo_epi16(c1, _mm_set1_epi16((int16)w1))));
+#else
+			for (int j = 0; j < 8; j++)
+				pD[j] = (int16)(p0[j] * w0 + p1[j] * w1);
+#endif
+		}
+
+		pV[0] = pV[1];
+		for (int i = last_sample + 1; i <= total_samples; i++)
+			pV[i + 1] = pV[last_sample + 1];
+
+#if JPGD_USE_SSE2
+		const __m128i round = _mm_set1_epi16(8);
+		for (int k = 0; k < total_samples; k += 8)
+		{
+			const __m128i a = _mm_loadu_si128((const __m128i*)(pV + k));
+			const __m128i b = _mm_loadu_si128((const __m128i*)(pV + k + 1));
+			const __m128i c = _mm_loadu_si128((const __m128i*)(pV + k + 2));
+			const __m128i b3 = _mm_add_epi16(_mm_add_epi16(b, b), _mm_add_epi16(b, round));
+
+			const __m128i even = _mm_srli_epi16(_mm_add_epi16(a, b3), 4);
+			const __m128i odd = _mm_srli_epi16(_mm_add_epi16(b3, c), 4);
+
+			_mm_storeu_si128((__m128i*)(pDst + k * 2), _mm_packus_epi16(_mm_unpacklo_epi16(even, odd), _mm_unpackhi_epi16(even, odd)));
+		}
+#else
+		for (int k = 0; k < total_samples; k++)
+		{
+			pDst[k * 2 + 0] = (uint8)((pV[k] + pV[k + 1] * 3 + 8) >> 4);
+			pDst[k * 2 + 1] = (uint8)((pV[k + 1] * 3 + pV[k + 2] + 8) >> 4);
+		}
+#endif
+	}
+
 	void jpeg_decoder::H1V1Convert()
 	{
 		int row = m_max_mcu_y_size - m_mcu_lines_left;
@@ -1557,20 +1833,9 @@ namespace jpgd {
 
 		for (int i = m_max_mcus_per_row; i > 0; i--)
 		{
-			for (int j = 0; j < 8; j++)
-			{
-				int y = s[j];
-				int cb = s[64 + j];
-				int cr = s[128 + j];
-
-				d[0] = clamp(y + m_crr[cr]);
-				d[1] = clamp(y + ((m_crg[cr] + m_cbg[cb]) >> 16));
-				d[2] = clamp(y + m_cbb[cb]);
-				d[3] = 255;
-
-				d += 4;
-			}
+			convert_ycc_row(s, s + 64, s + 128, d, 8);
 
+			d += 8 * 4;
 			s += 64 * 3;
 		}
 	}
@@ -1623,46 +1888,17 @@ namespace jpgd {
 	// YCbCr H2V1 (2x1:1:1, 4 m_blocks per MCU) to RGB
 	void jpeg_decoder::H2V1ConvertFiltered()
 	{
-		const uint BLOCKS_PER_MCU = 4;
 		int row = m_max_mcu_y_size - m_mcu_lines_left;
-		uint8* d0 = m_pScan_line_0;
-
-		const int half_image_x_size = (m_image_x_size >> 1) - 1;
 		const int row_x8 = row * 8;
 
-		for (int x = 0; x < m_image_x_size; x++)
-		{
-			int y = m_pSample_buf[check_sample_buf_ofs((x >> 4) * BLOCKS_PER_MCU * 64 + ((x & 8) ? 64 : 0) + (x & 7) + row_x8)];
-
-			int c_x0 = (x - 1) >> 1;
-			int c_x1 = JPGD_MIN(c_x0 + 1, half_image_x_size);
-			c_x0 = JPGD_MAX(c_x0, 0);
-
-			int a = (c_x0 >> 3) * BLOCKS_PER_MCU * 64 + (c_x0 & 7) + row_x8 + 128;
-			int cb0 = m_pSample_buf[check_sample_buf_ofs(a)];
-			int cr0 = m_pSample_buf[check_sample_buf_ofs(a + 64)];
-
-			int b = (c_x1 >> 3) * BLOCKS_PER_MCU * 64 + (c_x1 & 7) + row_x8 + 128;
-			int cb1 = m_pSample_buf[check_sample_buf_ofs(b)];
-			int cr1 = m_pSample_buf[check_sample_buf_ofs(b + 64)];
+		gather_h2_luma_row(m_pSample_buf + row_x8, m_pY_row);
 
-			int w0 = (x & 1) ? 3 : 1;
-			int w1 = (x & 1) ? 1 : 3;
+		// No vertical filtering, so both chroma rows are the same row.
+		const uint8* pC = m_pSample_buf + 128 + row_x8;
+		upsample_h2_chroma_row(pC, pC, 2, 2, m_pCb_row);
+		upsample_h2_chroma_row(pC + 64, pC + 64, 2, 2, m_pCr_row);
 
-			int cb = (cb0 * w0 + cb1 * w1 + 2) >> 2;
-			int cr = (cr0 * w0 + cr1 * w1 + 2) >> 2;
-
-			int rc = m_crr[cr];
-			int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-			int bc = m_cbb[cb];
-
-			d0[0] = clamp(y + rc);
-			d0[1] = clamp(y + gc);
-			d0[2] = clamp(y + bc);
-			d0[3] = 255;
-
-			d0 += 4;
-		}
+		convert_ycc_row(m_pY_row, m_pCb_row, m_pCr_row, m_pScan_line_0, m_max_mcus_per_row * 16);
 	}
 
 	// YCbCr H2V1 (1x2:1:1, 4 m_blocks per MCU) to RGB
@@ -1845,14 +2081,11 @@ namespace jpgd {
 
 	uint32_t jpeg_decoder::H2V2ConvertFiltered()
 	{
-		const uint BLOCKS_PER_MCU = 6;
 		int y = m_image_y_size - m_total_lines_left;
 		int row = y & 15;
 
 		const int half_image_y_size = (m_image_y_size >> 1) - 1;
 
-		uint8* d0 = m_pScan_line_0;
-
 		int c_y0 = (y - 1) >> 1;
 		int c_y1 = JPGD_MIN(c_y0 + 1, half_image_y_size);
 
@@ -1873,174 +2106,36 @@ namespace jpgd {
 		const int y0_base = (c_y0 & 7) * 8 + 256;
 		const int y1_base = (c_y1 & 7) * 8 + 256;
 
-		const int half_image_x_size = (m_image_x_size >> 1) - 1;
+		const int total_pixels = m_max_mcus_per_row * 16;
 
-		static const uint8_t s_muls[2][2][4] =
-		{
-			{ { 1, 3, 3, 9 }, { 3, 9, 1, 3 }, },
-			{ { 3, 1, 9, 3 }, { 9, 3, 3, 1 } }
-		};
+		// Vertical chroma weights: 1:3 on even rows, 3:1 on odd rows.
+		const int w0 = (row & 1) ? 3 : 1;
+
+		gather_h2_luma_row(p_YSamples + y_sample_base_ofs, m_pY_row);
+		upsample_h2_chroma_row(p_C0Samples + y0_base, m_pSample_buf + y1_base, w0, 4 - w0, m_pCb_row);
+		upsample_h2_chroma_row(p_C0Samples + y0_base + 64, m_pSample_buf + y1_base + 64, w0, 4 - w0, m_pCr_row);
+		convert_ycc_row(m_pY_row, m_pCb_row, m_pCr_row, m_pScan_line_0, total_pixels);
 
 		if (((row & 15) >= 1) && ((row & 15) <= 14))
 		{
+			// The next row uses the same two chroma rows, so output it now too.
 			assert((row & 1) == 1);
 			assert(((y + 1 - 1) >> 1) == c_y0);
 
 			assert(p_YSamples == m_pSample_buf);
 			assert(p_C0Samples == m_pSample_buf);
 
-			uint8* d1 = m_pScan_line_1;
 			const int y_sample_base_ofs1 = (((row + 1) & 8) ? 128 : 0) + ((row + 1) & 7) * 8;
 
-			for (int x = 0; x < m_image_x_size; x++)
-			{
-				int k = (x >> 4) * BLOCKS_PER_MCU * 64 + ((x & 8) ? 64 : 0) + (x & 7);
-				int y_sample0 = p_YSamples[check_sample_buf_ofs(k + y_sample_base_ofs)];
-				int y_sample1 = p_YSamples[check_sample_buf_ofs(k + y_sample_base_ofs1)];
-
-				int c_x0 = (x - 1) >> 1;
-				int c_x1 = JPGD_MIN(c_x0 + 1, half_image_x_size);
-				c_x0 = JPGD_MAX(c_x0, 0);
-
-				int a = (c_x0 >> 3) * BLOCKS_PER_MCU * 64 + (c_x0 & 7);
-				int cb00_sample = p_C0Samples[check_sample_buf_ofs(a + y0_base)];
-				int cr00_sample = p_C0Samples[check_sample_buf_ofs(a + y0_base + 64)];
-
-				int cb01_sample = m_pSample_buf[check_sample_buf_ofs(a + y1_base)];
-				int cr01_sample = m_pSample_buf[check_sample_buf_ofs(a + y1_base + 64)];
-
-				int b = (c_x1 >> 3) * BLOCKS_PER_MCU * 64 + (c_x1 & 7);
-				int cb10_sample = p_C0Samples[check_sample_buf_ofs(b + y0_base)];
-				int cr10_sample = p_C0Samples[check_sample_buf_ofs(b + y0_base + 64)];
-
-				int cb11_sample = m_pSample_buf[check_sample_buf_ofs(b + y1_base)];
-				int cr11_sample = m_pSample_buf[check_sample_buf_ofs(b + y1_base + 64)];
-
-				{
-					const uint8_t* pMuls = &s_muls[row & 1][x & 1][0];
-					int cb = (cb00_sample * pMuls[0] + cb01_sample * pMuls[1] + cb10_sample * pMuls[2] + cb11_sample * pMuls[3] + 8) >> 4;
-					int cr = (cr00_sample * pMuls[0] + cr01_sample * pMuls[1] + cr10_sample * pMuls[2] + cr11_sample * pMuls[3] + 8) >> 4;
-
-					int rc = m_crr[cr];
-					int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-					int bc = m_cbb[cb];
-
-					d0[0] = clamp(y_sample0 + rc);
-					d0[1] = clamp(y_sample0 + gc);
-					d0[2] = clamp(y_sample0 + bc);
-					d0[3] = 255;
-
-					d0 += 4;
-				}
-
-				{
-					const uint8_t* pMuls = &s_muls[(row + 1) & 1][x & 1][0];
-					int cb = (cb00_sample * pMuls[0] + cb01_sample * pMuls[1] + cb10_sample * pMuls[2] + cb11_sample * pMuls[3] + 8) >> 4;
-					int cr = (cr00_sample * pMuls[0] + cr01_sample * pMuls[1] + cr10_sample * pMuls[2] + cr11_sample * pMuls[3] + 8) >> 4;
-
-					int rc = m_crr[cr];
-					int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-					int bc = m_cbb[cb];
-
-					d1[0] = clamp(y_sample1 + rc);
-					d1[1] = clamp(y_sample1 + gc);
-					d1[2] = clamp(y_sample1 + bc);
-					d1[3] = 255;
-
-					d1 += 4;
-				}
-
-				if (((x & 1) == 1) && (x < m_image_x_size - 1))
-				{
-					const int nx = x + 1;
-					assert(c_x0 == (nx - 1) >> 1);
-
-					k = (nx >> 4) * BLOCKS_PER_MCU * 64 + ((nx & 8) ? 64 : 0) + (nx & 7);
-					y_sample0 = p_YSamples[check_sample_buf_ofs(k + y_sample_base_ofs)];
-					y_sample1 = p_YSamples[check_sample_buf_ofs(k + y_sample_base_ofs1)];
-
-					{
-						const uint8_t* pMuls = &s_muls[row & 1][nx & 1][0];
-						int cb = (cb00_sample * pMuls[0] + cb01_sample * pMuls[1] + cb10_sample * pMuls[2] + cb11_sample * pMuls[3] + 8) >> 4;
-						int cr = (cr00_sample * pMuls[0] + cr01_sample * pMuls[1] + cr10_sample * pMuls[2] + cr11_sample * pMuls[3] + 8) >> 4;
-
-						int rc = m_crr[cr];
-						int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-						int bc = m_cbb[cb];
-
-						d0[0] = clamp(y_sample0 + rc);
-						d0[1] = clamp(y_sample0 + gc);
-						d0[2] = clamp(y_sample0 + bc);
-						d0[3] = 255;
-
-						d0 += 4;
-					}
-
-					{
-						const uint8_t* pMuls = &s_muls[(row + 1) & 1][nx & 1][0];
-						int cb = (cb00_sample * pMuls[0] + cb01_sample * pMuls[1] + cb10_sample * pMuls[2] + cb11_sample * pMuls[3] + 8) >> 4;
-						int cr = (cr00_sample * pMuls[0] + cr01_sample * pMuls[1] + cr10_sample * pMuls[2] + cr11_sample * pMuls[3] + 8) >> 4;
-
-						int rc = m_crr[cr];
-						int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-						int bc = m_cbb[cb];
-
-						d1[0] = clamp(y_sample1 + rc);
-						d1[1] = clamp(y_sample1 + gc);
-						d1[2] = clamp(y_sample1 + bc);
-						d1[3] = 255;
-
-						d1 += 4;
-					}
-
-					++x;
-				}
-			}
+			gather_h2_luma_row(p_YSamples + y_sample_base_ofs1, m_pY_row);
+			upsample_h2_chroma_row(p_C0Samples + y0_base, m_pSample_buf + y1_base, 4 - w0, w0, m_pCb_row);
+			upsample_h2_chroma_row(p_C0Samples + y0_base + 64, m_pSample_buf + y1_base + 64, 4 - w0, w0, m_pCr_row);
+			convert_ycc_row(m_pY_row, m_pCb_row, m_pCr_row, m_pScan_line_1, total_pixels);
 
 			return 2;
 		}
-		else
-		{
-			for (int x = 0; x < m_image_x_size; x++)
-			{
-				int y_sample = p_YSamples[check_sample_buf_ofs((x >> 4) * BLOCKS_PER_MCU * 64 + ((x & 8) ? 64 : 0) + (x & 7) + y_sample_base_ofs)];
-
-				int c_x0 = (x - 1) >> 1;
-				int c_x1 = JPGD_MIN(c_x0 + 1, half_image_x_size);
-				c_x0 = JPGD_MAX(c_x0, 0);
-
-				int a = (c_x0 >> 3) * BLOCKS_PER_MCU * 64 + (c_x0 & 7);
-				int cb00_sample = p_C0Samples[check_sample_buf_ofs(a + y0_base)];
-				int cr00_sample = p_C0Samples[check_sample_buf_ofs(a + y0_base + 64)];
 
-				int cb01_sample = m_pSample_buf[check_sample_buf_ofs(a + y1_base)];
-				int cr01_sample = m_pSample_buf[check_sample_buf_ofs(a + y1_base + 64)];
-
-				int b = (c_x1 >> 3) * BLOCKS_PER_MCU * 64 + (c_x1 & 7);
-				int cb10_sample = p_C0Samples[check_sample_buf_ofs(b + y0_base)];
-				int cr10_sample = p_C0Samples[check_sample_buf_ofs(b + y0_base + 64)];
-
-				int cb11_sample = m_pSample_buf[check_sample_buf_ofs(b + y1_base)];
-				int cr11_sample = m_pSample_buf[check_sample_buf_ofs(b + y1_base + 64)];
-
-				const uint8_t* pMuls = &s_muls[row & 1][x & 1][0];
-				int cb = (cb00_sample * pMuls[0] + cb01_sample * pMuls[1] + cb10_sample * pMuls[2] + cb11_sample * pMuls[3] + 8) >> 4;
-				int cr = (cr00_sample * pMuls[0] + cr01_sample * pMuls[1] + cr10_sample * pMuls[2] + cr11_sample * pMuls[3] + 8) >> 4;
-
-				int rc = m_crr[cr];
-				int gc = ((m_crg[cr] + m_cbg[cb]) >> 16);
-				int bc = m_cbb[cb];
-
-				d0[0] = clamp(y_sample + rc);
-				d0[1] = clamp(y_sample + gc);
-				d0[2] = clamp(y_sample + bc);
-				d0[3] = 255;
-
-				d0 += 4;
-			}
-
-			return 1;
-		}
+		return 1;
 	}
 
 	// Y (1 block per MCU) to 8-bit grayscale
@@ -2592,6 +2687,16 @@ namespace jpgd {
 		if ((m_scan_type == JPGD_YH1V2) || (m_scan_type == JPGD_YH2V2))
 			m_pScan_line_1 = (uint8*)alloc(m_dest_bytes_per_scan_line, true);
 
+		// Row buffers for the filtered H2V1/H2V2 conversions.
+		if ((m_scan_type == JPGD_YH2V1) || (m_scan_type == JPGD_YH2V2))
+		{
+			const int row_pixels = m_max_mcus_per_row * 16;
+			m_pY_row = (uint8*)alloc(row_pixels * 3);
+			m_pCb_row = m_pY_row + row_pixels;
+			m_pCr_row = m_pCb_row + row_pixels;
+			m_pChroma_row_work = (int16*)alloc((m_max_mcus_per_row * 8 + 2) * sizeof(int16));
+		}
+
 		m_max_blocks_per_row = m_max_mcus_per_row * m_max_blocks_per_mcu;
 
 		// Should never happen
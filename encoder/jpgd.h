@@ -265,6 +265,10 @@ namespace jpgd
 		int m_cbg[256];
 		uint8* m_pScan_line_0;
 		uint8* m_pScan_line_1;
+		uint8* m_pY_row;
+		uint8* m_pCb_row;
+		uint8* m_pCr_row;
+		int16* m_pChroma_row_work;
 		jpgd_status m_error_code;
 		int m_total_bytes_read;
 
@@ -309,6 +313,9 @@ namespace jpgd
 		void init_sequential();
 		void decode_start();
 		void decode_init(jpeg_decoder_stream* pStream, uint32_t flags);
+		void convert_ycc_row(const uint8* pY, const uint8* pCb, const uint8* pCr, uint8* pDst, int n);
+		void gather_h2_luma_row(const uint8* pSrc, uint8* pDst);
+		void upsample_h2_chroma_row(const uint8* pC0, const uint8* pC1, int w0, int w1, uint8* pDst);
 		void H2V2Convert();
 		uint32_t H2V2ConvertFiltered();
 		void H2V1Convert();
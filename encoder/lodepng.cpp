@@ -3705,6 +3705,89 @@ unsigned lodepng_inspect(unsigned* w, unsigned* h, LodePNGState* state,
   return state->error;
 }
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LODEPNG_SSE2_UNFILTER 1
+#include <emmintrin.h>
+#include <string.h>
+
+/*
+SSE2 versions of the Sub, Average and Paeth unfilters for 3 and 4 byte pixels (8-bit RGB and RGBA), the most common
+case. These filters depend on the pixel to the left, so pixels are still reconstructed one at a time, but all bytes of
+a pixel are processed at once. Rows aren't aligned, and 3 byte pixels mustn't touch the byte after the pixel (recon and
+scanline may be the same memory), so pixels are loaded and stored through 32-bit integers.
+*/
+static __m128i lodepng_sse2_load(const unsigned char* p, size_t bytewidth) {
+  int v;
+  /*3 byte pixels are assembled in a register, copying them into a partially initialized int causes store forwarding stalls*/
+  if(bytewidth == 4) memcpy(&v, p, 4);
+  else v = p[0] | (p[1] << 8) | (p[2] << 16);
+  return _mm_cvtsi32_si128(v);
+}
+
+static void lodepng_sse2_store(unsigned char* p, __m128i v, size_t bytewidth) {
+  int t = _mm_cvtsi128_si32(v);
+  if(bytewidth == 4) memcpy(p, &t, 4);
+  else {
+    p[0] = (unsigned char)t;
+    p[1] = (unsigned char)(t >> 8);
+    p[2] = (unsigned char)(t >> 16);
+  }
+}
+
+static void unfilterSubSSE2(unsigned char* recon, const unsigned char* scanline, size_t bytewidth, size_t length) {
+  size_t i;
+  __m128i a = _mm_setzero_si128();
+  for(i = 0; i + bytewidth <= length; i += bytewidth) {
+    a = _mm_add_epi8(lodepng_sse2_load(&scanline[i], bytewidth), a);
+    lodepng_sse2_store(&recon[i], a, bytewidth);
+  }
+}
+
+static void unfilterAverageSSE2(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon,
+                                size_t bytewidth, size_t length) {
+  size_t i;
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i a = _mm_setzero_si128();
+  for(i = 0; i + bytewidth <= length; i += bytewidth) {
+    __m128i b = lodepng_sse2_load(&precon[i], bytewidth);
+    /*_mm_avg_epu8 rounds up, the filter rounds down*/
+    __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+    a = _mm_add_epi8(lodepng_sse2_load(&scanline[i], bytewidth), avg);
+    lodepng_sse2_store(&recon[i], a, bytewidth);
+  }
+}
+
+static __m128i lodepng_sse2_abs16(__m128i x) {
+  return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+static __m128i lodepng_sse2_select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void unfilterPaethSSE2(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon,
+                              size_t bytewidth, size_t length) {
+  size_t i;
+  const __m128i zero = _mm_setzero_si128();
+  /*a: left, b: up, c: up-left, all as 16-bit lanes*/
+  __m128i a = zero, c = zero;
+  for(i = 0; i + bytewidth <= length; i += bytewidth) {
+    __m128i b = _mm_unpacklo_epi8(lodepng_sse2_load(&precon[i], bytewidth), zero);
+    __m128i pa = lodepng_sse2_abs16(_mm_sub_epi16(b, c));
+    __m128i pb = lodepng_sse2_abs16(_mm_sub_epi16(a, c));
+    __m128i pc = lodepng_sse2_abs16(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c)));
+    __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+    /*same tie breaking as paethPredictor: a, then b, then c*/
+    __m128i pred = lodepng_sse2_select(_mm_cmpeq_epi16(smallest, pa), a,
+                                       lodepng_sse2_select(_mm_cmpeq_epi16(smallest, pb), b, c));
+    __m128i x = _mm_add_epi8(lodepng_sse2_load(&scanline[i], bytewidth), _mm_packus_epi16(pred, pred));
+    lodepng_sse2_store(&recon[i], x, bytewidth);
+    a = _mm_unpacklo_epi8(x, zero);
+    c = b;
+  }
+}
+#endif /*SSE2*/
+
 static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon,
                                  size_t bytewidth, unsigned char filterType, size_t length) {
   /*
@@ -3717,6 +3800,16 @@ static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scan
   */
 
   size_t i;
+#ifdef LODEPNG_SSE2_UNFILTER
+  if(bytewidth == 3 || bytewidth == 4) {
+    switch(filterType) {
+      case 1: unfilterSubSSE2(recon, scanline, bytewidth, length); return 0;
+      case 3: if(precon) { unfilterAverageSSE2(recon, scanline, precon, bytewidth, length); return 0; } break;
+      case 4: if(precon) { unfilterPaethSSE2(recon, scanline, precon, bytewidth, length); return 0; } break;
+      default: break;
+    }
+  }
+#endif /*LODEPNG_SSE2_UNFILTER*/
   switch(filterType) {
     case 0:
       for(i = 0; i != length; ++i) recon[i] = scanline[i];
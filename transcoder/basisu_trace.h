@@ -0,0 +1,233 @@
+// basisu_trace.h
+// Copyright (C) 2019-2021 Binomial LLC. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Optional scoped trace events, written out in the Chrome trace event JSON format (viewable in chrome://tracing or Perfetto).
+// Compiled out unless BASISU_ENABLE_TRACING is 1. Even when compiled in, nothing is recorded until trace_recorder::get().set_enabled(true) is called.
+// Each thread appends to its own event buffer, so recording only takes a lock the first time a thread records an event.
+#pragma once
+
+#ifndef BASISU_ENABLE_TRACING
+#define BASISU_ENABLE_TRACING 0
+#endif
+
+#if BASISU_ENABLE_TRACING
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace basisu
+{
+	class trace_recorder
+	{
+		trace_recorder(const trace_recorder&) = delete;
+		trace_recorder& operator= (const trace_recorder&) = delete;
+
+	public:
+		// Name and category must be string literals (only the pointers are stored).
+		struct event
+		{
+			const char* m_pName;
+			const char* m_pCategory;
+			uint64_t m_start_us;
+			uint64_t m_duration_us;
+			int64_t m_arg;
+			bool m_has_arg;
+		};
+
+		static trace_recorder& get()
+		{
+			static trace_recorder s_recorder;
+			return s_recorder;
+		}
+
+		void set_enabled(bool enabled) { m_enabled = enabled; }
+		bool is_enabled() const { return m_enabled; }
+
+		uint64_t get_time_us() const
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+		}
+
+		void add_event(const char* pName, const char* pCategory, uint64_t start_us, uint64_t end_us, int64_t arg, bool has_arg)
+		{
+			thread_buffer* pBuf = get_thread_buffer();
+
+			event e;
+			e.m_pName = pName;
+			e.m_pCategory = pCategory;
+			e.m_start_us = start_us;
+			e.m_duration_us = end_us - start_us;
+			e.m_arg = arg;
+			e.m_has_arg = has_arg;
+			pBuf->m_events.push_back(e);
+		}
+
+		// Names the calling thread in the trace viewer.
+		void set_thread_name(const std::string& name)
+		{
+			if (!m_enabled)
+				return;
+
+			thread_buffer* pBuf = get_thread_buffer();
+			std::lock_guard<std::mutex> lock(m_mutex);
+			pBuf->m_name = name;
+		}
+
+		// Discards all recorded events. No traced code may be running.
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (size_t i = 0; i < m_buffers.size(); i++)
+				m_buffers[i]->m_events.clear();
+		}
+
+		// Writes all recorded events to a Chrome trace JSON file. No traced code may be running.
+		bool write_json(const char* pFilename)
+		{
+			FILE* pFile = fopen(pFilename, "w");
+			if (!pFile)
+				return false;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			fprintf(pFile, "{\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [\n");
+
+			bool first = true;
+			for (size_t i = 0; i < m_buffers.size(); i++)
+			{
+				const thread_buffer& buf = *m_buffers[i];
+
+				if (buf.m_name.size())
+				{
+					fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", buf.m_tid, buf.m_name.c_str());
+					first = false;
+				}
+
+				for (size_t j = 0; j < buf.m_events.size(); j++)
+				{
+					const event& e = buf.m_events[j];
+
+					fprintf(pFile, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu,\"dur\":%llu",
+						first ? "" : ",\n", e.m_pName, e.m_pCategory, buf.m_tid, (unsigned long long)e.m_start_us, (unsigned long long)e.m_duration_us);
+
+					if (e.m_has_arg)
+						fprintf(pFile, ",\"args\":{\"index\":%lld}", (long long)e.m_arg);
+
+					fprintf(pFile, "}");
+					first = false;
+				}
+			}
+
+			fprintf(pFile, "\n]\n}\n");
+
+			return fclose(pFile) != EOF;
+		}
+
+	private:
+		struct thread_buffer
+		{
+			uint32_t m_tid;
+			std::string m_name;
+			std::vector<event> m_events;
+		};
+
+		std::atomic<bool> m_enabled;
+		std::chrono::steady_clock::time_point m_epoch;
+
+		std::mutex m_mutex;
+		std::vector<std::unique_ptr<thread_buffer> > m_buffers;
+
+		trace_recorder() :
+			m_enabled(false),
+			m_epoch(std::chrono::steady_clock::now())
+		{
+		}
+
+		// Buffers are owned by the recorder (not the thread), so events from threads which have exited are still written out.
+		thread_buffer* get_thread_buffer()
+		{
+			static thread_local thread_buffer* s_pBuffer = nullptr;
+			if (!s_pBuffer)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				m_buffers.emplace_back(new thread_buffer);
+				s_pBuffer = m_buffers.back().get();
+				s_pBuffer->m_tid = (uint32_t)m_buffers.size();
+			}
+			return s_pBuffer;
+		}
+	};
+
+	class scoped_trace_event
+	{
+		scoped_trace_event(const scoped_trace_event&) = delete;
+		scoped_trace_event& operator= (const scoped_trace_event&) = delete;
+
+	public:
+		scoped_trace_event(const char* pName, const char* pCategory, int64_t arg = 0, bool has_arg = false) :
+			m_pName(pName),
+			m_pCategory(pCategory),
+			m_start_us(0),
+			m_arg(arg),
+			m_has_arg(has_arg),
+			m_active(trace_recorder::get().is_enabled())
+		{
+			if (m_active)
+				m_start_us = trace_recorder::get().get_time_us();
+		}
+
+		~scoped_trace_event()
+		{
+			if (m_active)
+			{
+				trace_recorder& r = trace_recorder::get();
+				r.add_event(m_pName, m_pCategory, m_start_us, r.get_time_us(), m_arg, m_has_arg);
+			}
+		}
+
+	private:
+		const char* m_pName;
+		const char* m_pCategory;
+		uint64_t m_start_us;
+		int64_t m_arg;
+		bool m_has_arg;
+		bool m_active;
+	};
+
+} // namespace basisu
+
+#define BASISU_TRACE_CONCAT2(a, b) a##b
+#define BASISU_TRACE_CONCAT(a, b) BASISU_TRACE_CONCAT2(a, b)
+
+// Records an event spanning the rest of the enclosing scope.
+#define BASISU_TRACE_SCOPE(name, category) basisu::scoped_trace_event BASISU_TRACE_CONCAT(basisu_trace_scope_, __LINE__)(name, category)
+// Same, with an integer argument (a slice or block index, etc.) shown in the trace viewer.
+#define BASISU_TRACE_SCOPE_ARG(name, category, arg) basisu::scoped_trace_event BASISU_TRACE_CONCAT(basisu_trace_scope_, __LINE__)(name, category, (int64_t)(arg), true)
+#define BASISU_TRACE_SET_THREAD_NAME(name) basisu::trace_recorder::get().set_thread_name(name)
+
+#else
+
+#define BASISU_TRACE_SCOPE(name, category)
+#define BASISU_TRACE_SCOPE_ARG(name, category, arg)
+#define BASISU_TRACE_SET_THREAD_NAME(name)
+
+#endif // BASISU_ENABLE_TRACING
@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include "basisu_transcoder.h"
+#include "basisu_trace.h"
 #include <limits.h>
 #include "basisu_containers_impl.h"
 
@@ -7909,6 +7910,8 @@ namespace basist
 		uint32_t output_block_or_pixel_stride_in_bytes, bool bc1_allow_threecolor_blocks, const bool is_video, const bool is_alpha_slice, const uint32_t level_index, const uint32_t orig_width, const uint32_t orig_height, uint32_t output_row_pitch_in_blocks_or_pixels,
 		basisu_transcoder_state* pState, bool transcode_alpha, void *pAlpha_blocks, uint32_t output_rows_in_pixels)
 	{
+		BASISU_TRACE_SCOPE("basisu_lowlevel_etc1s_transcoder::transcode_slice", "transcoder");
+
 		// 'pDst_blocks' unused when disabling *all* hardware transcode options
 		// (and 'bc1_allow_threecolor_blocks' when disabling DXT)
 		BASISU_NOTE_UNUSED(pDst_blocks);
@@ -8204,6 +8207,9 @@ namespace basist
 				if (is_video)
 					(*pPrev_frame_indices)[block_x + block_y * num_blocks_x] = endpoint_index | (selector_index << 16);
 
+				if (fmt == block_format::cNoOutput)
+					continue;
+
 #if BASISD_ENABLE_DEBUG_FLAGS
 				if ((g_debug_flags & cDebugFlagVisCRs) && ((fmt == block_format::cETC1) || (fmt == block_format::cBC1)))
 				{
@@ -9369,6 +9375,44 @@ namespace basist
 
 		return status;
 	}
+
+	bool basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices(
+		const uint8_t* pCompressed_data, uint32_t compressed_data_length,
+		uint32_t num_blocks_x, uint32_t num_blocks_y, uint32_t orig_width, uint32_t orig_height, uint32_t level_index,
+		uint32_t rgb_offset, uint32_t rgb_length, uint32_t alpha_offset, uint32_t alpha_length,
+		basisu_transcoder_state* pState)
+	{
+		BASISU_TRACE_SCOPE_ARG("basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices", "transcoder", level_index);
+
+		if (((uint64_t)rgb_offset + rgb_length) > (uint64_t)compressed_data_length)
+		{
+			BASISU_DEVEL_ERROR("basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices: source data buffer too small (color)\n");
+			return false;
+		}
+
+		if ((alpha_length) && (((uint64_t)alpha_offset + alpha_length) > (uint64_t)compressed_data_length))
+		{
+			BASISU_DEVEL_ERROR("basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices: source data buffer too small (alpha)\n");
+			return false;
+		}
+
+		if (!transcode_slice(nullptr, num_blocks_x, num_blocks_y, pCompressed_data + rgb_offset, rgb_length, block_format::cNoOutput, 0, false, true, false, level_index, orig_width, orig_height, num_blocks_x, pState, false, nullptr, 0))
+		{
+			BASISU_DEVEL_ERROR("basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices: transcode_slice() failed (color)\n");
+			return false;
+		}
+
+		if (alpha_length)
+		{
+			if (!transcode_slice(nullptr, num_blocks_x, num_blocks_y, pCompressed_data + alpha_offset, alpha_length, block_format::cNoOutput, 0, false, true, true, level_index, orig_width, orig_height, num_blocks_x, pState, false, nullptr, 0))
+			{
+				BASISU_DEVEL_ERROR("basisu_lowlevel_etc1s_transcoder::decode_video_frame_indices: transcode_slice() failed (alpha)\n");
+				return false;
+			}
+		}
+
+		return true;
+	}
 	
 	basisu_lowlevel_uastc_transcoder::basisu_lowlevel_uastc_transcoder()
 	{
@@ -9378,6 +9422,8 @@ namespace basist
         uint32_t output_block_or_pixel_stride_in_bytes, bool bc1_allow_threecolor_blocks, bool has_alpha, const uint32_t orig_width, const uint32_t orig_height, uint32_t output_row_pitch_in_blocks_or_pixels,
 		basisu_transcoder_state* pState, uint32_t output_rows_in_pixels, int channel0, int channel1, uint32_t decode_flags)
 	{
+		BASISU_TRACE_SCOPE("basisu_lowlevel_uastc_transcoder::transcode_slice", "transcoder");
+
 		BASISU_NOTE_UNUSED(pState);
 		BASISU_NOTE_UNUSED(bc1_allow_threecolor_blocks);
 
@@ -10536,6 +10582,8 @@ namespace basist
 	bool basisu_transcoder::transcode_slice(const void* pData, uint32_t data_size, uint32_t slice_index, void* pOutput_blocks, uint32_t output_blocks_buf_size_in_blocks_or_pixels, block_format fmt,
 		uint32_t output_block_or_pixel_stride_in_bytes, uint32_t decode_flags, uint32_t output_row_pitch_in_blocks_or_pixels, basisu_transcoder_state* pState, void *pAlpha_blocks, uint32_t output_rows_in_pixels, int channel0, int channel1) const
 	{
+		BASISU_TRACE_SCOPE_ARG("basisu_transcoder::transcode_slice", "transcoder", slice_index);
+
 		if (!m_ready_to_transcode)
 		{
 			BASISU_DEVEL_ERROR("basisu_transcoder::transcode_slice: must call start_transcoding first\n");
@@ -10669,6 +10717,121 @@ namespace basist
 		return -1;
 	}
 
+	int basisu_transcoder::find_video_iframe(const void* pData, uint32_t data_size, uint32_t image_index) const
+	{
+		if (!validate_header_quick(pData, data_size))
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::find_video_iframe: header validation failed\n");
+			return -1;
+		}
+
+		const basis_file_header* pHeader = reinterpret_cast<const basis_file_header*>(pData);
+		const uint8_t* pDataU8 = static_cast<const uint8_t*>(pData);
+		const basis_slice_desc* pSlice_descs = reinterpret_cast<const basis_slice_desc*>(pDataU8 + pHeader->m_slice_desc_file_ofs);
+
+		if (image_index >= pHeader->m_total_images)
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::find_video_iframe: image_index >= pHeader->m_total_images\n");
+			return -1;
+		}
+
+		// Only ETC1S P-Frames reference the previous frame.
+		if ((pHeader->m_tex_type != cBASISTexTypeVideoFrames) || (pHeader->m_tex_format != (int)basis_tex_format::cETC1S))
+			return image_index;
+
+		int iframe_index = -1;
+		for (uint32_t slice_iter = 0; slice_iter < pHeader->m_total_slices; slice_iter++)
+		{
+			const basis_slice_desc& slice_desc = pSlice_descs[slice_iter];
+			if ((slice_desc.m_level_index == 0) && (slice_desc.m_image_index <= image_index) && ((slice_desc.m_flags & cSliceDescFlagsFrameIsIFrame) != 0))
+				iframe_index = basisu::maximum<int>(iframe_index, slice_desc.m_image_index);
+		}
+
+		if (iframe_index < 0)
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::find_video_iframe: didn't find an I-Frame\n");
+		}
+
+		return iframe_index;
+	}
+
+	bool basisu_transcoder::seek_video_frame(const void* pData, uint32_t data_size, uint32_t image_index, uint32_t level_index, basisu_transcoder_state* pState) const
+	{
+		BASISU_TRACE_SCOPE_ARG("basisu_transcoder::seek_video_frame", "transcoder", image_index);
+
+		if (!m_ready_to_transcode)
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: must call start_transcoding() first\n");
+			return false;
+		}
+
+		const int iframe_index = find_video_iframe(pData, data_size, image_index);
+		if (iframe_index < 0)
+			return false;
+
+		const basis_file_header* pHeader = reinterpret_cast<const basis_file_header*>(pData);
+		const uint8_t* pDataU8 = static_cast<const uint8_t*>(pData);
+		const basis_slice_desc* pSlice_descs = reinterpret_cast<const basis_slice_desc*>(pDataU8 + pHeader->m_slice_desc_file_ofs);
+
+		if ((pHeader->m_tex_type != cBASISTexTypeVideoFrames) || (pHeader->m_tex_format != (int)basis_tex_format::cETC1S))
+			return true;
+
+		if (level_index >= basisu_transcoder_state::cMaxPrevFrameLevels)
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: unsupported level_index\n");
+			return false;
+		}
+		
+		const bool basis_file_has_alpha_slices = (pHeader->m_flags & cBASISHeaderFlagHasAlphaSlices) != 0;
+
+		// Slices are stored in image order, with each alpha slice immediately following its color slice, so one pass decodes the frames in order.
+		uint32_t next_frame_index = iframe_index;
+		for (uint32_t slice_iter = 0; (slice_iter < pHeader->m_total_slices) && (next_frame_index < image_index); slice_iter++)
+		{
+			const basis_slice_desc& slice_desc = pSlice_descs[slice_iter];
+			if ((slice_desc.m_level_index != level_index) || (slice_desc.m_image_index < next_frame_index) || (slice_desc.m_flags & cSliceDescFlagsHasAlpha))
+				continue;
+
+			if (slice_desc.m_image_index != next_frame_index)
+			{
+				BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: missing or out of order frame slice\n");
+				return false;
+			}
+
+			const basis_slice_desc* pAlpha_slice_desc = nullptr;
+			if (basis_file_has_alpha_slices)
+			{
+				if (((slice_iter + 1U) >= pHeader->m_total_slices) || ((pSlice_descs[slice_iter + 1].m_flags & cSliceDescFlagsHasAlpha) == 0))
+				{
+					BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: alpha basis file has missing alpha slice\n");
+					return false;
+				}
+
+				pAlpha_slice_desc = &pSlice_descs[slice_iter + 1];
+			}
+
+			if (!m_lowlevel_etc1s_decoder.decode_video_frame_indices(pDataU8, data_size,
+				slice_desc.m_num_blocks_x, slice_desc.m_num_blocks_y, slice_desc.m_orig_width, slice_desc.m_orig_height, level_index,
+				slice_desc.m_file_ofs, slice_desc.m_file_size,
+				pAlpha_slice_desc ? (uint32_t)pAlpha_slice_desc->m_file_ofs : 0U, pAlpha_slice_desc ? (uint32_t)pAlpha_slice_desc->m_file_size : 0U,
+				pState))
+			{
+				BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: decode_video_frame_indices() failed\n");
+				return false;
+			}
+
+			next_frame_index++;
+		}
+
+		if (next_frame_index != image_index)
+		{
+			BASISU_DEVEL_ERROR("basisu_transcoder::seek_video_frame: didn't find all frame slices\n");
+			return false;
+		}
+
+		return true;
+	}
+
 	int basisu_transcoder::find_slice(const void* pData, uint32_t data_size, uint32_t image_index, uint32_t level_index, bool alpha_data) const
 	{
 		if (!validate_header_quick(pData, data_size))
@@ -10770,6 +10933,8 @@ namespace basist
 		transcoder_texture_format fmt,
 		uint32_t decode_flags, uint32_t output_row_pitch_in_blocks_or_pixels, basisu_transcoder_state *pState, uint32_t output_rows_in_pixels) const
 	{
+		BASISU_TRACE_SCOPE_ARG("basisu_transcoder::transcode_image_level", "transcoder", level_index);
+
 		const uint32_t bytes_per_block_or_pixel = basis_get_bytes_per_block_or_pixel(fmt);
 
 		if (!m_ready_to_transcode)
@@ -17169,6 +17334,95 @@ namespace basist
 
 		return true;
 	}
+
+	int ktx2_transcoder::find_video_iframe(uint32_t layer_index) const
+	{
+		if (layer_index >= basisu::maximum<uint32_t>(m_header.m_layer_count, 1))
+		{
+			BASISU_DEVEL_ERROR("ktx2_transcoder::find_video_iframe: layer_index >= maximum<uint32_t>(m_header.m_layer_count, 1)\n");
+			return -1;
+		}
+
+		if ((!m_is_video) || (m_format != basist::basis_tex_format::cETC1S))
+			return layer_index;
+
+		// Level 0's image descs come first, and a video has one face per layer.
+		for (int i = layer_index; i >= 0; i--)
+		{
+			if ((m_etc1s_image_descs[i * m_header.m_face_count].m_image_flags & KTX2_IMAGE_IS_P_FRAME) == 0)
+				return i;
+		}
+
+		BASISU_DEVEL_ERROR("ktx2_transcoder::find_video_iframe: didn't find an I-Frame\n");
+		return -1;
+	}
+
+	bool ktx2_transcoder::seek_video_frame(uint32_t layer_index, uint32_t level_index, ktx2_transcoder_state* pState)
+	{
+		BASISU_TRACE_SCOPE_ARG("ktx2_transcoder::seek_video_frame", "transcoder", layer_index);
+
+		if (!m_pData)
+		{
+			BASISU_DEVEL_ERROR("ktx2_transcoder::seek_video_frame: Must call init() first\n");
+			return false;
+		}
+
+		if (!pState)
+			pState = &m_def_transcoder_state;
+
+		if ((!m_is_video) || (m_format != basist::basis_tex_format::cETC1S))
+			return true;
+
+		if (m_etc1s_transcoder.get_endpoints().empty())
+		{
+			BASISU_DEVEL_ERROR("ktx2_transcoder::seek_video_frame: must call start_transcoding() first\n");
+			return false;
+		}
+
+		if (level_index >= m_levels.size())
+		{
+			BASISU_DEVEL_ERROR("ktx2_transcoder::seek_video_frame: level_index >= m_levels.size()\n");
+			return false;
+		}
+
+		const int iframe_index = find_video_iframe(layer_index);
+		if (iframe_index < 0)
+			return false;
+
+		const uint32_t level_width = basisu::maximum<uint32_t>(m_header.m_pixel_width >> level_index, 1);
+		const uint32_t level_height = basisu::maximum<uint32_t>(m_header.m_pixel_height >> level_index, 1);
+		const uint32_t num_blocks_x = (level_width + 3) >> 2;
+		const uint32_t num_blocks_y = (level_height + 3) >> 2;
+
+		for (uint32_t frame_index = iframe_index; frame_index < layer_index; frame_index++)
+		{
+			const uint32_t etc1s_image_index =
+				(level_index * basisu::maximum<uint32_t>(m_header.m_layer_count, 1) * m_header.m_face_count) +
+				frame_index * m_header.m_face_count;
+
+			if (etc1s_image_index >= m_etc1s_image_descs.size())
+			{
+				BASISU_DEVEL_ERROR("ktx2_transcoder::seek_video_frame: etc1s_image_index >= m_etc1s_image_descs.size()\n");
+				assert(0);
+				return false;
+			}
+
+			const ktx2_etc1s_image_desc& image_desc = m_etc1s_image_descs[etc1s_image_index];
+
+			if (!m_etc1s_transcoder.decode_video_frame_indices(m_pData, static_cast<uint32_t>(m_data_size),
+				num_blocks_x, num_blocks_y, level_width, level_height,
+				level_index,
+				m_levels[level_index].m_byte_offset + image_desc.m_rgb_slice_byte_offset, image_desc.m_rgb_slice_byte_length,
+				image_desc.m_alpha_slice_byte_length ? (m_levels[level_index].m_byte_offset + image_desc.m_alpha_slice_byte_offset) : 0, image_desc.m_alpha_slice_byte_length,
+				&pState->m_transcoder_state))
+			{
+				BASISU_DEVEL_ERROR("ktx2_transcoder::seek_video_frame: decode_video_frame_indices() failed, this is either a bug or the file is corrupted/invalid\n");
+				return false;
+			}
+		}
+
+		return true;
+	}
 		
 	bool ktx2_transcoder::transcode_image_level(
 		uint32_t level_index, uint32_t layer_index, uint32_t face_index, 
@@ -17177,6 +17431,8 @@ namespace basist
 		uint32_t decode_flags, uint32_t output_row_pitch_in_blocks_or_pixels, uint32_t output_rows_in_pixels, int channel0, int channel1,
 		ktx2_transcoder_state* pState)
 	{
+		BASISU_TRACE_SCOPE_ARG("ktx2_transcoder::transcode_image_level", "transcoder", level_index);
+
 		if (!m_pData)
 		{
 			BASISU_DEVEL_ERROR("ktx2_transcoder::transcode_image_2D: Must call init() first\n");
@@ -231,6 +231,15 @@ namespace basist
 			basisu_transcoder_state* pState = nullptr,
 			uint32_t output_rows_in_pixels = 0);
 
+		// Video P-Frame fast forwarding: decodes a frame's color (and alpha, if alpha_length != 0) slice only far enough to update the previous frame 
+		// block indices in pState, without writing any output blocks. Decoding frames this way from an I-Frame up to (but not including) frame N lets 
+		// transcode_image() decode frame N without transcoding all the frames before it.
+		bool decode_video_frame_indices(
+			const uint8_t* pCompressed_data, uint32_t compressed_data_length,
+			uint32_t num_blocks_x, uint32_t num_blocks_y, uint32_t orig_width, uint32_t orig_height, uint32_t level_index,
+			uint32_t rgb_offset, uint32_t rgb_length, uint32_t alpha_offset, uint32_t alpha_length,
+			basisu_transcoder_state* pState = nullptr);
+
 		void clear()
 		{
 			m_local_endpoints.clear();
@@ -501,6 +510,16 @@ namespace basist
 			transcoder_texture_format fmt,
 			uint32_t decode_flags = 0, uint32_t output_row_pitch_in_blocks_or_pixels = 0, basisu_transcoder_state* pState = nullptr, uint32_t output_rows_in_pixels = 0) const;
 
+		// Video seeking. ETC1S P-Frames reference the previous frame (through the previous frame's block indices in basisu_transcoder_state), so normally a 
+		// video must be transcoded from first to last frame. find_video_iframe() returns the index of the closest I-Frame at or before image_index (image_index 
+		// itself for non-video or UASTC files), or -1 on failure. Files written with basis_compressor_params::m_video_iframe_interval have periodic I-Frames.
+		int find_video_iframe(const void* pData, uint32_t data_size, uint32_t image_index) const;
+
+		// Prepares pState so transcode_image_level() can transcode frame image_index's mipmap level level_index next, without transcoding the frames before it.
+		// It fast forwards from the closest prior I-Frame through the P-Frames in between by only decoding their block indices, which is much cheaper than 
+		// transcoding them. Does nothing for non-video or UASTC files. Use the same pState (or nullptr for both) for seek_video_frame() and transcode_image_level().
+		bool seek_video_frame(const void* pData, uint32_t data_size, uint32_t image_index, uint32_t level_index, basisu_transcoder_state* pState = nullptr) const;
+
 		// Finds the basis slice corresponding to the specified image/level/alpha params, or -1 if the slice can't be found.
 		int find_slice(const void* pData, uint32_t data_size, uint32_t image_index, uint32_t level_index, bool alpha_data) const;
 
@@ -742,7 +761,8 @@ namespace basist
 		// true if the image has alpha data
 		bool m_alpha_flag;
 
-		// true if the image is an I-Frame. Currently, for ETC1S textures, the first frame will always be an I-Frame, and subsequent frames will always be P-Frames.
+		// true if the image is an I-Frame. For ETC1S textures, the first frame will always be an I-Frame. Subsequent frames will be P-Frames, unless the file was
+		// written with periodic I-Frames.
 		bool m_iframe_flag;
 	};
 		
@@ -871,8 +891,15 @@ namespace basist
 		uint32_t get_etc1s_image_descs_image_flags(uint32_t level_index, uint32_t layer_index, uint32_t face_index) const;
 
 		// is_video() is only valid after start_transcoding() is called.
-		// For ETC1S data, if this returns true you must currently transcode the file from first to last frame, in order, without skipping any frames.
+		// For ETC1S data, if this returns true you must transcode the file from first to last frame, in order, without skipping any frames, or use seek_video_frame().
 		bool is_video() const { return m_is_video; }
+
+		// Video seeking, see basisu_transcoder::find_video_iframe() and seek_video_frame(). Frames are KTX2 layers. Must have called start_transcoding() first.
+		// find_video_iframe() returns the layer index of the closest I-Frame at or before layer_index, or -1 on failure.
+		int find_video_iframe(uint32_t layer_index) const;
+
+		// Fast forwards pState from the closest I-Frame at or before layer_index, so transcode_image_level() can transcode layer_index's level_index next.
+		bool seek_video_frame(uint32_t layer_index, uint32_t level_index = 0, ktx2_transcoder_state* pState = nullptr);
 				
 		// start_transcoding() MUST be called before calling transcode_image().
 		// This method decompresses the ETC1S global endpoint/selector codebooks, which is not free, so try to avoid calling it excessively.
@@ -886,7 +913,7 @@ namespace basist
 		// Internally it uses the same low-level transcode API's as basisu_transcoder::transcode_image_level().
 		// If the file is UASTC and is supercompressed with Zstandard, and the file is a texture array or cubemap, it's highly recommended that each mipmap level is 
 		// completely transcoded before switching to another level. Every time the mipmap level is changed all supercompressed level data must be decompressed using Zstandard as a single unit.
-		// Currently ETC1S videos must always be transcoded from first to last frame (or KTX2 "layer"), in order, with no skipping of frames.
+		// ETC1S videos must always be transcoded from first to last frame (or KTX2 "layer"), in order, with no skipping of frames, unless seek_video_frame() is called first.
 		// By default this method is not thread safe unless you specify a pointer to a user allocated thread-specific transcoder_state struct.
 		bool transcode_image_level(
 			uint32_t level_index, uint32_t layer_index, uint32_t face_index,
@@ -82,6 +82,8 @@ namespace basist
 		cRGBA4444_ALPHA,
 		cRGBA4444_COLOR_OPAQUE,
 		cRGBA4444,
+
+		cNoOutput,							// Used internally: Only decode the endpoint/selector indices to update the transcoder state (for video P-Frame fast forwarding), nothing is written to the output
 						
 		cTotalBlockFormats
 	};
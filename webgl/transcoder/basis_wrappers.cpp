@@ -427,6 +427,26 @@ struct basis_file
 		return m_transcoder.start_transcoding(m_file.data(), m_file.size());
 	}
 
+	// Returns the index of the closest I-Frame at or before image_index, or -1 on failure.
+	int findVideoIFrame(uint32_t image_index)
+	{
+		assert(m_magic == BASIS_MAGIC);
+		if (m_magic != BASIS_MAGIC)
+			return -1;
+
+		return m_transcoder.find_video_iframe(m_file.data(), m_file.size(), image_index);
+	}
+
+	// Prepares the transcoder so transcodeImage() can transcode video frame image_index next, without transcoding the frames before it.
+	uint32_t seekVideoFrame(uint32_t image_index, uint32_t level_index)
+	{
+		assert(m_magic == BASIS_MAGIC);
+		if (m_magic != BASIS_MAGIC)
+			return 0;
+
+		return m_transcoder.seek_video_frame(m_file.data(), m_file.size(), image_index, level_index);
+	}
+
 	uint32_t transcodeImage(const emscripten::val& dst, uint32_t image_index, uint32_t level_index, uint32_t format, uint32_t unused, uint32_t get_alpha_for_opaque_formats) 
 	{
 		(void)unused;
@@ -827,6 +847,26 @@ struct ktx2_file
 		return m_transcoder.is_video();
 	}
 
+	// Returns the layer index of the closest I-Frame at or before layer_index, or -1 on failure. startTranscoding() must be called first.
+	int findVideoIFrame(uint32_t layer_index)
+	{
+		assert(m_magic == KTX2_MAGIC);
+		if (m_magic != KTX2_MAGIC)
+			return -1;
+
+		return m_transcoder.find_video_iframe(layer_index);
+	}
+
+	// Prepares the transcoder so transcodeImage() can transcode video frame (layer) layer_index next, without transcoding the frames before it.
+	uint32_t seekVideoFrame(uint32_t layer_index, uint32_t level_index)
+	{
+		assert(m_magic == KTX2_MAGIC);
+		if (m_magic != KTX2_MAGIC)
+			return 0;
+
+		return m_transcoder.seek_video_frame(layer_index, level_index);
+	}
+
 	// startTranscoding() must be called before calling getETC1SImageDescImageFlags().
 	uint32_t getETC1SImageDescImageFlags(uint32_t level_index, uint32_t layer_index, uint32_t face_index)
 	{
@@ -1505,6 +1545,13 @@ EMSCRIPTEN_BINDINGS(basis_codec) {
 	// format is enum class transcoder_texture_format
     .function("transcodeImage", optional_override([](basis_file& self, const emscripten::val& dst, uint32_t imageIndex, uint32_t levelIndex, uint32_t format, uint32_t unused, uint32_t getAlphaForOpaqueFormats) {
       return self.transcodeImage(dst, imageIndex, levelIndex, format, unused, getAlphaForOpaqueFormats);
+    }))
+	// Video seeking (ETC1S video files with periodic I-Frames)
+    .function("findVideoIFrame", optional_override([](basis_file& self, uint32_t imageIndex) {
+      return self.findVideoIFrame(imageIndex);
+    }))
+    .function("seekVideoFrame", optional_override([](basis_file& self, uint32_t imageIndex, uint32_t levelIndex) {
+      return self.seekVideoFrame(imageIndex, levelIndex);
     }))
 	// Returns low-level information about the basis file.
 	.function("getFileDesc", optional_override([](basis_file& self) {
@@ -1657,6 +1704,8 @@ EMSCRIPTEN_BINDINGS(basis_codec) {
 		.function("getDFDChannelID0", &ktx2_file::getDFDChannelID0)
 		.function("getDFDChannelID1", &ktx2_file::getDFDChannelID1)
 		.function("isVideo", &ktx2_file::isVideo)
+		.function("findVideoIFrame", &ktx2_file::findVideoIFrame)
+		.function("seekVideoFrame", &ktx2_file::seekVideoFrame)
 		.function("getETC1SImageDescImageFlags", &ktx2_file::getETC1SImageDescImageFlags)
 		.function("getImageLevelInfo", &ktx2_file::getImageLevelInfo)
 		.function("getImageTranscodedSizeInBytes", &ktx2_file::getImageTranscodedSizeInBytes)
@@ -1895,6 +1944,11 @@ EMSCRIPTEN_BINDINGS(basis_codec) {
 		self.m_params.m_tex_type = (basist::basis_texture_type)tex_type;
 	}))
 	
+	// Video only: codes every video_iframe_interval'th frame as an I-Frame, so transcoders can seek. 0 (the default) means only the first frame.
+	.function("setVideoIFrameInterval", optional_override([](basis_encoder& self, uint32_t video_iframe_interval) {
+		self.m_params.m_video_iframe_interval = video_iframe_interval;
+	}))
+
 	.function("setUserData0", optional_override([](basis_encoder& self, uint32_t userdata0) {
 		self.m_params.m_userdata0 = userdata0;
 	}))